@@ -0,0 +1,293 @@
+/**
+ * vector_benchmark.cpp
+ *
+ * Compares cesa::vector against std::vector (with reserve), std::array and, when available,
+ * boost::container::static_vector for a trivial (int) and a non-trivial (std::string) element type
+ * at several capacities.
+ *
+ * std::array has a fixed size, so it only takes part in the benchmarks that do not change the
+ * number of elements, and "emplace_back" is emulated by assigning to successive indices.
+ */
+
+#include <cesa/vector.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if CESA_BENCH_HAVE_BOOST
+#    include <boost/container/static_vector.hpp>
+#endif
+
+namespace
+{
+    struct cesa_vector
+    {
+        template <typename T, std::size_t N>
+        using type = cesa::vector<T, N>;
+    };
+
+    struct std_vector
+    {
+        template <typename T, std::size_t N>
+        using type = std::vector<T>;
+    };
+
+    struct std_array
+    {
+        template <typename T, std::size_t N>
+        using type = std::array<T, N>;
+    };
+
+#if CESA_BENCH_HAVE_BOOST
+    struct boost_static_vector
+    {
+        template <typename T, std::size_t N>
+        using type = boost::container::static_vector<T, N>;
+    };
+#endif
+
+    template <typename Family, typename T, std::size_t N>
+    using container_t = typename Family::template type<T, N>;
+
+    template <typename Family>
+    constexpr bool is_fixed_size_v = std::is_same_v<Family, std_array>;
+
+    template <typename T>
+    T
+    make_value(const std::size_t i)
+    {
+        if constexpr (std::is_same_v<T, std::string>)
+        {
+            // Long enough to defeat the small string optimization
+            return "benchmark-element-" + std::to_string(i);
+        }
+        else
+        {
+            return static_cast<T>(i);
+        }
+    }
+
+    template <typename T>
+    std::vector<T>
+    make_values(const std::size_t count)
+    {
+        std::vector<T> values;
+        values.reserve(count);
+        for (std::size_t i{}; i < count; ++i)
+        {
+            values.push_back(make_value<T>(i));
+        }
+        std::mt19937 generator{ 42 };
+        std::shuffle(values.begin(), values.end(), generator);
+        return values;
+    }
+
+    template <typename Family, typename T, std::size_t N>
+    container_t<Family, T, N>
+    make_empty()
+    {
+        container_t<Family, T, N> container;
+        if constexpr (std::is_same_v<Family, std_vector>)
+        {
+            container.reserve(N);
+        }
+        return container;
+    }
+
+    template <typename Family, typename T, std::size_t N>
+    container_t<Family, T, N>
+    make_filled(const std::vector<T> &values, const std::size_t count = N)
+    {
+        auto container = make_empty<Family, T, N>();
+        for (std::size_t i{}; i < count; ++i)
+        {
+            if constexpr (is_fixed_size_v<Family>)
+            {
+                container[i] = values[i];
+            }
+            else
+            {
+                container.push_back(values[i]);
+            }
+        }
+        return container;
+    }
+
+    std::size_t
+    weight(const int value)
+    {
+        return static_cast<std::size_t>(value);
+    }
+
+    std::size_t
+    weight(const std::string &value)
+    {
+        return value.size();
+    }
+
+    template <typename Family, typename T, std::size_t N>
+    void
+    BM_emplace_back(benchmark::State &state)
+    {
+        const auto values = make_values<T>(N);
+        for (auto _ : state)
+        {
+            auto container = make_empty<Family, T, N>();
+            for (std::size_t i{}; i < N; ++i)
+            {
+                if constexpr (is_fixed_size_v<Family>)
+                {
+                    container[i] = values[i];
+                }
+                else
+                {
+                    container.emplace_back(values[i]);
+                }
+            }
+            benchmark::DoNotOptimize(container.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * N));
+    }
+
+    template <typename Family, typename T, std::size_t N>
+    void
+    BM_insert_erase_middle(benchmark::State &state)
+    {
+        const auto values    = make_values<T>(N);
+        auto       container = make_filled<Family, T, N>(values, N / 2);
+        for (auto _ : state)
+        {
+            auto it = container.insert(container.begin() + static_cast<std::ptrdiff_t>(container.size() / 2),
+                                       values.front());
+            container.erase(it);
+            benchmark::DoNotOptimize(container.data());
+            benchmark::ClobberMemory();
+        }
+    }
+
+    template <typename Family, typename T, std::size_t N>
+    void
+    BM_copy_construct(benchmark::State &state)
+    {
+        const auto source = make_filled<Family, T, N>(make_values<T>(N));
+        for (auto _ : state)
+        {
+            container_t<Family, T, N> copy(source);
+            benchmark::DoNotOptimize(copy.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * N));
+    }
+
+    // Each iteration moves the container out and back again, so two moves are measured
+    template <typename Family, typename T, std::size_t N>
+    void
+    BM_move_construct(benchmark::State &state)
+    {
+        auto source = make_filled<Family, T, N>(make_values<T>(N));
+        for (auto _ : state)
+        {
+            container_t<Family, T, N> moved(std::move(source));
+            benchmark::DoNotOptimize(moved.data());
+            source = std::move(moved);
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * N));
+    }
+
+    template <typename Family, typename T, std::size_t N>
+    void
+    BM_iterate(benchmark::State &state)
+    {
+        const auto container = make_filled<Family, T, N>(make_values<T>(N));
+        for (auto _ : state)
+        {
+            std::size_t sum{};
+            for (const auto &element : container)
+            {
+                sum += weight(element);
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * N));
+    }
+
+    // Each iteration restores the unsorted input by copy assignment, which is included in the timing
+    template <typename Family, typename T, std::size_t N>
+    void
+    BM_sort(benchmark::State &state)
+    {
+        const auto source    = make_filled<Family, T, N>(make_values<T>(N));
+        auto       container = source;
+        for (auto _ : state)
+        {
+            container = source;
+            std::sort(container.begin(), container.end());
+            benchmark::DoNotOptimize(container.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * N));
+    }
+
+    // Searches for the last element, so every element is compared
+    template <typename Family, typename T, std::size_t N>
+    void
+    BM_find(benchmark::State &state)
+    {
+        const auto container = make_filled<Family, T, N>(make_values<T>(N));
+        const T    target    = container.back();
+        for (auto _ : state)
+        {
+            auto it = std::find(container.begin(), container.end(), target);
+            benchmark::DoNotOptimize(it);
+        }
+        state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * N));
+    }
+}
+
+#define CESA_BENCH_CAPACITIES(bench, family, type)  \
+    BENCHMARK_TEMPLATE(bench, family, type, 8);     \
+    BENCHMARK_TEMPLATE(bench, family, type, 64);    \
+    BENCHMARK_TEMPLATE(bench, family, type, 1024);  \
+    BENCHMARK_TEMPLATE(bench, family, type, 16384)
+
+#if CESA_BENCH_HAVE_BOOST
+#    define CESA_BENCH_BOOST(bench, type) CESA_BENCH_CAPACITIES(bench, boost_static_vector, type)
+#else
+#    define CESA_BENCH_BOOST(bench, type) static_assert(true)
+#endif
+
+#define CESA_BENCH_RESIZABLE(bench, type)               \
+    CESA_BENCH_CAPACITIES(bench, cesa_vector, type);    \
+    CESA_BENCH_CAPACITIES(bench, std_vector, type);     \
+    CESA_BENCH_BOOST(bench, type)
+
+#define CESA_BENCH_ALL(bench, type)                 \
+    CESA_BENCH_RESIZABLE(bench, type);              \
+    CESA_BENCH_CAPACITIES(bench, std_array, type)
+
+CESA_BENCH_ALL(BM_emplace_back, int);
+CESA_BENCH_ALL(BM_emplace_back, std::string);
+CESA_BENCH_RESIZABLE(BM_insert_erase_middle, int);
+CESA_BENCH_RESIZABLE(BM_insert_erase_middle, std::string);
+CESA_BENCH_ALL(BM_copy_construct, int);
+CESA_BENCH_ALL(BM_copy_construct, std::string);
+CESA_BENCH_ALL(BM_move_construct, int);
+CESA_BENCH_ALL(BM_move_construct, std::string);
+CESA_BENCH_ALL(BM_iterate, int);
+CESA_BENCH_ALL(BM_iterate, std::string);
+CESA_BENCH_ALL(BM_sort, int);
+CESA_BENCH_ALL(BM_sort, std::string);
+CESA_BENCH_ALL(BM_find, int);
+CESA_BENCH_ALL(BM_find, std::string);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,863 @@
+#ifndef CESA_ALGORITHMS_HPP
+#define CESA_ALGORITHMS_HPP
+
+/**
+ * algorithms.hpp
+ *
+ * Parallel and vectorized algorithms operating directly on cesa::vector.
+ *
+ * Every algorithm in cesa::algorithms takes an execution policy and a cesa::vector, and picks the
+ * chunking itself:
+ *  - seq and unseq run on the calling thread,
+ *  - par and par_unseq split vectors of at least CESA_PARALLEL_THRESHOLD elements into chunks and
+ *    run them on a process-wide pool of CESA_PARALLEL_THREADS - 1 worker threads, with the
+ *    calling thread taking part. CESA_PARALLEL_THREADS defaults to 0, meaning
+ *    std::thread::hardware_concurrency(). Chunks are handed out one at a time, so threads that
+ *    finish early pick up the remaining work.
+ *
+ * Chunks start at multiples of the vector's alignment, so the kernels may assume the alignment of
+ * the storage for every chunk. reduce() with std::plus and min_element() / max_element() with
+ * std::less use multi-lane kernels the compiler turns into SIMD code for the element types the
+ * cesa SIMD kernels support; the other algorithms and element types run the standard algorithms
+ * on each chunk.
+ *
+ * As with the standard parallel algorithms, the functions passed to a parallel policy must be safe
+ * to call concurrently, reduce() and the scans may regroup their operation, which must therefore
+ * be associative, and an exception escaping a function called by a parallel policy terminates
+ * the program.
+ *
+ * The policy objects are cesa::algorithms::seq, unseq, par and par_unseq. Defining
+ * CESA_STD_EXECUTION to 1 additionally accepts the std::execution policies. It is off by default
+ * because <execution> makes standard libraries built on TBB require linking against it.
+ */
+
+#include "config.hpp"
+#include "simd.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifndef CESA_PARALLEL_THRESHOLD
+#    define CESA_PARALLEL_THRESHOLD 32768
+#endif
+
+#ifndef CESA_PARALLEL_THREADS
+#    define CESA_PARALLEL_THREADS 0
+#endif
+
+#ifndef CESA_STD_EXECUTION
+#    define CESA_STD_EXECUTION 0
+#endif
+
+#if CESA_STD_EXECUTION
+#    include <execution>
+#endif
+
+namespace cesa::algorithms
+{
+    struct sequenced_policy
+    {
+    };
+
+    struct unsequenced_policy
+    {
+    };
+
+    struct parallel_policy
+    {
+    };
+
+    struct parallel_unsequenced_policy
+    {
+    };
+
+    inline constexpr sequenced_policy            seq{};
+    inline constexpr unsequenced_policy          unseq{};
+    inline constexpr parallel_policy             par{};
+    inline constexpr parallel_unsequenced_policy par_unseq{};
+
+    /**
+     * Whether ExecutionPolicy is accepted by the algorithms in this header.
+     */
+    template <class ExecutionPolicy>
+    struct is_execution_policy : std::false_type
+    {
+    };
+
+    template <>
+    struct is_execution_policy<sequenced_policy> : std::true_type
+    {
+    };
+
+    template <>
+    struct is_execution_policy<unsequenced_policy> : std::true_type
+    {
+    };
+
+    template <>
+    struct is_execution_policy<parallel_policy> : std::true_type
+    {
+    };
+
+    template <>
+    struct is_execution_policy<parallel_unsequenced_policy> : std::true_type
+    {
+    };
+
+#if CESA_STD_EXECUTION
+    template <>
+    struct is_execution_policy<std::execution::sequenced_policy> : std::true_type
+    {
+    };
+
+    template <>
+    struct is_execution_policy<std::execution::unsequenced_policy> : std::true_type
+    {
+    };
+
+    template <>
+    struct is_execution_policy<std::execution::parallel_policy> : std::true_type
+    {
+    };
+
+    template <>
+    struct is_execution_policy<std::execution::parallel_unsequenced_policy> : std::true_type
+    {
+    };
+#endif
+
+    template <class ExecutionPolicy>
+    inline constexpr bool is_execution_policy_v = is_execution_policy<std::remove_cvref_t<ExecutionPolicy>>::value;
+
+    namespace detail
+    {
+        template <class ExecutionPolicy>
+        inline constexpr bool is_parallel_policy_v =
+            std::is_same_v<std::remove_cvref_t<ExecutionPolicy>, parallel_policy> ||
+            std::is_same_v<std::remove_cvref_t<ExecutionPolicy>, parallel_unsequenced_policy>
+#if CESA_STD_EXECUTION
+            || std::is_same_v<std::remove_cvref_t<ExecutionPolicy>, std::execution::parallel_policy> ||
+            std::is_same_v<std::remove_cvref_t<ExecutionPolicy>, std::execution::parallel_unsequenced_policy>
+#endif
+            ;
+
+        /**
+         * The maximum number of chunks an algorithm is split into, which bounds the per-chunk
+         * results an algorithm keeps, so that they fit in a chunk_results on the stack.
+         */
+        inline constexpr std::size_t max_parallel_chunks = 256;
+
+        /**
+         * The per-chunk results of a parallel algorithm, one value-initialized T per chunk.
+         */
+        template <typename T>
+        using chunk_results = vector<T, max_parallel_chunks>;
+
+        /**
+         * The pool running the chunks of parallel algorithms. The workers are started on first
+         * use and joined when the program exits. A call to run() made while the pool is busy,
+         * such as from inside a chunk, runs its tasks on the calling thread instead of waiting.
+         */
+        class thread_pool
+        {
+        public:
+            [[nodiscard]] static thread_pool &instance();
+
+            thread_pool(const thread_pool &) = delete;
+
+            thread_pool &operator=(const thread_pool &) = delete;
+
+            ~thread_pool();
+
+            /**
+             * The number of threads taking part in run(), the calling thread included.
+             */
+            [[nodiscard]] std::size_t concurrency() const noexcept;
+
+            /**
+             * Calls task(i) for every i in [0, task_count), spread over the pool, and returns once
+             * all calls have returned.
+             */
+            template <class F>
+            void run(std::size_t task_count, F &&task);
+
+        private:
+            using task_function = void (*)(void *context, std::size_t index);
+
+            thread_pool();
+
+            void work();
+
+            void drain(task_function function, void *context, std::size_t task_count) noexcept;
+
+            std::mutex               submit_mutex_;
+            std::mutex               mutex_;
+            std::condition_variable  wake_;
+            std::condition_variable  done_;
+            std::vector<std::thread> workers_;
+            task_function            function_{};
+            void                    *context_{};
+            std::size_t              task_count_{};
+            std::atomic<std::size_t> next_task_{};
+            std::size_t              active_workers_{};
+            std::size_t              generation_{};
+            bool                     stopping_{};
+        };
+
+        /**
+         * The boundaries of count elements split into chunk_count chunks. Every boundary but the
+         * last is a multiple of granule.
+         */
+        [[nodiscard]] constexpr std::size_t
+        chunk_boundary(const std::size_t count, const std::size_t chunk_count, const std::size_t chunk,
+                       const std::size_t granule) noexcept
+        {
+            if (chunk == chunk_count)
+            {
+                return count;
+            }
+            return count / chunk_count * chunk / granule * granule;
+        }
+
+        /**
+         * The number of chunks a parallel algorithm over count elements is split into under
+         * ExecutionPolicy: one below CESA_PARALLEL_THRESHOLD and for non-parallel policies,
+         * otherwise up to four per thread, each at least granule elements long.
+         */
+        template <class ExecutionPolicy>
+        [[nodiscard]] std::size_t
+        chunk_count(const std::size_t count, const std::size_t granule)
+        {
+            if constexpr (is_parallel_policy_v<ExecutionPolicy>)
+            {
+                if (count >= CESA_PARALLEL_THRESHOLD && count >= 2 * granule)
+                {
+                    const std::size_t concurrency = thread_pool::instance().concurrency();
+                    return std::min({ concurrency == 1 ? std::size_t{1} : 4 * concurrency, max_parallel_chunks,
+                                      count / granule });
+                }
+            }
+            return 1;
+        }
+
+        /**
+         * The chunk granule for elements of type T stored with the given alignment: a multiple of
+         * 64 elements that keeps every chunk start aligned.
+         */
+        template <typename T, std::size_t alignment>
+        inline constexpr std::size_t chunk_granule = std::max<std::size_t>(64, alignment);
+
+        /**
+         * Calls f(chunk, begin, end) for each chunk of [0, count), in parallel if chunk_count > 1.
+         */
+        template <class F>
+        void
+        for_each_chunk(const std::size_t count, const std::size_t chunk_count, const std::size_t granule, F &&f)
+        {
+            if (chunk_count <= 1)
+            {
+                f(std::size_t{}, std::size_t{}, count);
+                return;
+            }
+            thread_pool::instance().run(chunk_count, [&](const std::size_t chunk) {
+                f(chunk, chunk_boundary(count, chunk_count, chunk, granule),
+                  chunk_boundary(count, chunk_count, chunk + 1, granule));
+            });
+        }
+
+        /**
+         * The number of independent accumulators the reduction kernels keep for elements of type
+         * T: two SIMD registers' worth, so that consecutive additions do not wait on each other.
+         */
+        template <typename T>
+        inline constexpr std::size_t reduction_lanes =
+#if defined(CESA_SIMD_AVX2) || defined(CESA_SIMD_SSE2) || defined(CESA_SIMD_NEON)
+            2 * cesa::detail::simd_register_bytes / sizeof(T);
+#else
+            4;
+#endif
+
+        template <class BinaryOp, typename T>
+        inline constexpr bool is_plus_v =
+            std::is_same_v<BinaryOp, std::plus<>> || std::is_same_v<BinaryOp, std::plus<T>>;
+
+        template <class Compare, typename T>
+        inline constexpr bool is_less_v =
+            std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<T>>;
+
+        /**
+         * The sum of the count elements at first, which is aligned to alignment.
+         */
+        template <std::size_t alignment, typename T>
+        [[nodiscard]] T
+        sum_elements(const T *first, const std::size_t count) noexcept
+        {
+            constexpr std::size_t lanes = reduction_lanes<T>;
+            first                       = std::assume_aligned<alignment>(first);
+            T           accumulators[lanes]{};
+            std::size_t i{};
+            for (; i + lanes <= count; i += lanes)
+            {
+                for (std::size_t lane{}; lane < lanes; ++lane)
+                {
+                    accumulators[lane] = static_cast<T>(accumulators[lane] + first[i + lane]);
+                }
+            }
+            T result{};
+            for (std::size_t lane{}; lane < lanes; ++lane)
+            {
+                result = static_cast<T>(result + accumulators[lane]);
+            }
+            for (; i < count; ++i)
+            {
+                result = static_cast<T>(result + first[i]);
+            }
+            return result;
+        }
+
+        /**
+         * The smallest, or with largest set the largest, of the count > 0 elements at first,
+         * which is aligned to alignment.
+         */
+        template <bool largest, std::size_t alignment, typename T>
+        [[nodiscard]] T
+        extreme_element(const T *first, const std::size_t count) noexcept
+        {
+            constexpr std::size_t lanes = reduction_lanes<T>;
+            first                       = std::assume_aligned<alignment>(first);
+            T           result = first[0];
+            std::size_t i{};
+            if (count >= lanes)
+            {
+                T accumulators[lanes];
+                for (std::size_t lane{}; lane < lanes; ++lane)
+                {
+                    accumulators[lane] = first[lane];
+                }
+                for (i = lanes; i + lanes <= count; i += lanes)
+                {
+                    for (std::size_t lane{}; lane < lanes; ++lane)
+                    {
+                        const T element    = first[i + lane];
+                        accumulators[lane] = (largest ? accumulators[lane] < element : element < accumulators[lane])
+                                                 ? element
+                                                 : accumulators[lane];
+                    }
+                }
+                for (std::size_t lane{}; lane < lanes; ++lane)
+                {
+                    result = (largest ? result < accumulators[lane] : accumulators[lane] < result) ? accumulators[lane]
+                                                                                                  : result;
+                }
+            }
+            for (; i < count; ++i)
+            {
+                result = (largest ? result < first[i] : first[i] < result) ? first[i] : result;
+            }
+            return result;
+        }
+
+        /**
+         * Folds the count > 0 elements at first, which is aligned to alignment, with op, starting
+         * from the first element.
+         */
+        template <std::size_t alignment, typename Result, typename T, class BinaryOp>
+        [[nodiscard]] Result
+        fold_elements(const T *first, const std::size_t count, BinaryOp &op)
+        {
+            if constexpr (cesa::detail::is_simd_element_v<T> && std::is_same_v<Result, T> && is_plus_v<BinaryOp, T>)
+            {
+                return sum_elements<alignment>(first, count);
+            }
+            else
+            {
+                return std::accumulate(first + 1, first + count, Result(first[0]), std::ref(op));
+            }
+        }
+
+        /**
+         * The index of the first smallest, or with largest set the first largest, of the count
+         * elements at first, or count if there are none.
+         */
+        template <bool largest, class ExecutionPolicy, std::size_t alignment, typename T, class Compare>
+        [[nodiscard]] std::size_t
+        extreme_index(const T *first, const std::size_t count, Compare &comp)
+        {
+            if (count == 0)
+            {
+                return count;
+            }
+            constexpr std::size_t granule = chunk_granule<T, alignment>;
+            const std::size_t     chunks  = chunk_count<ExecutionPolicy>(count, granule);
+            if constexpr (cesa::detail::is_simd_element_v<T> && is_less_v<Compare, T>)
+            {
+                if (chunks == 1)
+                {
+                    return cesa::detail::find_index(first, count, extreme_element<largest, alignment>(first, count));
+                }
+                chunk_results<T> extremes(with_size, chunks);
+                for_each_chunk(count, chunks, granule,
+                               [&](const std::size_t chunk, const std::size_t begin, const std::size_t end) {
+                                   extremes[chunk] = extreme_element<largest, alignment>(first + begin, end - begin);
+                               });
+                const T extreme = extreme_element<largest, alignof(T)>(extremes.data(), chunks);
+                return cesa::detail::find_index(first, count, extreme);
+            }
+            else
+            {
+                const auto find = [&](const std::size_t begin, const std::size_t end) {
+                    const T *extreme = largest ? std::max_element(first + begin, first + end, std::ref(comp))
+                                               : std::min_element(first + begin, first + end, std::ref(comp));
+                    return static_cast<std::size_t>(extreme - first);
+                };
+                if (chunks == 1)
+                {
+                    return find(0, count);
+                }
+                chunk_results<std::size_t> indices(with_size, chunks);
+                for_each_chunk(count, chunks, granule,
+                               [&](const std::size_t chunk, const std::size_t begin, const std::size_t end) {
+                                   indices[chunk] = find(begin, end);
+                               });
+                std::size_t extreme = indices[0];
+                for (std::size_t chunk = 1; chunk < chunks; ++chunk)
+                {
+                    // Only a strictly better element replaces the current one, so ties resolve to
+                    // the earliest element as in std::min_element and std::max_element
+                    const T &candidate = first[indices[chunk]];
+                    if (largest ? comp(first[extreme], candidate) : comp(candidate, first[extreme]))
+                    {
+                        extreme = indices[chunk];
+                    }
+                }
+                return extreme;
+            }
+        }
+
+        /**
+         * Writes the inclusive or exclusive scan of the count elements at first to result. An
+         * inclusive scan has no init and starts from the first element.
+         */
+        template <class ExecutionPolicy, std::size_t granule, std::size_t alignment, typename Accumulator,
+                  bool exclusive, typename T, typename U, class BinaryOp>
+        void
+        scan(const T *first, const std::size_t count, U *result, std::optional<Accumulator> init, BinaryOp &op)
+        {
+            const std::size_t chunks = chunk_count<ExecutionPolicy>(count, granule);
+            if (chunks == 1)
+            {
+                if constexpr (exclusive)
+                {
+                    std::exclusive_scan(first, first + count, result, std::move(*init), std::ref(op));
+                }
+                else
+                {
+                    std::inclusive_scan(first, first + count, result, std::ref(op));
+                }
+                return;
+            }
+            // First pass: fold every chunk but the last. Second pass: scan every chunk, starting
+            // from the fold of all chunks before it.
+            chunk_results<std::optional<Accumulator>> carries(with_size, chunks);
+            thread_pool::instance().run(chunks - 1, [&](const std::size_t chunk) {
+                const std::size_t begin = chunk_boundary(count, chunks, chunk, granule);
+                const std::size_t end   = chunk_boundary(count, chunks, chunk + 1, granule);
+                carries[chunk + 1].emplace(fold_elements<alignment, Accumulator>(first + begin, end - begin, op));
+            });
+            carries[0] = std::move(init);
+            for (std::size_t chunk = 1; chunk < chunks; ++chunk)
+            {
+                if (carries[chunk - 1])
+                {
+                    carries[chunk].emplace(op(*carries[chunk - 1], std::move(*carries[chunk])));
+                }
+            }
+            for_each_chunk(count, chunks, granule,
+                           [&](const std::size_t chunk, const std::size_t begin, const std::size_t end) {
+                               if constexpr (exclusive)
+                               {
+                                   std::exclusive_scan(first + begin, first + end, result + begin,
+                                                       std::move(*carries[chunk]), std::ref(op));
+                               }
+                               else if (chunk == 0)
+                               {
+                                   std::inclusive_scan(first, first + end, result, std::ref(op));
+                               }
+                               else
+                               {
+                                   std::inclusive_scan(first + begin, first + end, result + begin, std::ref(op),
+                                                       std::move(*carries[chunk]));
+                               }
+                           });
+        }
+
+        /**
+         * Resizes out to count elements, leaving new trivial elements uninitialized.
+         */
+        template <typename U, std::size_t max_elements, std::size_t alignment>
+        void
+        resize_output(vector<U, max_elements, alignment> &out, const std::size_t count)
+        {
+            if constexpr (std::is_trivial_v<U>)
+            {
+                out.resize_for_overwrite(count);
+            }
+            else
+            {
+                out.resize(count);
+            }
+        }
+    }
+
+    /**
+     * Sorts v with comp. The parallel policies sort the chunks concurrently and then merge
+     * neighbouring chunks pairwise, also concurrently, until one sorted range is left.
+     */
+    template <class ExecutionPolicy, typename T, std::size_t max_elements, std::size_t alignment,
+              class Compare = std::less<>>
+        requires is_execution_policy_v<ExecutionPolicy>
+    void
+    sort(ExecutionPolicy &&, vector<T, max_elements, alignment> &v, Compare comp = {})
+    {
+        constexpr std::size_t granule = detail::chunk_granule<T, alignment>;
+        const std::size_t     count   = v.size();
+        const std::size_t     chunks  = std::bit_floor(detail::chunk_count<ExecutionPolicy>(count, granule));
+        T                    *first   = v.data();
+        if (chunks == 1)
+        {
+            std::sort(first, first + count, comp);
+            return;
+        }
+        detail::for_each_chunk(count, chunks, granule,
+                               [&](const std::size_t, const std::size_t begin, const std::size_t end) {
+                                   std::sort(first + begin, first + end, std::ref(comp));
+                               });
+        for (std::size_t width = 1; width < chunks; width *= 2)
+        {
+            detail::thread_pool::instance().run(chunks / (2 * width), [&](const std::size_t pair) {
+                const std::size_t chunk = 2 * width * pair;
+                std::inplace_merge(first + detail::chunk_boundary(count, chunks, chunk, granule),
+                                   first + detail::chunk_boundary(count, chunks, chunk + width, granule),
+                                   first + detail::chunk_boundary(count, chunks, chunk + 2 * width, granule),
+                                   std::ref(comp));
+            });
+        }
+    }
+
+    /**
+     * Replaces every element x of v with op(x).
+     */
+    template <class ExecutionPolicy, typename T, std::size_t max_elements, std::size_t alignment, class UnaryOp>
+        requires is_execution_policy_v<ExecutionPolicy>
+    void
+    transform(ExecutionPolicy &&, vector<T, max_elements, alignment> &v, UnaryOp op)
+    {
+        constexpr std::size_t granule = detail::chunk_granule<T, alignment>;
+        const std::size_t     count   = v.size();
+        T                    *data    = v.data();
+        detail::for_each_chunk(count, detail::chunk_count<ExecutionPolicy>(count, granule), granule,
+                               [&](const std::size_t, const std::size_t begin, const std::size_t end) {
+                                   T *first = std::assume_aligned<alignment>(data + begin);
+                                   for (std::size_t i{}; i < end - begin; ++i)
+                                   {
+                                       first[i] = op(first[i]);
+                                   }
+                               });
+    }
+
+    /**
+     * Resizes out to in.size() and sets out[i] to op(in[i]) for every i. out may be in itself.
+     * Reports an error if out cannot hold in.size() elements.
+     */
+    template <class ExecutionPolicy, typename T, std::size_t max_elements_in, std::size_t alignment_in, typename U,
+              std::size_t max_elements_out, std::size_t alignment_out, class UnaryOp>
+        requires is_execution_policy_v<ExecutionPolicy>
+    void
+    transform(ExecutionPolicy &&, const vector<T, max_elements_in, alignment_in> &in,
+              vector<U, max_elements_out, alignment_out> &out, UnaryOp op)
+    {
+        constexpr std::size_t granule =
+            std::max(detail::chunk_granule<T, alignment_in>, detail::chunk_granule<U, alignment_out>);
+        const std::size_t count = in.size();
+        detail::resize_output(out, count);
+        const T *source      = in.data();
+        U       *destination = out.data();
+        detail::for_each_chunk(count, detail::chunk_count<ExecutionPolicy>(count, granule), granule,
+                               [&](const std::size_t, const std::size_t begin, const std::size_t end) {
+                                   const T *first  = std::assume_aligned<alignment_in>(source + begin);
+                                   U       *result = std::assume_aligned<alignment_out>(destination + begin);
+                                   for (std::size_t i{}; i < end - begin; ++i)
+                                   {
+                                       result[i] = op(first[i]);
+                                   }
+                               });
+    }
+
+    /**
+     * Combines init and the elements of v with op, in any grouping and order. With std::plus on
+     * arithmetic elements and an init of the element type, the sum is computed in SIMD lanes.
+     */
+    template <class ExecutionPolicy, typename T, std::size_t max_elements, std::size_t alignment, typename U,
+              class BinaryOp = std::plus<>>
+        requires is_execution_policy_v<ExecutionPolicy>
+    [[nodiscard]] U
+    reduce(ExecutionPolicy &&, const vector<T, max_elements, alignment> &v, U init, BinaryOp op = {})
+    {
+        constexpr std::size_t granule = detail::chunk_granule<T, alignment>;
+        const std::size_t     count   = v.size();
+        const std::size_t     chunks  = detail::chunk_count<ExecutionPolicy>(count, granule);
+        const T              *first   = v.data();
+        if (count == 0)
+        {
+            return init;
+        }
+        if (chunks == 1)
+        {
+            return op(std::move(init), detail::fold_elements<alignment, U>(first, count, op));
+        }
+        detail::chunk_results<std::optional<U>> partials(with_size, chunks);
+        detail::for_each_chunk(count, chunks, granule,
+                               [&](const std::size_t chunk, const std::size_t begin, const std::size_t end) {
+                                   partials[chunk].emplace(
+                                       detail::fold_elements<alignment, U>(first + begin, end - begin, op));
+                               });
+        for (std::optional<U> &partial : partials)
+        {
+            init = op(std::move(init), std::move(*partial));
+        }
+        return init;
+    }
+
+    /**
+     * The sum of the elements of v, starting from a value-initialized T.
+     */
+    template <class ExecutionPolicy, typename T, std::size_t max_elements, std::size_t alignment>
+        requires is_execution_policy_v<ExecutionPolicy>
+    [[nodiscard]] T
+    reduce(ExecutionPolicy &&policy, const vector<T, max_elements, alignment> &v)
+    {
+        return algorithms::reduce(std::forward<ExecutionPolicy>(policy), v, T{});
+    }
+
+    /**
+     * An iterator to the first smallest element of v, or end() if v is empty. With std::less on
+     * arithmetic elements the minimum is found in SIMD lanes; floating-point elements must then
+     * not be NaN, which std::min_element does not allow either, as NaN breaks the strict weak
+     * ordering.
+     */
+    template <class ExecutionPolicy, typename T, std::size_t max_elements, std::size_t alignment,
+              class Compare = std::less<>>
+        requires is_execution_policy_v<ExecutionPolicy>
+    [[nodiscard]] typename vector<T, max_elements, alignment>::iterator
+    min_element(ExecutionPolicy &&, vector<T, max_elements, alignment> &v, Compare comp = {})
+    {
+        return v.begin() + static_cast<std::ptrdiff_t>(
+                               detail::extreme_index<false, ExecutionPolicy, alignment>(v.data(), v.size(), comp));
+    }
+
+    template <class ExecutionPolicy, typename T, std::size_t max_elements, std::size_t alignment,
+              class Compare = std::less<>>
+        requires is_execution_policy_v<ExecutionPolicy>
+    [[nodiscard]] typename vector<T, max_elements, alignment>::const_iterator
+    min_element(ExecutionPolicy &&, const vector<T, max_elements, alignment> &v, Compare comp = {})
+    {
+        return v.begin() + static_cast<std::ptrdiff_t>(
+                               detail::extreme_index<false, ExecutionPolicy, alignment>(v.data(), v.size(), comp));
+    }
+
+    /**
+     * An iterator to the first largest element of v, or end() if v is empty. The same restrictions
+     * as for min_element() apply.
+     */
+    template <class ExecutionPolicy, typename T, std::size_t max_elements, std::size_t alignment,
+              class Compare = std::less<>>
+        requires is_execution_policy_v<ExecutionPolicy>
+    [[nodiscard]] typename vector<T, max_elements, alignment>::iterator
+    max_element(ExecutionPolicy &&, vector<T, max_elements, alignment> &v, Compare comp = {})
+    {
+        return v.begin() + static_cast<std::ptrdiff_t>(
+                               detail::extreme_index<true, ExecutionPolicy, alignment>(v.data(), v.size(), comp));
+    }
+
+    template <class ExecutionPolicy, typename T, std::size_t max_elements, std::size_t alignment,
+              class Compare = std::less<>>
+        requires is_execution_policy_v<ExecutionPolicy>
+    [[nodiscard]] typename vector<T, max_elements, alignment>::const_iterator
+    max_element(ExecutionPolicy &&, const vector<T, max_elements, alignment> &v, Compare comp = {})
+    {
+        return v.begin() + static_cast<std::ptrdiff_t>(
+                               detail::extreme_index<true, ExecutionPolicy, alignment>(v.data(), v.size(), comp));
+    }
+
+    /**
+     * Resizes out to in.size() and sets out[i] to in[0] op ... op in[i] for every i. out may be
+     * in itself. The parallel policies fold the chunks first and then scan them concurrently, each
+     * starting from the fold of the chunks before it.
+     */
+    template <class ExecutionPolicy, typename T, std::size_t max_elements_in, std::size_t alignment_in, typename U,
+              std::size_t max_elements_out, std::size_t alignment_out, class BinaryOp = std::plus<>>
+        requires is_execution_policy_v<ExecutionPolicy>
+    void
+    inclusive_scan(ExecutionPolicy &&, const vector<T, max_elements_in, alignment_in> &in,
+                   vector<U, max_elements_out, alignment_out> &out, BinaryOp op = {})
+    {
+        constexpr std::size_t granule =
+            std::max(detail::chunk_granule<T, alignment_in>, detail::chunk_granule<U, alignment_out>);
+        detail::resize_output(out, in.size());
+        detail::scan<ExecutionPolicy, granule, alignment_in, T, false>(in.data(), in.size(), out.data(),
+                                                                        std::optional<T>(), op);
+    }
+
+    /**
+     * Resizes out to in.size() and sets out[i] to init op in[0] op ... op in[i - 1] for every i.
+     * out may be in itself.
+     */
+    template <class ExecutionPolicy, typename T, std::size_t max_elements_in, std::size_t alignment_in, typename U,
+              std::size_t max_elements_out, std::size_t alignment_out, typename Init, class BinaryOp = std::plus<>>
+        requires is_execution_policy_v<ExecutionPolicy>
+    void
+    exclusive_scan(ExecutionPolicy &&, const vector<T, max_elements_in, alignment_in> &in,
+                   vector<U, max_elements_out, alignment_out> &out, Init init, BinaryOp op = {})
+    {
+        constexpr std::size_t granule =
+            std::max(detail::chunk_granule<T, alignment_in>, detail::chunk_granule<U, alignment_out>);
+        detail::resize_output(out, in.size());
+        detail::scan<ExecutionPolicy, granule, alignment_in, Init, true>(in.data(), in.size(), out.data(),
+                                                                          std::optional<Init>(std::move(init)), op);
+    }
+}
+
+inline cesa::algorithms::detail::thread_pool &
+cesa::algorithms::detail::thread_pool::instance()
+{
+    static thread_pool pool;
+    return pool;
+}
+
+inline
+cesa::algorithms::detail::thread_pool::thread_pool()
+{
+    const unsigned threads = CESA_PARALLEL_THREADS > 0 ? CESA_PARALLEL_THREADS : std::thread::hardware_concurrency();
+    workers_.reserve(threads > 1 ? threads - 1 : 0);
+#if CESA_HAS_EXCEPTIONS
+    try
+    {
+#endif
+        for (unsigned i = 1; i < threads; ++i)
+        {
+            workers_.emplace_back([this] { work(); });
+        }
+#if CESA_HAS_EXCEPTIONS
+    }
+    catch (const std::system_error &)
+    {
+        // Run with the workers that could be started
+    }
+#endif
+}
+
+inline
+cesa::algorithms::detail::thread_pool::~thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread &worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+inline std::size_t
+cesa::algorithms::detail::thread_pool::concurrency() const noexcept
+{
+    return workers_.size() + 1;
+}
+
+template <class F>
+void
+cesa::algorithms::detail::thread_pool::run(const std::size_t task_count, F &&task)
+{
+    std::unique_lock<std::mutex> submit(submit_mutex_, std::try_to_lock);
+    if (task_count <= 1 || workers_.empty() || !submit.owns_lock())
+    {
+        for (std::size_t i{}; i < task_count; ++i)
+        {
+            task(i);
+        }
+        return;
+    }
+    using task_type                 = std::remove_reference_t<F>;
+    const task_function function    = [](void *context, const std::size_t index) {
+        (*static_cast<task_type *>(context))(index);
+    };
+    void *const         context     = static_cast<void *>(std::addressof(task));
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        function_       = function;
+        context_        = context;
+        task_count_     = task_count;
+        active_workers_ = workers_.size();
+        next_task_.store(0, std::memory_order_relaxed);
+        ++generation_;
+    }
+    wake_.notify_all();
+    drain(function, context, task_count);
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return active_workers_ == 0; });
+}
+
+inline void
+cesa::algorithms::detail::thread_pool::work()
+{
+    std::size_t                  seen_generation{};
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;)
+    {
+        wake_.wait(lock, [&] { return stopping_ || generation_ != seen_generation; });
+        if (stopping_)
+        {
+            return;
+        }
+        seen_generation                  = generation_;
+        const task_function function     = function_;
+        void *const         context      = context_;
+        const std::size_t   task_count   = task_count_;
+        lock.unlock();
+        drain(function, context, task_count);
+        lock.lock();
+        if (--active_workers_ == 0)
+        {
+            done_.notify_one();
+        }
+    }
+}
+
+inline void
+cesa::algorithms::detail::thread_pool::drain(const task_function function, void *const context,
+                                             const std::size_t task_count) noexcept
+{
+    for (std::size_t i = next_task_.fetch_add(1, std::memory_order_relaxed); i < task_count;
+         i = next_task_.fetch_add(1, std::memory_order_relaxed))
+    {
+        function(context, i);
+    }
+}
+
+#endif
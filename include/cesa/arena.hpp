@@ -0,0 +1,423 @@
+#ifndef CESA_ARENA_HPP
+#define CESA_ARENA_HPP
+
+/**
+ * arena.hpp
+ *
+ * Fixed-capacity memory sources with inline storage, for heap-free allocation of variable-size data.
+ *
+ * The cesa::arena class is a bump allocator over an inline buffer: allocating advances an offset,
+ * deallocating individual blocks does nothing, and reset() or rewind() releases everything at once
+ * in O(1). cesa::arena_scope rewinds an arena when it goes out of scope, so the memory used while
+ * handling one request costs one pointer bump per allocation and one reset.
+ *
+ * The cesa::pool class hands out fixed-size blocks from an inline buffer with an intrusive free
+ * list, so blocks can be freed and reused individually in O(1), which suits node-based structures.
+ *
+ * Both follow the cesa convention of declaring the maximum up front. allocate() reports exhaustion
+ * through CESA_ERROR_POLICY (see config.hpp), try_allocate() returns nullptr instead.
+ *
+ * cesa::resource_adapter exposes either one as a std::pmr::memory_resource, falling back to an
+ * upstream resource when exhausted, so they can back cesa::pmr::small_vector or any std::pmr
+ * container. cesa::thread_local_arena() provides one arena per thread.
+ *
+ * Attention:
+ * Arenas and pools are not thread-safe. Use one per thread, e.g. through cesa::thread_local_arena().
+ * As the storage is inline, a large arena should not be placed on the stack.
+ */
+
+#include "config.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+
+namespace cesa
+{
+    template <std::size_t capacity_bytes, std::size_t alignment = alignof(std::max_align_t)>
+    class arena
+    {
+        static_assert((alignment & (alignment - 1)) == 0, "arena alignment must be a power of two");
+        static_assert(detail::check_inline_budget<capacity_bytes>(),
+                      "arena inline storage exceeds CESA_MAX_INLINE_BYTES");
+
+    public:
+        using size_type = std::size_t;
+
+        /**
+         * An offset into the arena, as returned by mark() and accepted by rewind().
+         */
+        using marker = size_type;
+
+        constexpr arena() noexcept = default;
+
+        arena(const arena &) = delete;
+
+        arena &operator=(const arena &) = delete;
+
+        /**
+         * Allocates bytes with the given alignment, which may exceed the alignment of the arena.
+         */
+        [[nodiscard]] void *allocate(size_type bytes, size_type align = alignof(std::max_align_t));
+
+        [[nodiscard]] void *try_allocate(size_type bytes, size_type align = alignof(std::max_align_t)) noexcept;
+
+        /**
+         * Does nothing: memory is only reclaimed by reset() and rewind().
+         */
+        void deallocate(void *p, size_type bytes, size_type align = alignof(std::max_align_t)) noexcept;
+
+        [[nodiscard]] marker mark() const noexcept;
+
+        /**
+         * Releases everything allocated since mark() returned position.
+         */
+        void rewind(marker position) noexcept;
+
+        void reset() noexcept;
+
+        [[nodiscard]] bool owns(const void *p) const noexcept;
+
+        [[nodiscard]] size_type used() const noexcept;
+
+        [[nodiscard]] size_type remaining() const noexcept;
+
+        [[nodiscard]] static constexpr size_type capacity() noexcept;
+
+    private:
+        alignas(alignment) std::byte buffer_[capacity_bytes];
+        size_type                    used_{};
+    };
+
+    /**
+     * Rewinds an arena to where it was when the scope was entered.
+     */
+    template <class Arena>
+    class arena_scope
+    {
+    public:
+        explicit arena_scope(Arena &arena) noexcept
+            : arena_(arena)
+            , start_(arena.mark())
+        {
+        }
+
+        arena_scope(const arena_scope &) = delete;
+
+        arena_scope &operator=(const arena_scope &) = delete;
+
+        ~arena_scope()
+        {
+            arena_.rewind(start_);
+        }
+
+    private:
+        Arena                 &arena_;
+        typename Arena::marker start_;
+    };
+
+    template <std::size_t block_size, std::size_t block_count, std::size_t alignment = alignof(std::max_align_t)>
+    class pool
+    {
+        static_assert((alignment & (alignment - 1)) == 0, "pool alignment must be a power of two");
+        static_assert(block_count > 0, "pool needs at least one block");
+
+        struct free_block
+        {
+            free_block *next;
+        };
+
+        // Every block must hold a free_block and keep the next one aligned, so blocks may be padded
+        static constexpr std::size_t block_alignment =
+            alignment < alignof(free_block) ? alignof(free_block) : alignment;
+        static constexpr std::size_t stride =
+            ((block_size < sizeof(free_block) ? sizeof(free_block) : block_size) + block_alignment - 1) /
+            block_alignment * block_alignment;
+
+        static_assert(detail::check_inline_budget<stride * block_count>(),
+                      "pool inline storage exceeds CESA_MAX_INLINE_BYTES");
+
+    public:
+        using size_type = std::size_t;
+
+        constexpr pool() noexcept = default;
+
+        pool(const pool &) = delete;
+
+        pool &operator=(const pool &) = delete;
+
+        /**
+         * Allocates one block. bytes and align must not exceed block_size and alignment.
+         */
+        [[nodiscard]] void *allocate(size_type bytes = block_size, size_type align = alignment);
+
+        [[nodiscard]] void *try_allocate(size_type bytes = block_size, size_type align = alignment) noexcept;
+
+        void deallocate(void *p, size_type bytes = block_size, size_type align = alignment) noexcept;
+
+        /**
+         * Releases all blocks at once.
+         */
+        void reset() noexcept;
+
+        [[nodiscard]] bool owns(const void *p) const noexcept;
+
+        [[nodiscard]] size_type used() const noexcept;
+
+        [[nodiscard]] static constexpr size_type capacity() noexcept;
+
+    private:
+        alignas(block_alignment) std::byte buffer_[stride * block_count];
+        free_block                        *free_list_{};
+        size_type                          untouched_{}; // Blocks from here on were never handed out
+        size_type                          used_{};
+    };
+
+    /**
+     * A std::pmr::memory_resource serving allocations from an arena or pool. Requests the source
+     * cannot satisfy are forwarded to upstream, which by default fails with std::bad_alloc.
+     * The source and upstream must outlive the adapter.
+     */
+    template <class Source>
+    class resource_adapter final : public std::pmr::memory_resource
+    {
+    public:
+        explicit resource_adapter(Source                    &source,
+                                  std::pmr::memory_resource *upstream = std::pmr::null_memory_resource()) noexcept
+            : source_(source)
+            , upstream_(upstream)
+        {
+        }
+
+        [[nodiscard]] Source &
+        source() const noexcept
+        {
+            return source_;
+        }
+
+        [[nodiscard]] std::pmr::memory_resource *
+        upstream() const noexcept
+        {
+            return upstream_;
+        }
+
+    private:
+        Source                    &source_;
+        std::pmr::memory_resource *upstream_;
+
+        void *
+        do_allocate(const std::size_t bytes, const std::size_t align) override
+        {
+            void *p = source_.try_allocate(bytes, align);
+            return p != nullptr ? p : upstream_->allocate(bytes, align);
+        }
+
+        void
+        do_deallocate(void *p, const std::size_t bytes, const std::size_t align) override
+        {
+            if (source_.owns(p))
+            {
+                source_.deallocate(p, bytes, align);
+            }
+            else
+            {
+                upstream_->deallocate(p, bytes, align);
+            }
+        }
+
+        [[nodiscard]] bool
+        do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+
+    /**
+     * The calling thread's instance of arena<capacity_bytes>, created on first use. Distinct Tag
+     * types give independent arenas of the same size.
+     */
+    template <std::size_t capacity_bytes, typename Tag = void>
+    [[nodiscard]] arena<capacity_bytes> &
+    thread_local_arena() noexcept
+    {
+        thread_local arena<capacity_bytes> instance;
+        return instance;
+    }
+}
+
+template <std::size_t capacity_bytes, std::size_t alignment>
+void *
+cesa::arena<capacity_bytes, alignment>::allocate(const size_type bytes, const size_type align)
+{
+    void *p = try_allocate(bytes, align);
+    if (p == nullptr)
+    {
+        detail::report_error("arena capacity exceeded");
+    }
+    return p;
+}
+
+template <std::size_t capacity_bytes, std::size_t alignment>
+void *
+cesa::arena<capacity_bytes, alignment>::try_allocate(const size_type bytes, const size_type align) noexcept
+{
+    const auto base    = reinterpret_cast<std::uintptr_t>(buffer_);
+    const auto aligned = (base + used_ + (align - 1)) & ~static_cast<std::uintptr_t>(align - 1);
+    const auto offset  = static_cast<size_type>(aligned - base);
+    if (offset > capacity_bytes || bytes > capacity_bytes - offset)
+    {
+        return nullptr;
+    }
+    used_ = offset + bytes;
+    return buffer_ + offset;
+}
+
+template <std::size_t capacity_bytes, std::size_t alignment>
+void
+cesa::arena<capacity_bytes, alignment>::deallocate(void *, size_type, size_type) noexcept
+{
+}
+
+template <std::size_t capacity_bytes, std::size_t alignment>
+typename cesa::arena<capacity_bytes, alignment>::marker
+cesa::arena<capacity_bytes, alignment>::mark() const noexcept
+{
+    return used_;
+}
+
+template <std::size_t capacity_bytes, std::size_t alignment>
+void
+cesa::arena<capacity_bytes, alignment>::rewind(const marker position) noexcept
+{
+    if (position < used_)
+    {
+        used_ = position;
+    }
+}
+
+template <std::size_t capacity_bytes, std::size_t alignment>
+void
+cesa::arena<capacity_bytes, alignment>::reset() noexcept
+{
+    used_ = 0;
+}
+
+template <std::size_t capacity_bytes, std::size_t alignment>
+bool
+cesa::arena<capacity_bytes, alignment>::owns(const void *p) const noexcept
+{
+    const auto address = reinterpret_cast<std::uintptr_t>(p);
+    const auto base    = reinterpret_cast<std::uintptr_t>(buffer_);
+    return address >= base && address < base + capacity_bytes;
+}
+
+template <std::size_t capacity_bytes, std::size_t alignment>
+typename cesa::arena<capacity_bytes, alignment>::size_type
+cesa::arena<capacity_bytes, alignment>::used() const noexcept
+{
+    return used_;
+}
+
+template <std::size_t capacity_bytes, std::size_t alignment>
+typename cesa::arena<capacity_bytes, alignment>::size_type
+cesa::arena<capacity_bytes, alignment>::remaining() const noexcept
+{
+    return capacity_bytes - used_;
+}
+
+template <std::size_t capacity_bytes, std::size_t alignment>
+constexpr typename cesa::arena<capacity_bytes, alignment>::size_type
+cesa::arena<capacity_bytes, alignment>::capacity() noexcept
+{
+    return capacity_bytes;
+}
+
+template <std::size_t block_size, std::size_t block_count, std::size_t alignment>
+void *
+cesa::pool<block_size, block_count, alignment>::allocate(const size_type bytes, const size_type align)
+{
+    if (bytes > block_size || align > block_alignment)
+    {
+        detail::report_error("pool block size exceeded");
+    }
+    void *p = try_allocate(bytes, align);
+    if (p == nullptr)
+    {
+        detail::report_error("pool capacity exceeded");
+    }
+    return p;
+}
+
+template <std::size_t block_size, std::size_t block_count, std::size_t alignment>
+void *
+cesa::pool<block_size, block_count, alignment>::try_allocate(const size_type bytes, const size_type align) noexcept
+{
+    if (bytes > block_size || align > block_alignment)
+    {
+        return nullptr;
+    }
+    void *p;
+    if (free_list_ != nullptr)
+    {
+        p          = free_list_;
+        free_list_ = free_list_->next;
+    }
+    else if (untouched_ < block_count)
+    {
+        p = buffer_ + untouched_ * stride;
+        ++untouched_;
+    }
+    else
+    {
+        return nullptr;
+    }
+    ++used_;
+    return p;
+}
+
+template <std::size_t block_size, std::size_t block_count, std::size_t alignment>
+void
+cesa::pool<block_size, block_count, alignment>::deallocate(void *p, size_type, size_type) noexcept
+{
+    if (p != nullptr)
+    {
+        free_list_ = ::new(p) free_block{ free_list_ };
+        --used_;
+    }
+}
+
+template <std::size_t block_size, std::size_t block_count, std::size_t alignment>
+void
+cesa::pool<block_size, block_count, alignment>::reset() noexcept
+{
+    free_list_ = nullptr;
+    untouched_ = 0;
+    used_      = 0;
+}
+
+template <std::size_t block_size, std::size_t block_count, std::size_t alignment>
+bool
+cesa::pool<block_size, block_count, alignment>::owns(const void *p) const noexcept
+{
+    const auto address = reinterpret_cast<std::uintptr_t>(p);
+    const auto base    = reinterpret_cast<std::uintptr_t>(buffer_);
+    return address >= base && address < base + sizeof(buffer_);
+}
+
+template <std::size_t block_size, std::size_t block_count, std::size_t alignment>
+typename cesa::pool<block_size, block_count, alignment>::size_type
+cesa::pool<block_size, block_count, alignment>::used() const noexcept
+{
+    return used_;
+}
+
+template <std::size_t block_size, std::size_t block_count, std::size_t alignment>
+constexpr typename cesa::pool<block_size, block_count, alignment>::size_type
+cesa::pool<block_size, block_count, alignment>::capacity() noexcept
+{
+    return block_count;
+}
+
+#endif
@@ -0,0 +1,1174 @@
+#ifndef CESA_BITVECTOR_HPP
+#define CESA_BITVECTOR_HPP
+
+/**
+ * bitvector.hpp
+ *
+ * A fixed-capacity vector of bits with inline storage.
+ *
+ * The cesa::bitvector class stores its elements one bit each, packed into 64-bit words, next to a
+ * size counter that is only as wide as max_elements requires. Like cesa::vector it never
+ * allocates. Besides the vector interface it offers the word-level operations of a bitset:
+ * count() uses popcount, find_first(), find_next() and for_each_set() skip over clear bits a word
+ * at a time using countr_zero, and set_range() / reset_range() write whole words at once. Bits
+ * past size() are always zero, so none of these need to mask the last word.
+ *
+ * cesa::vector<bool, N> is a bitvector<N> as well, so existing boolean vectors shrink eightfold.
+ * Code that needs the element type of a vector<bool> to be bool, such as code taking data() or
+ * bool &, should use cesa::vector<std::uint8_t, N> instead.
+ *
+ * Note:
+ * Elements are accessed through the proxy type bitvector::reference, as in std::vector<bool>.
+ * Its iterators are proxy iterators, which work with range-for and the classic iterator-based
+ * algorithms but do not model the C++20 iterator concepts.
+ */
+
+#include "config.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace cesa
+{
+    template <std::size_t max_elements>
+    class bitvector
+    {
+    public:
+        using value_type      = bool;
+        using size_type       = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using word_type       = std::uint64_t;
+        using const_reference = bool;
+
+        class reference;
+
+        template <bool is_const>
+        class basic_iterator;
+
+        using iterator               = basic_iterator<false>;
+        using const_iterator         = basic_iterator<true>;
+        using reverse_iterator       = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        static constexpr size_type npos      = static_cast<size_type>(-1);
+        static constexpr size_type word_bits = sizeof(word_type) * 8;
+
+    private:
+        static constexpr size_type word_count_ = max_elements == 0 ? 1 : (max_elements + word_bits - 1) / word_bits;
+
+        static_assert(detail::check_inline_budget<sizeof(word_type) * word_count_>(),
+                      "bitvector inline storage exceeds CESA_MAX_INLINE_BYTES");
+
+    public:
+        constexpr bitvector() noexcept = default;
+
+        constexpr bitvector(std::initializer_list<bool> initializer_list);
+
+        constexpr bitvector(with_size_t, size_type count, bool value = false);
+
+        template <class InputIt, typename = std::enable_if_t<std::is_base_of_v<
+                      std::input_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category> > >
+        constexpr bitvector(from_range_t, InputIt first, InputIt last);
+
+        constexpr void swap(bitvector &other) noexcept;
+
+
+        /*** Element access ***/
+
+        [[nodiscard]] constexpr reference operator[](size_type pos) noexcept;
+
+        [[nodiscard]] constexpr const_reference operator[](size_type pos) const noexcept;
+
+        [[nodiscard]] constexpr reference at(size_type pos);
+
+        [[nodiscard]] constexpr const_reference at(size_type pos) const;
+
+        [[nodiscard]] constexpr reference front() noexcept;
+
+        [[nodiscard]] constexpr const_reference front() const noexcept;
+
+        [[nodiscard]] constexpr reference back() noexcept;
+
+        [[nodiscard]] constexpr const_reference back() const noexcept;
+
+        [[nodiscard]] constexpr bool test(size_type pos) const noexcept;
+
+        /**
+         * The words holding the elements: element i is bit i % word_bits of word i / word_bits.
+         * The bits past size() in the last word are zero.
+         */
+        [[nodiscard]] constexpr std::span<const word_type> words() const noexcept;
+
+
+        /*** Bit operations ***/
+
+        constexpr void set(size_type pos, bool value = true) noexcept;
+
+        constexpr void reset(size_type pos) noexcept;
+
+        constexpr void flip(size_type pos) noexcept;
+
+        /**
+         * Sets the elements in [first, last), which must lie within [0, size()), a word at a time.
+         */
+        constexpr void set_range(size_type first, size_type last) noexcept;
+
+        /**
+         * Clears the elements in [first, last), which must lie within [0, size()), a word at a time.
+         */
+        constexpr void reset_range(size_type first, size_type last) noexcept;
+
+        /**
+         * The number of set elements.
+         */
+        [[nodiscard]] constexpr size_type count() const noexcept;
+
+        [[nodiscard]] constexpr bool any() const noexcept;
+
+        [[nodiscard]] constexpr bool none() const noexcept;
+
+        [[nodiscard]] constexpr bool all() const noexcept;
+
+        /**
+         * The index of the first set element, or npos if there is none.
+         */
+        [[nodiscard]] constexpr size_type find_first() const noexcept;
+
+        /**
+         * The index of the first set element after pos, or npos if there is none.
+         */
+        [[nodiscard]] constexpr size_type find_next(size_type pos) const noexcept;
+
+        /**
+         * Calls f(index) for every set element, in increasing order of index.
+         */
+        template <class F>
+        constexpr void for_each_set(F &&f) const;
+
+
+        /*** Iterators ***/
+
+        [[nodiscard]] constexpr iterator begin() noexcept;
+
+        [[nodiscard]] constexpr const_iterator begin() const noexcept;
+
+        [[nodiscard]] constexpr const_iterator cbegin() const noexcept;
+
+        [[nodiscard]] constexpr iterator end() noexcept;
+
+        [[nodiscard]] constexpr const_iterator end() const noexcept;
+
+        [[nodiscard]] constexpr const_iterator cend() const noexcept;
+
+        [[nodiscard]] constexpr reverse_iterator rbegin() noexcept;
+
+        [[nodiscard]] constexpr const_reverse_iterator rbegin() const noexcept;
+
+        [[nodiscard]] constexpr reverse_iterator rend() noexcept;
+
+        [[nodiscard]] constexpr const_reverse_iterator rend() const noexcept;
+
+
+        /*** Capacity ***/
+
+        [[nodiscard]] constexpr bool empty() const noexcept;
+
+        [[nodiscard]] constexpr size_type size() const noexcept;
+
+        [[nodiscard]] static constexpr size_type max_size() noexcept;
+
+
+        /*** Modifiers ***/
+
+        /**
+         * The positional modifiers shift the elements after pos a word at a time, so inserting or
+         * erasing costs O(size() / word_bits) regardless of the number of elements moved.
+         */
+        constexpr void clear() noexcept;
+
+        constexpr void assign(size_type count, bool value);
+
+        template <class InputIt, typename = std::enable_if_t<std::is_base_of_v<
+                      std::input_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category> > >
+        constexpr void assign(InputIt first, InputIt last);
+
+        constexpr void assign(std::initializer_list<bool> initializer_list);
+
+        constexpr iterator insert(const_iterator pos, bool value);
+
+        constexpr iterator insert(const_iterator pos, size_type count, bool value);
+
+        template <class InputIt, typename = std::enable_if_t<std::is_base_of_v<
+                      std::input_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category> > >
+        constexpr iterator insert(const_iterator pos, InputIt first, InputIt last);
+
+        constexpr iterator insert(const_iterator pos, std::initializer_list<bool> initializer_list);
+
+        template <class... Args>
+        constexpr iterator emplace(const_iterator pos, Args &&... args);
+
+        constexpr iterator erase(const_iterator pos);
+
+        constexpr iterator erase(const_iterator first, const_iterator last);
+
+        constexpr reference push_back(bool value);
+
+        template <class... Args>
+        constexpr reference emplace_back(Args &&... args);
+
+        /**
+         * Appends value if there is room for it. Returns false if the bitvector is full.
+         */
+        [[nodiscard]] constexpr bool try_push_back(bool value) noexcept;
+
+        constexpr void pop_back() noexcept;
+
+        constexpr void resize(size_type count, bool value = false);
+
+        [[nodiscard]] friend constexpr bool
+        operator==(const bitvector &lhs, const bitvector &rhs) noexcept
+        {
+            return lhs.size_ == rhs.size_ &&
+                   std::equal(lhs.words_, lhs.words_ + lhs.live_words(), rhs.words_);
+        }
+
+        /**
+         * Bitvectors compare lexicographically, with false ordered before true.
+         */
+        [[nodiscard]] friend constexpr std::strong_ordering
+        operator<=>(const bitvector &lhs, const bitvector &rhs) noexcept
+        {
+            return lhs.compare(rhs);
+        }
+
+    private:
+        [[nodiscard]] static constexpr word_type bit_mask(size_type pos) noexcept;
+
+        /**
+         * The mask of the bits of word index that hold elements at or after pos.
+         */
+        [[nodiscard]] static constexpr word_type mask_from(size_type index, size_type pos) noexcept;
+
+        /**
+         * The word_bits elements starting at pos, which may be negative, as a word. Positions outside
+         * the storage read as zero.
+         */
+        [[nodiscard]] constexpr word_type bits_at(difference_type pos) const noexcept;
+
+        [[nodiscard]] constexpr std::strong_ordering compare(const bitvector &other) const noexcept;
+
+        /**
+         * Moves the elements in [index, size()) count positions towards the end a word at a time,
+         * leaving [index, index + count) clear. There must be room for them. Does not update size_.
+         */
+        constexpr void open_gap(size_type index, size_type count) noexcept;
+
+        /**
+         * Erases the elements in [index, index + count), which must lie within [0, size()), by
+         * moving the elements after them down a word at a time. Does not update size_.
+         */
+        constexpr void close_gap(size_type index, size_type count) noexcept;
+
+        /**
+         * The number of words holding elements.
+         */
+        [[nodiscard]] constexpr size_type live_words() const noexcept;
+
+        /**
+         * The index of the first set element at or after pos, or npos if there is none.
+         */
+        [[nodiscard]] constexpr size_type find_from(size_type pos) const noexcept;
+
+        /**
+         * Calls op(word, mask) for every word overlapping [first, last), with mask selecting the
+         * bits of the word inside the range.
+         */
+        template <class Op>
+        constexpr void for_each_word(size_type first, size_type last, Op op) noexcept;
+
+        word_type                              words_[word_count_]{};
+        detail::size_counter_t<max_elements> size_{};
+    };
+
+    template <std::size_t max_elements>
+    constexpr void
+    swap(bitvector<max_elements> &lhs, bitvector<max_elements> &rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    /**
+     * The proxy standing for one element of a bitvector.
+     */
+    template <std::size_t max_elements>
+    class bitvector<max_elements>::reference
+    {
+    public:
+        constexpr reference(const reference &) noexcept = default;
+
+        constexpr reference &
+        operator=(const bool value) noexcept
+        {
+            *word_ = value ? *word_ | mask_ : *word_ & ~mask_;
+            return *this;
+        }
+
+        constexpr reference &
+        operator=(const reference &other) noexcept
+        {
+            return *this = static_cast<bool>(other);
+        }
+
+        constexpr
+        operator bool() const noexcept
+        {
+            return (*word_ & mask_) != 0;
+        }
+
+        [[nodiscard]] constexpr bool
+        operator~() const noexcept
+        {
+            return (*word_ & mask_) == 0;
+        }
+
+        constexpr reference &
+        flip() noexcept
+        {
+            *word_ ^= mask_;
+            return *this;
+        }
+
+        friend constexpr void
+        swap(reference lhs, reference rhs) noexcept
+        {
+            const bool value = lhs;
+            lhs              = static_cast<bool>(rhs);
+            rhs              = value;
+        }
+
+    private:
+        friend class bitvector;
+
+        constexpr reference(word_type *word, const word_type mask) noexcept
+            : word_(word)
+            , mask_(mask)
+        {
+        }
+
+        word_type *word_;
+        word_type  mask_;
+    };
+
+    template <std::size_t max_elements>
+    template <bool is_const>
+    class bitvector<max_elements>::basic_iterator
+    {
+        using owner_type = std::conditional_t<is_const, const bitvector, bitvector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = bool;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = std::conditional_t<is_const, const_reference, bitvector::reference>;
+        using pointer           = void;
+
+        constexpr basic_iterator() noexcept = default;
+
+        constexpr basic_iterator(owner_type *owner, const difference_type index) noexcept
+            : owner_(owner)
+            , index_(index)
+        {
+        }
+
+        template <bool other_const, typename = std::enable_if_t<is_const && !other_const> >
+        constexpr basic_iterator(const basic_iterator<other_const> &other) noexcept
+            : owner_(other.owner_)
+            , index_(other.index_)
+        {
+        }
+
+        constexpr reference
+        operator*() const noexcept
+        {
+            return (*owner_)[static_cast<size_type>(index_)];
+        }
+
+        constexpr reference
+        operator[](const difference_type n) const noexcept
+        {
+            return (*owner_)[static_cast<size_type>(index_ + n)];
+        }
+
+        constexpr basic_iterator &
+        operator++() noexcept
+        {
+            ++index_;
+            return *this;
+        }
+
+        constexpr basic_iterator
+        operator++(int) noexcept
+        {
+            basic_iterator copy = *this;
+            ++index_;
+            return copy;
+        }
+
+        constexpr basic_iterator &
+        operator--() noexcept
+        {
+            --index_;
+            return *this;
+        }
+
+        constexpr basic_iterator
+        operator--(int) noexcept
+        {
+            basic_iterator copy = *this;
+            --index_;
+            return copy;
+        }
+
+        constexpr basic_iterator &
+        operator+=(const difference_type n) noexcept
+        {
+            index_ += n;
+            return *this;
+        }
+
+        constexpr basic_iterator &
+        operator-=(const difference_type n) noexcept
+        {
+            index_ -= n;
+            return *this;
+        }
+
+        friend constexpr basic_iterator
+        operator+(basic_iterator it, const difference_type n) noexcept
+        {
+            return it += n;
+        }
+
+        friend constexpr basic_iterator
+        operator+(const difference_type n, basic_iterator it) noexcept
+        {
+            return it += n;
+        }
+
+        friend constexpr basic_iterator
+        operator-(basic_iterator it, const difference_type n) noexcept
+        {
+            return it -= n;
+        }
+
+        friend constexpr difference_type
+        operator-(const basic_iterator &lhs, const basic_iterator &rhs) noexcept
+        {
+            return lhs.index_ - rhs.index_;
+        }
+
+        friend constexpr bool
+        operator==(const basic_iterator &lhs, const basic_iterator &rhs) noexcept
+        {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend constexpr auto
+        operator<=>(const basic_iterator &lhs, const basic_iterator &rhs) noexcept
+        {
+            return lhs.index_ <=> rhs.index_;
+        }
+
+    private:
+        template <bool>
+        friend class basic_iterator;
+
+        owner_type     *owner_{};
+        difference_type index_{};
+    };
+
+    /**
+     * cesa::vector<bool, N> stores its elements as bits. The alignment parameter is accepted for
+     * compatibility with the primary template, and ignored.
+     */
+    template <std::size_t max_elements, std::size_t alignment>
+    class vector<bool, max_elements, alignment> : public bitvector<max_elements>
+    {
+    public:
+        using bitvector<max_elements>::bitvector;
+
+        constexpr vector() noexcept = default;
+
+        /**
+         * Constructs one element per argument, like the primary template.
+         */
+        template <class... Args,
+                  typename = std::enable_if_t<((std::is_convertible_v<Args &&, bool> &&
+                                                !detail::is_construction_tag_v<std::remove_cvref_t<Args> >) &&
+                                               ...)> >
+        explicit constexpr vector(Args &&... args)
+            : bitvector<max_elements>({ static_cast<bool>(args)... })
+        {
+        }
+
+        [[nodiscard]] friend constexpr bool
+        operator==(const vector &lhs, const vector &rhs) noexcept
+        {
+            return static_cast<const bitvector<max_elements> &>(lhs) == rhs;
+        }
+    };
+}
+
+template <std::size_t max_elements>
+constexpr cesa::bitvector<max_elements>::bitvector(const std::initializer_list<bool> initializer_list)
+{
+    if (initializer_list.size() > max_elements)
+    {
+        detail::report_error("bitvector capacity exceeded");
+    }
+    for (const bool value : initializer_list)
+    {
+        push_back(value);
+    }
+}
+
+template <std::size_t max_elements>
+constexpr cesa::bitvector<max_elements>::bitvector(with_size_t, const size_type count, const bool value)
+{
+    resize(count, value);
+}
+
+template <std::size_t max_elements>
+template <class InputIt, typename>
+constexpr cesa::bitvector<max_elements>::bitvector(from_range_t, InputIt first, InputIt last)
+{
+    for (; first != last; ++first)
+    {
+        push_back(static_cast<bool>(*first));
+    }
+}
+
+template <std::size_t max_elements>
+constexpr void
+cesa::bitvector<max_elements>::swap(bitvector &other) noexcept
+{
+    std::swap(words_, other.words_);
+    std::swap(size_, other.size_);
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::reference
+cesa::bitvector<max_elements>::operator[](const size_type pos) noexcept
+{
+    return reference(&words_[pos / word_bits], bit_mask(pos));
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::const_reference
+cesa::bitvector<max_elements>::operator[](const size_type pos) const noexcept
+{
+    return test(pos);
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::reference
+cesa::bitvector<max_elements>::at(const size_type pos)
+{
+    if (pos >= size_)
+    {
+        detail::report_error("index out of range");
+    }
+    return (*this)[pos];
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::const_reference
+cesa::bitvector<max_elements>::at(const size_type pos) const
+{
+    if (pos >= size_)
+    {
+        detail::report_error("index out of range");
+    }
+    return test(pos);
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::reference
+cesa::bitvector<max_elements>::front() noexcept
+{
+    return (*this)[0];
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::const_reference
+cesa::bitvector<max_elements>::front() const noexcept
+{
+    return test(0);
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::reference
+cesa::bitvector<max_elements>::back() noexcept
+{
+    return (*this)[size_ - 1];
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::const_reference
+cesa::bitvector<max_elements>::back() const noexcept
+{
+    return test(size_ - 1);
+}
+
+template <std::size_t max_elements>
+constexpr bool
+cesa::bitvector<max_elements>::test(const size_type pos) const noexcept
+{
+    return (words_[pos / word_bits] & bit_mask(pos)) != 0;
+}
+
+template <std::size_t max_elements>
+constexpr std::span<const typename cesa::bitvector<max_elements>::word_type>
+cesa::bitvector<max_elements>::words() const noexcept
+{
+    return std::span<const word_type>(words_, live_words());
+}
+
+template <std::size_t max_elements>
+constexpr void
+cesa::bitvector<max_elements>::set(const size_type pos, const bool value) noexcept
+{
+    (*this)[pos] = value;
+}
+
+template <std::size_t max_elements>
+constexpr void
+cesa::bitvector<max_elements>::reset(const size_type pos) noexcept
+{
+    words_[pos / word_bits] &= ~bit_mask(pos);
+}
+
+template <std::size_t max_elements>
+constexpr void
+cesa::bitvector<max_elements>::flip(const size_type pos) noexcept
+{
+    words_[pos / word_bits] ^= bit_mask(pos);
+}
+
+template <std::size_t max_elements>
+constexpr void
+cesa::bitvector<max_elements>::set_range(const size_type first, const size_type last) noexcept
+{
+    for_each_word(first, last, [](word_type &word, const word_type mask) { word |= mask; });
+}
+
+template <std::size_t max_elements>
+constexpr void
+cesa::bitvector<max_elements>::reset_range(const size_type first, const size_type last) noexcept
+{
+    for_each_word(first, last, [](word_type &word, const word_type mask) { word &= ~mask; });
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::size_type
+cesa::bitvector<max_elements>::count() const noexcept
+{
+    size_type result{};
+    for (size_type i{}; i < live_words(); ++i)
+    {
+        result += static_cast<size_type>(std::popcount(words_[i]));
+    }
+    return result;
+}
+
+template <std::size_t max_elements>
+constexpr bool
+cesa::bitvector<max_elements>::any() const noexcept
+{
+    return find_first() != npos;
+}
+
+template <std::size_t max_elements>
+constexpr bool
+cesa::bitvector<max_elements>::none() const noexcept
+{
+    return !any();
+}
+
+template <std::size_t max_elements>
+constexpr bool
+cesa::bitvector<max_elements>::all() const noexcept
+{
+    return count() == size_;
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::size_type
+cesa::bitvector<max_elements>::find_first() const noexcept
+{
+    return find_from(0);
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::size_type
+cesa::bitvector<max_elements>::find_next(const size_type pos) const noexcept
+{
+    return pos + 1 >= size_ ? npos : find_from(pos + 1);
+}
+
+template <std::size_t max_elements>
+template <class F>
+constexpr void
+cesa::bitvector<max_elements>::for_each_set(F &&f) const
+{
+    for (size_type i{}; i < live_words(); ++i)
+    {
+        for (word_type word = words_[i]; word != 0; word &= word - 1)
+        {
+            f(i * word_bits + static_cast<size_type>(std::countr_zero(word)));
+        }
+    }
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::iterator
+cesa::bitvector<max_elements>::begin() noexcept
+{
+    return iterator(this, 0);
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::const_iterator
+cesa::bitvector<max_elements>::begin() const noexcept
+{
+    return const_iterator(this, 0);
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::const_iterator
+cesa::bitvector<max_elements>::cbegin() const noexcept
+{
+    return begin();
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::iterator
+cesa::bitvector<max_elements>::end() noexcept
+{
+    return iterator(this, static_cast<difference_type>(size_));
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::const_iterator
+cesa::bitvector<max_elements>::end() const noexcept
+{
+    return const_iterator(this, static_cast<difference_type>(size_));
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::const_iterator
+cesa::bitvector<max_elements>::cend() const noexcept
+{
+    return end();
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::reverse_iterator
+cesa::bitvector<max_elements>::rbegin() noexcept
+{
+    return reverse_iterator(end());
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::const_reverse_iterator
+cesa::bitvector<max_elements>::rbegin() const noexcept
+{
+    return const_reverse_iterator(end());
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::reverse_iterator
+cesa::bitvector<max_elements>::rend() noexcept
+{
+    return reverse_iterator(begin());
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::const_reverse_iterator
+cesa::bitvector<max_elements>::rend() const noexcept
+{
+    return const_reverse_iterator(begin());
+}
+
+template <std::size_t max_elements>
+constexpr bool
+cesa::bitvector<max_elements>::empty() const noexcept
+{
+    return size_ == 0;
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::size_type
+cesa::bitvector<max_elements>::size() const noexcept
+{
+    return size_;
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::size_type
+cesa::bitvector<max_elements>::max_size() noexcept
+{
+    return max_elements;
+}
+
+template <std::size_t max_elements>
+constexpr void
+cesa::bitvector<max_elements>::clear() noexcept
+{
+    std::fill(words_, words_ + live_words(), word_type{});
+    size_ = 0;
+}
+
+template <std::size_t max_elements>
+constexpr void
+cesa::bitvector<max_elements>::assign(const size_type count, const bool value)
+{
+    if (count > max_elements)
+    {
+        detail::report_error("bitvector capacity exceeded");
+    }
+    clear();
+    resize(count, value);
+}
+
+template <std::size_t max_elements>
+template <class InputIt, typename>
+constexpr void
+cesa::bitvector<max_elements>::assign(InputIt first, InputIt last)
+{
+    if constexpr (detail::is_forward_iterator_v<InputIt>)
+    {
+        if (static_cast<size_type>(std::distance(first, last)) > max_elements)
+        {
+            detail::report_error("bitvector capacity exceeded");
+        }
+    }
+    clear();
+    for (; first != last; ++first)
+    {
+        push_back(static_cast<bool>(*first));
+    }
+}
+
+template <std::size_t max_elements>
+constexpr void
+cesa::bitvector<max_elements>::assign(const std::initializer_list<bool> initializer_list)
+{
+    assign(initializer_list.begin(), initializer_list.end());
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::iterator
+cesa::bitvector<max_elements>::insert(const const_iterator pos, const bool value)
+{
+    return insert(pos, 1, value);
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::iterator
+cesa::bitvector<max_elements>::insert(const const_iterator pos, const size_type count, const bool value)
+{
+    const auto index = static_cast<size_type>(pos - cbegin());
+    if (count > max_elements - size_)
+    {
+        detail::report_error("bitvector capacity exceeded");
+    }
+    open_gap(index, count);
+    size_ = static_cast<detail::size_counter_t<max_elements> >(size_ + count);
+    if (value)
+    {
+        set_range(index, index + count);
+    }
+    return begin() + static_cast<difference_type>(index);
+}
+
+template <std::size_t max_elements>
+template <class InputIt, typename>
+constexpr typename cesa::bitvector<max_elements>::iterator
+cesa::bitvector<max_elements>::insert(const const_iterator pos, InputIt first, InputIt last)
+{
+    if constexpr (detail::is_forward_iterator_v<InputIt>)
+    {
+        const auto index = static_cast<size_type>(pos - cbegin());
+        const auto count = static_cast<size_type>(std::distance(first, last));
+        if (count > max_elements - size_)
+        {
+            detail::report_error("bitvector capacity exceeded");
+        }
+        open_gap(index, count);
+        size_ = static_cast<detail::size_counter_t<max_elements> >(size_ + count);
+        for (size_type i = index; first != last; ++first, ++i)
+        {
+            if (static_cast<bool>(*first))
+            {
+                words_[i / word_bits] |= bit_mask(i);
+            }
+        }
+        return begin() + static_cast<difference_type>(index);
+    }
+    else
+    {
+        // A single-pass range has to be read before the gap for it can be opened; buffering it
+        // costs max_elements bits
+        const bitvector buffer(from_range, first, last);
+        return insert(pos, buffer.begin(), buffer.end());
+    }
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::iterator
+cesa::bitvector<max_elements>::insert(const const_iterator pos, const std::initializer_list<bool> initializer_list)
+{
+    return insert(pos, initializer_list.begin(), initializer_list.end());
+}
+
+template <std::size_t max_elements>
+template <class... Args>
+constexpr typename cesa::bitvector<max_elements>::iterator
+cesa::bitvector<max_elements>::emplace(const const_iterator pos, Args &&... args)
+{
+    return insert(pos, 1, bool(std::forward<Args>(args)...));
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::iterator
+cesa::bitvector<max_elements>::erase(const const_iterator pos)
+{
+    return erase(pos, pos + 1);
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::iterator
+cesa::bitvector<max_elements>::erase(const const_iterator first, const const_iterator last)
+{
+    const auto index = static_cast<size_type>(first - cbegin());
+    const auto count = static_cast<size_type>(last - first);
+    close_gap(index, count);
+    size_ = static_cast<detail::size_counter_t<max_elements> >(size_ - count);
+    return begin() + static_cast<difference_type>(index);
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::reference
+cesa::bitvector<max_elements>::push_back(const bool value)
+{
+    if (!try_push_back(value))
+    {
+        detail::report_error("bitvector capacity exceeded");
+    }
+    return back();
+}
+
+template <std::size_t max_elements>
+template <class... Args>
+constexpr typename cesa::bitvector<max_elements>::reference
+cesa::bitvector<max_elements>::emplace_back(Args &&... args)
+{
+    return push_back(bool(std::forward<Args>(args)...));
+}
+
+template <std::size_t max_elements>
+constexpr bool
+cesa::bitvector<max_elements>::try_push_back(const bool value) noexcept
+{
+    if (size_ >= max_elements)
+    {
+        return false;
+    }
+    if (value)
+    {
+        words_[size_ / word_bits] |= bit_mask(size_);
+    }
+    size_ += 1;
+    return true;
+}
+
+template <std::size_t max_elements>
+constexpr void
+cesa::bitvector<max_elements>::pop_back() noexcept
+{
+    if (size_ > 0)
+    {
+        size_ -= 1;
+        reset(size_);
+    }
+}
+
+template <std::size_t max_elements>
+constexpr void
+cesa::bitvector<max_elements>::resize(const size_type count, const bool value)
+{
+    if (count > max_elements)
+    {
+        detail::report_error("bitvector capacity exceeded");
+    }
+    if (count < size_)
+    {
+        reset_range(count, size_);
+    }
+    else if (value)
+    {
+        set_range(size_, count);
+    }
+    size_ = static_cast<detail::size_counter_t<max_elements> >(count);
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::word_type
+cesa::bitvector<max_elements>::bit_mask(const size_type pos) noexcept
+{
+    return word_type{1} << (pos % word_bits);
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::word_type
+cesa::bitvector<max_elements>::mask_from(const size_type index, const size_type pos) noexcept
+{
+    const size_type base = index * word_bits;
+    if (pos <= base)
+    {
+        return ~word_type{};
+    }
+    return pos - base >= word_bits ? word_type{} : ~word_type{} << (pos - base);
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::word_type
+cesa::bitvector<max_elements>::bits_at(const difference_type pos) const noexcept
+{
+    constexpr auto  bits  = static_cast<difference_type>(word_bits);
+    const auto      index = pos >= 0 ? pos / bits : -((bits - 1 - pos) / bits);
+    const auto      shift = static_cast<size_type>(pos - index * bits);
+    const auto      word  = [this](const difference_type i) {
+        return i >= 0 && i < static_cast<difference_type>(word_count_) ? words_[i] : word_type{};
+    };
+    return shift == 0 ? word(index) : (word(index) >> shift) | (word(index + 1) << (word_bits - shift));
+}
+
+template <std::size_t max_elements>
+constexpr std::strong_ordering
+cesa::bitvector<max_elements>::compare(const bitvector &other) const noexcept
+{
+    const size_type common = std::min<size_type>(size_, other.size_);
+    for (size_type i{}; i * word_bits < common; ++i)
+    {
+        const word_type differ = (words_[i] ^ other.words_[i]) & ~mask_from(i, common);
+        if (differ != 0)
+        {
+            return (words_[i] & differ & (~differ + 1)) == 0 ? std::strong_ordering::less
+                                                             : std::strong_ordering::greater;
+        }
+    }
+    return size_ <=> other.size_;
+}
+
+template <std::size_t max_elements>
+constexpr void
+cesa::bitvector<max_elements>::open_gap(const size_type index, const size_type count) noexcept
+{
+    if (count == 0 || index >= size_)
+    {
+        return;
+    }
+    // From the last word down, so that every word is read before it is overwritten
+    const size_type first_word = index / word_bits;
+    for (size_type i = (size_ + count + word_bits - 1) / word_bits; i-- > first_word;)
+    {
+        const auto      base    = static_cast<difference_type>(i * word_bits);
+        const word_type shifted = bits_at(base - static_cast<difference_type>(count));
+        words_[i] = (words_[i] & ~mask_from(i, index)) | (shifted & mask_from(i, index + count));
+    }
+}
+
+template <std::size_t max_elements>
+constexpr void
+cesa::bitvector<max_elements>::close_gap(const size_type index, const size_type count) noexcept
+{
+    if (count == 0)
+    {
+        return;
+    }
+    // From the first word up, so that every word is read before it is overwritten. The bits moved
+    // in from past size() are zero, which clears the words the elements moved out of
+    for (size_type i = index / word_bits; i < live_words(); ++i)
+    {
+        const auto      base    = static_cast<difference_type>(i * word_bits);
+        const word_type shifted = bits_at(base + static_cast<difference_type>(count));
+        words_[i] = (words_[i] & ~mask_from(i, index)) | (shifted & mask_from(i, index));
+    }
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::size_type
+cesa::bitvector<max_elements>::live_words() const noexcept
+{
+    return (size_ + word_bits - 1) / word_bits;
+}
+
+template <std::size_t max_elements>
+constexpr typename cesa::bitvector<max_elements>::size_type
+cesa::bitvector<max_elements>::find_from(const size_type pos) const noexcept
+{
+    size_type index = pos / word_bits;
+    if (index >= live_words())
+    {
+        return npos;
+    }
+    word_type word = words_[index] & (~word_type{} << (pos % word_bits));
+    while (word == 0)
+    {
+        if (++index == live_words())
+        {
+            return npos;
+        }
+        word = words_[index];
+    }
+    return index * word_bits + static_cast<size_type>(std::countr_zero(word));
+}
+
+template <std::size_t max_elements>
+template <class Op>
+constexpr void
+cesa::bitvector<max_elements>::for_each_word(const size_type first, const size_type last, Op op) noexcept
+{
+    if (first >= last)
+    {
+        return;
+    }
+    const size_type first_word = first / word_bits;
+    const size_type last_word  = (last - 1) / word_bits;
+    const word_type first_mask = ~word_type{} << (first % word_bits);
+    const word_type last_mask  = ~word_type{} >> (word_bits - 1 - (last - 1) % word_bits);
+    if (first_word == last_word)
+    {
+        op(words_[first_word], first_mask & last_mask);
+        return;
+    }
+    op(words_[first_word], first_mask);
+    for (size_type i = first_word + 1; i < last_word; ++i)
+    {
+        op(words_[i], ~word_type{});
+    }
+    op(words_[last_word], last_mask);
+}
+
+#endif
@@ -0,0 +1,373 @@
+#ifndef CESA_CONCURRENT_VECTOR_HPP
+#define CESA_CONCURRENT_VECTOR_HPP
+
+/**
+ * concurrent_vector.hpp
+ *
+ * A fixed-capacity, append-only vector that any number of threads can append to concurrently.
+ *
+ * The cesa::concurrent_vector class lets producer threads fill one batch without a mutex. An
+ * append reserves its slot with a single fetch_add on the reservation counter, constructs the
+ * element in place, and then marks the slot as published with a release store to a flag that no
+ * other thread writes. Producers therefore only contend on the counter, and never wait for each
+ * other.
+ *
+ * A consumer takes the finished prefix as a plain std::span, either with wait_until_published(),
+ * which waits for every append reserved so far, or with seal(), which additionally rejects every
+ * later append so that the span is final. Appends that do not fit, because the vector is full or
+ * sealed, still advance the reservation counter, but past max_elements or the sealed bit, so they
+ * take no slot and construct nothing: try_emplace_back() and try_push_back() return nullptr, and
+ * overflowed() tells the consumer that the batch is incomplete. The counter is clamped to
+ * max_elements wherever it is read as a size, and reset() rewinds it.
+ *
+ * An element whose constructor may throw is constructed on the appending thread's stack first and
+ * then moved into its slot, so that an exception never leaves a reserved slot empty. Such element
+ * types must be nothrow move constructible.
+ *
+ * Attention:
+ * The consumer members (seal, wait_until_published, reset) and the element accessors must not be
+ * used to read a slot that is still being appended to. wait_until_published() and seal() wait for
+ * the producers, so they must not be called by a thread that has an append in progress.
+ */
+
+#include "config.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace cesa
+{
+    template <typename T, std::size_t max_elements>
+    class concurrent_vector
+    {
+        static_assert(std::is_nothrow_destructible_v<T>, "concurrent_vector requires a nothrow destructible T");
+        static_assert(detail::check_inline_budget<sizeof(T) * max_elements>(),
+                      "concurrent_vector inline storage exceeds CESA_MAX_INLINE_BYTES");
+
+    public:
+        using value_type      = T;
+        using size_type       = std::size_t;
+        using reference       = value_type &;
+        using const_reference = const value_type &;
+        using pointer         = value_type *;
+        using const_pointer   = const value_type *;
+
+        constexpr concurrent_vector() noexcept = default;
+
+        concurrent_vector(const concurrent_vector &) = delete;
+
+        concurrent_vector &operator=(const concurrent_vector &) = delete;
+
+        ~concurrent_vector();
+
+
+        /*** Producers ***/
+
+        /**
+         * Appends an element constructed from args if there is room for it and the vector is not
+         * sealed. Returns a pointer to the new element, or nullptr if nothing was appended.
+         */
+        template <class... Args>
+        [[nodiscard]] pointer try_emplace_back(Args &&... args);
+
+        [[nodiscard]] pointer try_push_back(const value_type &value);
+
+        [[nodiscard]] pointer try_push_back(value_type &&value);
+
+        /**
+         * Like try_emplace_back(), but reports an error if nothing was appended.
+         */
+        template <class... Args>
+        reference emplace_back(Args &&... args);
+
+        reference push_back(const value_type &value);
+
+        reference push_back(value_type &&value);
+
+
+        /*** Consumer ***/
+
+        /**
+         * Waits until every append that reserved its slot before the call is published, and
+         * returns the elements up to the last of them. Appends may continue meanwhile.
+         */
+        [[nodiscard]] std::span<value_type> wait_until_published() noexcept;
+
+        /**
+         * Rejects all further appends, waits until every accepted append is published, and returns
+         * the final elements. Calling seal() again returns the same span.
+         */
+        std::span<value_type> seal() noexcept;
+
+        [[nodiscard]] bool sealed() const noexcept;
+
+        /**
+         * Whether an append failed because the vector was full.
+         */
+        [[nodiscard]] bool overflowed() const noexcept;
+
+        /**
+         * Destroys all elements and reopens a sealed vector. Must not be called while appends are
+         * in progress.
+         */
+        void reset() noexcept;
+
+
+        /*** Element access ***/
+
+        /**
+         * The element in slot pos, which must be published.
+         */
+        [[nodiscard]] reference operator[](size_type pos) noexcept;
+
+        [[nodiscard]] const_reference operator[](size_type pos) const noexcept;
+
+        /**
+         * Whether the element in slot pos has been published.
+         */
+        [[nodiscard]] bool is_published(size_type pos) const noexcept;
+
+
+        /*** Capacity ***/
+
+        /**
+         * The number of reserved slots, which includes appends that are still in progress.
+         */
+        [[nodiscard]] size_type size_approx() const noexcept;
+
+        [[nodiscard]] static constexpr size_type max_size() noexcept;
+
+    private:
+        /**
+         * Set in the reservation counter by seal(). Reservations made afterwards see a counter far
+         * above max_elements and fail.
+         */
+        static constexpr size_type sealed_bit_ = size_type{1} << (sizeof(size_type) * 8 - 1);
+
+        /**
+         * The number of slots that hold or will hold an element, given the reservation counter.
+         */
+        [[nodiscard]] static constexpr size_type reserved_slots(size_type reserved) noexcept;
+
+        /**
+         * Waits until the first count slots are published.
+         */
+        void wait_for(size_type count) const noexcept;
+
+        [[nodiscard]] value_type *slot(size_type index) noexcept;
+
+        [[nodiscard]] const value_type *slot(size_type index) const noexcept;
+
+        alignas(detail::cache_line_size) std::atomic<size_type> reserved_{};
+        std::atomic<bool>                                       overflowed_{};
+
+        alignas(detail::cache_line_size) std::atomic<bool> published_[max_elements]{};
+
+        alignas(detail::cache_line_size) alignas(value_type) std::byte storage_[sizeof(value_type) * max_elements];
+    };
+}
+
+template <typename T, std::size_t max_elements>
+cesa::concurrent_vector<T, max_elements>::~concurrent_vector()
+{
+    reset();
+}
+
+template <typename T, std::size_t max_elements>
+template <class... Args>
+typename cesa::concurrent_vector<T, max_elements>::pointer
+cesa::concurrent_vector<T, max_elements>::try_emplace_back(Args &&... args)
+{
+    if constexpr (std::is_nothrow_constructible_v<value_type, Args &&...>)
+    {
+        // A failed append leaves the counter advanced, which only moves it further past the end
+        const size_type index = reserved_.fetch_add(1, std::memory_order_relaxed);
+        if (index >= max_elements)
+        {
+            if ((index & sealed_bit_) == 0)
+            {
+                overflowed_.store(true, std::memory_order_relaxed);
+            }
+            return nullptr;
+        }
+        pointer element = std::construct_at(slot(index), std::forward<Args>(args)...);
+        published_[index].store(true, std::memory_order_release);
+        return element;
+    }
+    else
+    {
+        static_assert(std::is_nothrow_move_constructible_v<value_type>,
+                      "concurrent_vector requires a nothrow constructor or a nothrow move constructor");
+        value_type value(std::forward<Args>(args)...);
+        return try_emplace_back(std::move(value));
+    }
+}
+
+template <typename T, std::size_t max_elements>
+typename cesa::concurrent_vector<T, max_elements>::pointer
+cesa::concurrent_vector<T, max_elements>::try_push_back(const value_type &value)
+{
+    return try_emplace_back(value);
+}
+
+template <typename T, std::size_t max_elements>
+typename cesa::concurrent_vector<T, max_elements>::pointer
+cesa::concurrent_vector<T, max_elements>::try_push_back(value_type &&value)
+{
+    return try_emplace_back(std::move(value));
+}
+
+template <typename T, std::size_t max_elements>
+template <class... Args>
+typename cesa::concurrent_vector<T, max_elements>::reference
+cesa::concurrent_vector<T, max_elements>::emplace_back(Args &&... args)
+{
+    pointer element = try_emplace_back(std::forward<Args>(args)...);
+    if (element == nullptr)
+    {
+        detail::report_error(sealed() ? "concurrent_vector is sealed" : "concurrent_vector capacity exceeded");
+    }
+    return *element;
+}
+
+template <typename T, std::size_t max_elements>
+typename cesa::concurrent_vector<T, max_elements>::reference
+cesa::concurrent_vector<T, max_elements>::push_back(const value_type &value)
+{
+    return emplace_back(value);
+}
+
+template <typename T, std::size_t max_elements>
+typename cesa::concurrent_vector<T, max_elements>::reference
+cesa::concurrent_vector<T, max_elements>::push_back(value_type &&value)
+{
+    return emplace_back(std::move(value));
+}
+
+template <typename T, std::size_t max_elements>
+std::span<typename cesa::concurrent_vector<T, max_elements>::value_type>
+cesa::concurrent_vector<T, max_elements>::wait_until_published() noexcept
+{
+    const size_type count = reserved_slots(reserved_.load(std::memory_order_relaxed));
+    wait_for(count);
+    return std::span<value_type>(slot(0), count);
+}
+
+template <typename T, std::size_t max_elements>
+std::span<typename cesa::concurrent_vector<T, max_elements>::value_type>
+cesa::concurrent_vector<T, max_elements>::seal() noexcept
+{
+    const size_type count = reserved_slots(reserved_.fetch_or(sealed_bit_, std::memory_order_relaxed));
+    wait_for(count);
+    return std::span<value_type>(slot(0), count);
+}
+
+template <typename T, std::size_t max_elements>
+bool
+cesa::concurrent_vector<T, max_elements>::sealed() const noexcept
+{
+    return (reserved_.load(std::memory_order_relaxed) & sealed_bit_) != 0;
+}
+
+template <typename T, std::size_t max_elements>
+bool
+cesa::concurrent_vector<T, max_elements>::overflowed() const noexcept
+{
+    return overflowed_.load(std::memory_order_relaxed);
+}
+
+template <typename T, std::size_t max_elements>
+void
+cesa::concurrent_vector<T, max_elements>::reset() noexcept
+{
+    const size_type count = reserved_slots(reserved_.load(std::memory_order_relaxed));
+    for (size_type i{}; i < count; ++i)
+    {
+        if (published_[i].load(std::memory_order_acquire))
+        {
+            std::destroy_at(slot(i));
+            published_[i].store(false, std::memory_order_relaxed);
+        }
+    }
+    overflowed_.store(false, std::memory_order_relaxed);
+    reserved_.store(0, std::memory_order_release);
+}
+
+template <typename T, std::size_t max_elements>
+typename cesa::concurrent_vector<T, max_elements>::reference
+cesa::concurrent_vector<T, max_elements>::operator[](const size_type pos) noexcept
+{
+    return *slot(pos);
+}
+
+template <typename T, std::size_t max_elements>
+typename cesa::concurrent_vector<T, max_elements>::const_reference
+cesa::concurrent_vector<T, max_elements>::operator[](const size_type pos) const noexcept
+{
+    return *slot(pos);
+}
+
+template <typename T, std::size_t max_elements>
+bool
+cesa::concurrent_vector<T, max_elements>::is_published(const size_type pos) const noexcept
+{
+    return pos < max_elements && published_[pos].load(std::memory_order_acquire);
+}
+
+template <typename T, std::size_t max_elements>
+typename cesa::concurrent_vector<T, max_elements>::size_type
+cesa::concurrent_vector<T, max_elements>::size_approx() const noexcept
+{
+    return reserved_slots(reserved_.load(std::memory_order_relaxed));
+}
+
+template <typename T, std::size_t max_elements>
+constexpr typename cesa::concurrent_vector<T, max_elements>::size_type
+cesa::concurrent_vector<T, max_elements>::max_size() noexcept
+{
+    return max_elements;
+}
+
+template <typename T, std::size_t max_elements>
+constexpr typename cesa::concurrent_vector<T, max_elements>::size_type
+cesa::concurrent_vector<T, max_elements>::reserved_slots(const size_type reserved) noexcept
+{
+    return std::min(reserved & ~sealed_bit_, max_elements);
+}
+
+template <typename T, std::size_t max_elements>
+void
+cesa::concurrent_vector<T, max_elements>::wait_for(const size_type count) const noexcept
+{
+    for (size_type i{}; i < count; ++i)
+    {
+        while (!published_[i].load(std::memory_order_acquire))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+template <typename T, std::size_t max_elements>
+typename cesa::concurrent_vector<T, max_elements>::value_type *
+cesa::concurrent_vector<T, max_elements>::slot(const size_type index) noexcept
+{
+    return reinterpret_cast<value_type *>(&storage_[index * sizeof(value_type)]);
+}
+
+template <typename T, std::size_t max_elements>
+const typename cesa::concurrent_vector<T, max_elements>::value_type *
+cesa::concurrent_vector<T, max_elements>::slot(const size_type index) const noexcept
+{
+    return reinterpret_cast<const value_type *>(&storage_[index * sizeof(value_type)]);
+}
+
+#endif
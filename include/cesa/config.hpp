@@ -0,0 +1,164 @@
+#ifndef CESA_CONFIG_HPP
+#define CESA_CONFIG_HPP
+
+/**
+ * config.hpp
+ *
+ * Build configuration shared by the cesa containers.
+ *
+ * CESA_ERROR_POLICY selects what happens when a precondition such as the capacity limit or an
+ * at() bound is violated:
+ *  - CESA_ERROR_POLICY_THROW:  throw std::out_of_range (default when exceptions are enabled).
+ *  - CESA_ERROR_POLICY_ABORT:  print the message to stderr and call std::abort()
+ *                              (default when exceptions are disabled).
+ *  - CESA_ERROR_POLICY_ASSERT: assert in debug builds. With NDEBUG the violation is assumed to never
+ *                              happen and the check is compiled out entirely.
+ *
+ * Callers that want to handle a full vector without any of the above can use the try_* members,
+ * which report failure through their return value regardless of the policy.
+ *
+ * Define CESA_ERROR_POLICY before including any cesa header, consistently across all translation units.
+ *
+ * CESA_MAX_INLINE_BYTES sets a budget for the inline storage of a single container instantiation,
+ * e.g. 16384 to keep any one cesa::vector local well within a small thread stack. 0, the default,
+ * disables the check. CESA_INLINE_BUDGET_POLICY selects what happens when a container exceeds it:
+ *  - CESA_INLINE_BUDGET_ERROR: fail the build with a static_assert (default).
+ *  - CESA_INLINE_BUDGET_WARN:  emit a deprecation warning and build anyway.
+ *
+ * Defining CESA_FOOTPRINT_REPORT to 1 makes every container instantiation emit a deprecation
+ * warning naming its type and inline storage size, turning the build log into a footprint report:
+ * each "In instantiation of" line is followed by one mentioning "inline_bytes = N".
+ * cesa::storage_bytes_v gives the same information to code.
+ */
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <type_traits>
+
+#define CESA_ERROR_POLICY_THROW  0
+#define CESA_ERROR_POLICY_ABORT  1
+#define CESA_ERROR_POLICY_ASSERT 2
+
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#    define CESA_HAS_EXCEPTIONS 1
+#else
+#    define CESA_HAS_EXCEPTIONS 0
+#endif
+
+#ifndef CESA_ERROR_POLICY
+#    if CESA_HAS_EXCEPTIONS
+#        define CESA_ERROR_POLICY CESA_ERROR_POLICY_THROW
+#    else
+#        define CESA_ERROR_POLICY CESA_ERROR_POLICY_ABORT
+#    endif
+#endif
+
+#if CESA_ERROR_POLICY == CESA_ERROR_POLICY_THROW && !CESA_HAS_EXCEPTIONS
+#    error "CESA_ERROR_POLICY_THROW requires exceptions to be enabled"
+#endif
+
+#define CESA_INLINE_BUDGET_ERROR 0
+#define CESA_INLINE_BUDGET_WARN  1
+
+#ifndef CESA_MAX_INLINE_BYTES
+#    define CESA_MAX_INLINE_BYTES 0
+#endif
+
+#ifndef CESA_INLINE_BUDGET_POLICY
+#    define CESA_INLINE_BUDGET_POLICY CESA_INLINE_BUDGET_ERROR
+#endif
+
+#ifndef CESA_FOOTPRINT_REPORT
+#    define CESA_FOOTPRINT_REPORT 0
+#endif
+
+namespace cesa
+{
+    namespace detail
+    {
+        /**
+         * Assumed size of a cache line, used to align storage and keep data written by different
+         * threads apart. std::hardware_destructive_interference_size is not used as it may differ
+         * between translation units compiled with different flags.
+         */
+        inline constexpr std::size_t cache_line_size = 64;
+
+        /**
+         * Reports a violated precondition according to CESA_ERROR_POLICY. Never returns.
+         */
+        [[noreturn]] inline void
+        report_error(const char *message)
+        {
+#if CESA_ERROR_POLICY == CESA_ERROR_POLICY_THROW
+            throw std::out_of_range(message);
+#elif CESA_ERROR_POLICY == CESA_ERROR_POLICY_ABORT
+            std::fputs(message, stderr);
+            std::fputc('\n', stderr);
+            std::abort();
+#elif CESA_ERROR_POLICY == CESA_ERROR_POLICY_ASSERT
+#    ifndef NDEBUG
+            std::fputs(message, stderr);
+            std::fputc('\n', stderr);
+            std::abort();
+#    elif defined(_MSC_VER) && !defined(__clang__)
+            (void)message;
+            __assume(false);
+#    else
+            (void)message;
+            __builtin_unreachable();
+#    endif
+#else
+#    error "Unknown CESA_ERROR_POLICY"
+#endif
+        }
+
+        template <std::size_t inline_bytes>
+        inline constexpr bool exceeds_inline_budget_v = CESA_MAX_INLINE_BYTES != 0 &&
+                                                        inline_bytes > static_cast<std::size_t>(CESA_MAX_INLINE_BYTES);
+
+        template <std::size_t inline_bytes>
+        [[deprecated("inline storage exceeds CESA_MAX_INLINE_BYTES")]] constexpr bool
+        warn_inline_budget(std::true_type) noexcept
+        {
+            return true;
+        }
+
+        template <std::size_t inline_bytes>
+        constexpr bool
+        warn_inline_budget(std::false_type) noexcept
+        {
+            return true;
+        }
+
+        template <std::size_t inline_bytes>
+        [[deprecated("cesa footprint report (CESA_FOOTPRINT_REPORT), not an error")]] constexpr bool
+        report_footprint() noexcept
+        {
+            return true;
+        }
+
+        /**
+         * Checks the inline storage size of a container instantiation against CESA_MAX_INLINE_BYTES.
+         * Every container calls this in a static_assert in its class body.
+         */
+        template <std::size_t inline_bytes>
+        constexpr bool
+        check_inline_budget() noexcept
+        {
+#if CESA_FOOTPRINT_REPORT
+            report_footprint<inline_bytes>();
+#endif
+#if CESA_INLINE_BUDGET_POLICY == CESA_INLINE_BUDGET_WARN
+            return warn_inline_budget<inline_bytes>(std::bool_constant<exceeds_inline_budget_v<inline_bytes> >{});
+#elif CESA_INLINE_BUDGET_POLICY == CESA_INLINE_BUDGET_ERROR
+            return !exceeds_inline_budget_v<inline_bytes>;
+#else
+#    error "Unknown CESA_INLINE_BUDGET_POLICY"
+#endif
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,225 @@
+#ifndef CESA_DEBUG_HPP
+#define CESA_DEBUG_HPP
+
+/**
+ * debug.hpp
+ *
+ * Opt-in precondition checking for cesa::vector, for running tests and load tests with checks on.
+ *
+ * Defining CESA_DEBUG to 1 before including any cesa header makes cesa::vector:
+ *  - check the index of operator[], front(), back() and pop_back() against size(),
+ *  - use checked iterators instead of raw pointers. Each iterator remembers its vector and the
+ *    vector's generation, a counter bumped by every operation that changes the size or replaces
+ *    the contents. Dereferencing an iterator whose generation is outdated, or that points outside
+ *    [begin(), end()), is reported, as is passing such a position to insert(), emplace() or
+ *    erase(), or comparing iterators into different vectors.
+ *
+ * Violations are reported through detail::report_error, and therefore follow CESA_ERROR_POLICY.
+ * The generation counter implements the documented rule that any size change invalidates all
+ * iterators, so it also reports iterators that std::vector would keep valid, such as iterators
+ * before the insertion point.
+ *
+ * Without CESA_DEBUG the checks are empty and inlined away, and iterators are raw pointers.
+ * Define it consistently across all translation units, as it changes the layout of cesa::vector.
+ */
+
+#include "config.hpp"
+
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+#ifndef CESA_DEBUG
+#    define CESA_DEBUG 0
+#endif
+
+namespace cesa
+{
+    namespace detail
+    {
+        /**
+         * Reports message if condition does not hold. A no-op unless CESA_DEBUG is enabled.
+         */
+        constexpr void
+        debug_check([[maybe_unused]] const bool condition, [[maybe_unused]] const char *message)
+        {
+#if CESA_DEBUG
+            if (!condition)
+            {
+                report_error(message);
+            }
+#endif
+        }
+
+        /**
+         * The iterator of Container when CESA_DEBUG is enabled. It refers to an element by index and
+         * checks every dereference against the generation and size of the container, which must
+         * grant it access to its generation_ and size_ members and its ptr_at() member function.
+         */
+        template <typename Container, bool is_const>
+        class checked_iterator
+        {
+            using owner_type = std::conditional_t<is_const, const Container, Container>;
+
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type        = typename Container::value_type;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = std::conditional_t<is_const, const value_type &, value_type &>;
+            using pointer           = std::conditional_t<is_const, const value_type *, value_type *>;
+
+            constexpr checked_iterator() noexcept = default;
+
+            constexpr checked_iterator(owner_type *owner, const difference_type index) noexcept
+                : owner_(owner)
+                , index_(index)
+                , generation_(owner->generation_)
+            {
+            }
+
+            template <bool other_const, typename = std::enable_if_t<is_const && !other_const> >
+            constexpr checked_iterator(const checked_iterator<Container, other_const> &other) noexcept
+                : owner_(other.owner_)
+                , index_(other.index_)
+                , generation_(other.generation_)
+            {
+            }
+
+            constexpr reference
+            operator*() const
+            {
+                return *element(index_);
+            }
+
+            constexpr pointer
+            operator->() const
+            {
+                return element(index_);
+            }
+
+            constexpr reference
+            operator[](const difference_type n) const
+            {
+                return *element(index_ + n);
+            }
+
+            constexpr checked_iterator &
+            operator++() noexcept
+            {
+                ++index_;
+                return *this;
+            }
+
+            constexpr checked_iterator
+            operator++(int) noexcept
+            {
+                checked_iterator copy = *this;
+                ++index_;
+                return copy;
+            }
+
+            constexpr checked_iterator &
+            operator--() noexcept
+            {
+                --index_;
+                return *this;
+            }
+
+            constexpr checked_iterator
+            operator--(int) noexcept
+            {
+                checked_iterator copy = *this;
+                --index_;
+                return copy;
+            }
+
+            constexpr checked_iterator &
+            operator+=(const difference_type n) noexcept
+            {
+                index_ += n;
+                return *this;
+            }
+
+            constexpr checked_iterator &
+            operator-=(const difference_type n) noexcept
+            {
+                index_ -= n;
+                return *this;
+            }
+
+            friend constexpr checked_iterator
+            operator+(checked_iterator it, const difference_type n) noexcept
+            {
+                return it += n;
+            }
+
+            friend constexpr checked_iterator
+            operator+(const difference_type n, checked_iterator it) noexcept
+            {
+                return it += n;
+            }
+
+            friend constexpr checked_iterator
+            operator-(checked_iterator it, const difference_type n) noexcept
+            {
+                return it -= n;
+            }
+
+            friend constexpr difference_type
+            operator-(const checked_iterator &lhs, const checked_iterator &rhs)
+            {
+                debug_check(lhs.owner_ == rhs.owner_, "subtracting iterators into different vectors");
+                return lhs.index_ - rhs.index_;
+            }
+
+            friend constexpr bool
+            operator==(const checked_iterator &lhs, const checked_iterator &rhs)
+            {
+                debug_check(lhs.owner_ == rhs.owner_, "comparing iterators into different vectors");
+                return lhs.index_ == rhs.index_;
+            }
+
+            friend constexpr std::strong_ordering
+            operator<=>(const checked_iterator &lhs, const checked_iterator &rhs)
+            {
+                debug_check(lhs.owner_ == rhs.owner_, "comparing iterators into different vectors");
+                return lhs.index_ <=> rhs.index_;
+            }
+
+            /**
+             * The index of the position the iterator refers to in owner, reporting an iterator that
+             * belongs to another container, is outdated, or lies outside [begin(), end()].
+             */
+            [[nodiscard]] constexpr std::size_t
+            position_in(const Container *owner) const
+            {
+                debug_check(owner_ == owner, "position is not an iterator into this vector");
+                debug_check(generation_ == owner->generation_, "position is an invalidated vector iterator");
+                debug_check(index_ >= 0 && static_cast<std::size_t>(index_) <= owner->size_,
+                            "position is out of range");
+                return static_cast<std::size_t>(index_);
+            }
+
+        private:
+            template <typename, bool>
+            friend class checked_iterator;
+
+            [[nodiscard]] constexpr pointer
+            element(const difference_type index) const
+            {
+                debug_check(owner_ != nullptr, "dereferencing a singular vector iterator");
+                debug_check(generation_ == owner_->generation_, "dereferencing an invalidated vector iterator");
+                debug_check(index >= 0 && static_cast<std::size_t>(index) < owner_->size_,
+                            "dereferencing an out of range vector iterator");
+                return owner_->ptr_at(static_cast<std::size_t>(index));
+            }
+
+            owner_type     *owner_{};
+            difference_type index_{};
+            std::size_t     generation_{};
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,584 @@
+#ifndef CESA_FLAT_MAP_HPP
+#define CESA_FLAT_MAP_HPP
+
+/**
+ * flat_map.hpp
+ *
+ * A fixed-capacity sorted map stored as two parallel cesa::vectors.
+ *
+ * The cesa::flat_map class keeps its keys sorted in one cesa::vector and the mapped values at the
+ * same indices in another (structure of arrays). Lookups only scan the key array, which keeps it
+ * dense in cache regardless of the size of the mapped type, and use the same search as
+ * cesa::flat_set: a vectorizable linear count for small sets of arithmetic keys and a branchless
+ * binary search otherwise.
+ *
+ * As keys and values are stored apart there are no std::pair elements to iterate over. Instead,
+ * keys() and values() return spans over the two arrays, and key_at()/value_at() access a single
+ * index. Lookups return a pointer to the mapped value, or nullptr if the key is missing.
+ *
+ * The mapped values of a flat_map<Key, bool, N> are stored as one bool each rather than in the
+ * bit-packed cesa::vector<bool, N>, so that lookups can return pointers and values() a span.
+ *
+ * Attention:
+ * Pointer and Index Invalidation:
+ * Any insertion or erasure invalidates pointers and indices at or after the affected position.
+ */
+
+#include "config.hpp"
+#include "flat_set.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace cesa
+{
+    namespace detail
+    {
+        /**
+         * Unpacked storage for the bool values of a flat_map, with the part of the cesa::vector
+         * interface that flat_map uses. flat_map checks the capacity before inserting.
+         */
+        template <std::size_t max_elements>
+        class flat_bool_values
+        {
+        public:
+            using iterator       = bool *;
+            using const_iterator = const bool *;
+
+            [[nodiscard]] constexpr bool *
+            data() noexcept
+            {
+                return values_;
+            }
+
+            [[nodiscard]] constexpr const bool *
+            data() const noexcept
+            {
+                return values_;
+            }
+
+            [[nodiscard]] constexpr iterator
+            begin() noexcept
+            {
+                return values_;
+            }
+
+            [[nodiscard]] constexpr iterator
+            end() noexcept
+            {
+                return values_ + size_;
+            }
+
+            [[nodiscard]] constexpr std::size_t
+            size() const noexcept
+            {
+                return size_;
+            }
+
+            [[nodiscard]] constexpr bool &
+            operator[](const std::size_t index) noexcept
+            {
+                return values_[index];
+            }
+
+            [[nodiscard]] constexpr const bool &
+            operator[](const std::size_t index) const noexcept
+            {
+                return values_[index];
+            }
+
+            constexpr void
+            clear() noexcept
+            {
+                size_ = 0;
+            }
+
+            template <class... Args>
+            constexpr iterator
+            emplace(const iterator pos, Args &&... args)
+            {
+                const bool value(std::forward<Args>(args)...);
+                std::copy_backward(pos, end(), end() + 1);
+                *pos = value;
+                ++size_;
+                return pos;
+            }
+
+            constexpr iterator
+            insert(const iterator pos, const std::size_t count, const bool value)
+            {
+                std::copy_backward(pos, end(), end() + count);
+                std::fill_n(pos, count, value);
+                size_ += count;
+                return pos;
+            }
+
+            constexpr iterator
+            erase(const iterator pos) noexcept
+            {
+                std::copy(pos + 1, end(), pos);
+                --size_;
+                return pos;
+            }
+
+        private:
+            bool        values_[max_elements]{};
+            std::size_t size_{};
+        };
+
+        template <typename T, std::size_t max_elements>
+        struct flat_map_values
+        {
+            using type = vector<T, max_elements>;
+        };
+
+        template <std::size_t max_elements>
+        struct flat_map_values<bool, max_elements>
+        {
+            using type = flat_bool_values<max_elements>;
+        };
+    }
+
+    template <typename Key, typename T, std::size_t max_elements, typename Compare = std::less<Key> >
+    class flat_map
+    {
+    public:
+        using key_type    = Key;
+        using mapped_type = T;
+        using value_type  = std::pair<Key, T>;
+        using key_compare = Compare;
+        using size_type   = std::size_t;
+
+        static constexpr size_type npos = static_cast<size_type>(-1);
+
+        constexpr flat_map() = default;
+
+        explicit constexpr flat_map(const Compare &comp);
+
+
+        /*** Element access ***/
+
+        [[nodiscard]] constexpr mapped_type &at(const key_type &key);
+
+        [[nodiscard]] constexpr const mapped_type &at(const key_type &key) const;
+
+        constexpr mapped_type &operator[](const key_type &key);
+
+        [[nodiscard]] constexpr const key_type &key_at(size_type index) const;
+
+        [[nodiscard]] constexpr mapped_type &value_at(size_type index);
+
+        [[nodiscard]] constexpr const mapped_type &value_at(size_type index) const;
+
+        [[nodiscard]] constexpr std::span<const key_type> keys() const noexcept;
+
+        [[nodiscard]] constexpr std::span<mapped_type> values() noexcept;
+
+        [[nodiscard]] constexpr std::span<const mapped_type> values() const noexcept;
+
+
+        /*** Capacity ***/
+
+        [[nodiscard]] constexpr bool empty() const noexcept;
+
+        [[nodiscard]] constexpr size_type size() const noexcept;
+
+        [[nodiscard]] constexpr size_type max_size() const noexcept;
+
+
+        /*** Modifiers ***/
+
+        constexpr void clear() noexcept;
+
+        /**
+         * Inserts the mapped value constructed from args if key is not present.
+         * Returns a pointer to the mapped value for key, and whether it was inserted.
+         */
+        template <class... Args>
+        constexpr std::pair<mapped_type *, bool> try_emplace(const key_type &key, Args &&... args);
+
+        constexpr std::pair<mapped_type *, bool> insert(const value_type &value);
+
+        template <class M>
+        constexpr std::pair<mapped_type *, bool> insert_or_assign(const key_type &key, M &&obj);
+
+        /**
+         * Inserts the key/value pairs of the range [first, last), sorted by key, whose keys are not
+         * already present, with a single backwards merge into the unused capacity. Runs in O(n + k).
+         * If a key or value operation throws during the merge, the map is left empty.
+         */
+        template <class InputIt, typename = std::enable_if_t<std::is_base_of_v<
+                      std::input_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category> > >
+        constexpr void insert_sorted(InputIt first, InputIt last);
+
+        constexpr void erase_at(size_type index);
+
+        constexpr size_type erase(const key_type &key);
+
+
+        /*** Lookup ***/
+
+        [[nodiscard]] constexpr size_type index_of(const key_type &key) const;
+
+        [[nodiscard]] constexpr mapped_type *find(const key_type &key);
+
+        [[nodiscard]] constexpr const mapped_type *find(const key_type &key) const;
+
+        [[nodiscard]] constexpr bool contains(const key_type &key) const;
+
+        [[nodiscard]] constexpr size_type count(const key_type &key) const;
+
+        [[nodiscard]] constexpr size_type lower_bound_index(const key_type &key) const;
+
+
+        /*** Observers ***/
+
+        [[nodiscard]] constexpr key_compare key_comp() const;
+
+    private:
+        vector<key_type, max_elements>                                    keys_;
+        typename detail::flat_map_values<mapped_type, max_elements>::type values_;
+        [[no_unique_address]] Compare                                     comp_{};
+
+        /**
+         * The merge of insert_sorted: the added slots past old_size are constructed, and are filled
+         * from the back with the existing pairs and the new pairs of [first, last).
+         */
+        template <class BidirIt>
+        constexpr void merge_backwards(BidirIt first, BidirIt last, size_type old_size, size_type added);
+    };
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+constexpr
+cesa::flat_map<Key, T, max_elements, Compare>::flat_map(const Compare &comp)
+    : comp_(comp)
+{
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+constexpr typename cesa::flat_map<Key, T, max_elements, Compare>::mapped_type &
+cesa::flat_map<Key, T, max_elements, Compare>::at(const key_type &key)
+{
+    mapped_type *value = find(key);
+    if (value == nullptr)
+    {
+        detail::report_error("flat_map key not found");
+    }
+    return *value;
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+constexpr const typename cesa::flat_map<Key, T, max_elements, Compare>::mapped_type &
+cesa::flat_map<Key, T, max_elements, Compare>::at(const key_type &key) const
+{
+    const mapped_type *value = find(key);
+    if (value == nullptr)
+    {
+        detail::report_error("flat_map key not found");
+    }
+    return *value;
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+constexpr typename cesa::flat_map<Key, T, max_elements, Compare>::mapped_type &
+cesa::flat_map<Key, T, max_elements, Compare>::operator[](const key_type &key)
+{
+    return *try_emplace(key).first;
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+constexpr const typename cesa::flat_map<Key, T, max_elements, Compare>::key_type &
+cesa::flat_map<Key, T, max_elements, Compare>::key_at(const size_type index) const
+{
+    return keys_[index];
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+constexpr typename cesa::flat_map<Key, T, max_elements, Compare>::mapped_type &
+cesa::flat_map<Key, T, max_elements, Compare>::value_at(const size_type index)
+{
+    return values_[index];
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+constexpr const typename cesa::flat_map<Key, T, max_elements, Compare>::mapped_type &
+cesa::flat_map<Key, T, max_elements, Compare>::value_at(const size_type index) const
+{
+    return values_[index];
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+constexpr std::span<const typename cesa::flat_map<Key, T, max_elements, Compare>::key_type>
+cesa::flat_map<Key, T, max_elements, Compare>::keys() const noexcept
+{
+    return { keys_.data(), keys_.size() };
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+constexpr std::span<typename cesa::flat_map<Key, T, max_elements, Compare>::mapped_type>
+cesa::flat_map<Key, T, max_elements, Compare>::values() noexcept
+{
+    return { values_.data(), values_.size() };
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+constexpr std::span<const typename cesa::flat_map<Key, T, max_elements, Compare>::mapped_type>
+cesa::flat_map<Key, T, max_elements, Compare>::values() const noexcept
+{
+    return { values_.data(), values_.size() };
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+constexpr bool
+cesa::flat_map<Key, T, max_elements, Compare>::empty() const noexcept
+{
+    return keys_.empty();
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+constexpr typename cesa::flat_map<Key, T, max_elements, Compare>::size_type
+cesa::flat_map<Key, T, max_elements, Compare>::size() const noexcept
+{
+    return keys_.size();
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+constexpr typename cesa::flat_map<Key, T, max_elements, Compare>::size_type
+cesa::flat_map<Key, T, max_elements, Compare>::max_size() const noexcept
+{
+    return max_elements;
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+constexpr void
+cesa::flat_map<Key, T, max_elements, Compare>::clear() noexcept
+{
+    keys_.clear();
+    values_.clear();
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+template <class... Args>
+constexpr std::pair<typename cesa::flat_map<Key, T, max_elements, Compare>::mapped_type *, bool>
+cesa::flat_map<Key, T, max_elements, Compare>::try_emplace(const key_type &key, Args &&... args)
+{
+    const size_type index = lower_bound_index(key);
+    if (index < keys_.size() && !comp_(key, keys_[index]))
+    {
+        return { &values_[index], false };
+    }
+    if (keys_.size() >= max_elements)
+    {
+        detail::report_error("flat_map capacity exceeded");
+    }
+    keys_.emplace(keys_.begin() + index, key);
+#if CESA_HAS_EXCEPTIONS
+    try
+    {
+        values_.emplace(values_.begin() + index, std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        keys_.erase(keys_.begin() + index);
+        throw;
+    }
+#else
+    values_.emplace(values_.begin() + index, std::forward<Args>(args)...);
+#endif
+    return { &values_[index], true };
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+constexpr std::pair<typename cesa::flat_map<Key, T, max_elements, Compare>::mapped_type *, bool>
+cesa::flat_map<Key, T, max_elements, Compare>::insert(const value_type &value)
+{
+    return try_emplace(value.first, value.second);
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+template <class M>
+constexpr std::pair<typename cesa::flat_map<Key, T, max_elements, Compare>::mapped_type *, bool>
+cesa::flat_map<Key, T, max_elements, Compare>::insert_or_assign(const key_type &key, M &&obj)
+{
+    const size_type index = lower_bound_index(key);
+    if (index < keys_.size() && !comp_(key, keys_[index]))
+    {
+        values_[index] = std::forward<M>(obj);
+        return { &values_[index], false };
+    }
+    return try_emplace(key, std::forward<M>(obj));
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+template <class InputIt, typename>
+constexpr void
+cesa::flat_map<Key, T, max_elements, Compare>::insert_sorted(InputIt first, InputIt last)
+{
+    if constexpr (!std::is_base_of_v<std::bidirectional_iterator_tag,
+                                     typename std::iterator_traits<InputIt>::iterator_category>)
+    {
+        // The merge walks the input backwards, so buffer single-pass and forward ranges first
+        const vector<value_type, max_elements> buffer(from_range, first, last);
+        insert_sorted(buffer.begin(), buffer.end());
+    }
+    else
+    {
+        const auto key_of = [](const auto &pair) -> const key_type & { return pair.first; };
+        const size_type old_size = keys_.size();
+        const size_type added = detail::flat_count_new_keys(keys_.data(), old_size, first, last, key_of, comp_);
+        if (added == 0)
+        {
+            return;
+        }
+        if (added > max_elements - old_size)
+        {
+            detail::report_error("flat_map capacity exceeded");
+        }
+        // Construct the new tail slots up front, then fill every slot by assignment from the back
+        keys_.insert(keys_.end(), added, first->first);
+#if CESA_HAS_EXCEPTIONS
+        try
+        {
+            values_.insert(values_.end(), added, first->second);
+            merge_backwards(first, last, old_size, added);
+        }
+        catch (...)
+        {
+            // An exception in the merge leaves the keys out of order, so restore the invariants by
+            // clearing, as std::flat_map does. If the tail slots could not be constructed, nothing
+            // has been moved yet and only the new keys are removed.
+            if (values_.size() == keys_.size())
+            {
+                clear();
+            }
+            else
+            {
+                keys_.erase(keys_.begin() + old_size, keys_.end());
+            }
+            throw;
+        }
+#else
+        values_.insert(values_.end(), added, first->second);
+        merge_backwards(first, last, old_size, added);
+#endif
+    }
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+template <class BidirIt>
+constexpr void
+cesa::flat_map<Key, T, max_elements, Compare>::merge_backwards(BidirIt first, BidirIt last, const size_type old_size,
+                                                               const size_type added)
+{
+    size_type old_index = old_size;
+    size_type write     = old_size + added;
+    while (first != last && write != old_index)
+    {
+        auto input = std::prev(last);
+        if (input != first && !comp_(std::prev(input)->first, input->first))
+        {
+            // Only the first of a run of equal input keys is inserted
+            last = input;
+        }
+        else if (old_index > 0 && comp_(input->first, keys_[old_index - 1]))
+        {
+            --write;
+            --old_index;
+            keys_[write]   = std::move(keys_[old_index]);
+            values_[write] = std::move(values_[old_index]);
+        }
+        else if (old_index > 0 && !comp_(keys_[old_index - 1], input->first))
+        {
+            last = input;
+        }
+        else
+        {
+            --write;
+            keys_[write]   = input->first;
+            values_[write] = input->second;
+            last           = input;
+        }
+    }
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+constexpr void
+cesa::flat_map<Key, T, max_elements, Compare>::erase_at(const size_type index)
+{
+    keys_.erase(keys_.begin() + index);
+    values_.erase(values_.begin() + index);
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+constexpr typename cesa::flat_map<Key, T, max_elements, Compare>::size_type
+cesa::flat_map<Key, T, max_elements, Compare>::erase(const key_type &key)
+{
+    const size_type index = index_of(key);
+    if (index == npos)
+    {
+        return 0;
+    }
+    erase_at(index);
+    return 1;
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+constexpr typename cesa::flat_map<Key, T, max_elements, Compare>::size_type
+cesa::flat_map<Key, T, max_elements, Compare>::index_of(const key_type &key) const
+{
+    const size_type index = lower_bound_index(key);
+    return index < keys_.size() && !comp_(key, keys_[index]) ? index : npos;
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+constexpr typename cesa::flat_map<Key, T, max_elements, Compare>::mapped_type *
+cesa::flat_map<Key, T, max_elements, Compare>::find(const key_type &key)
+{
+    const size_type index = index_of(key);
+    return index == npos ? nullptr : &values_[index];
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+constexpr const typename cesa::flat_map<Key, T, max_elements, Compare>::mapped_type *
+cesa::flat_map<Key, T, max_elements, Compare>::find(const key_type &key) const
+{
+    const size_type index = index_of(key);
+    return index == npos ? nullptr : &values_[index];
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+constexpr bool
+cesa::flat_map<Key, T, max_elements, Compare>::contains(const key_type &key) const
+{
+    return index_of(key) != npos;
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+constexpr typename cesa::flat_map<Key, T, max_elements, Compare>::size_type
+cesa::flat_map<Key, T, max_elements, Compare>::count(const key_type &key) const
+{
+    return contains(key) ? 1 : 0;
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+constexpr typename cesa::flat_map<Key, T, max_elements, Compare>::size_type
+cesa::flat_map<Key, T, max_elements, Compare>::lower_bound_index(const key_type &key) const
+{
+    return detail::flat_lower_bound<max_elements>(keys_.data(), keys_.size(), key, comp_);
+}
+
+template <typename Key, typename T, std::size_t max_elements, typename Compare>
+constexpr typename cesa::flat_map<Key, T, max_elements, Compare>::key_compare
+cesa::flat_map<Key, T, max_elements, Compare>::key_comp() const
+{
+    return comp_;
+}
+
+#endif
@@ -0,0 +1,495 @@
+#ifndef CESA_FLAT_SET_HPP
+#define CESA_FLAT_SET_HPP
+
+/**
+ * flat_set.hpp
+ *
+ * A fixed-capacity sorted set stored contiguously in a cesa::vector.
+ *
+ * The cesa::flat_set class keeps its keys sorted in a single cesa::vector, so lookups scan a
+ * contiguous array and never chase node pointers or allocate. For small sets of arithmetic keys the
+ * lookup is a branch-free linear count that compilers vectorize, and otherwise it is a branchless
+ * binary search.
+ *
+ * Insertion and erasure of a single key are O(n) because of the shift. To add many keys at once,
+ * insert_sorted() merges a sorted range in O(n + k).
+ *
+ * Attention:
+ * Iterator Invalidation:
+ * Follows the rules of cesa::vector: any insertion or erasure invalidates iterators at or after the
+ * affected position.
+ */
+
+#include "config.hpp"
+#include "vector.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace cesa
+{
+    namespace detail
+    {
+        /**
+         * Capacity up to which arithmetic keys are looked up with a linear scan instead of a
+         * binary search.
+         */
+        inline constexpr std::size_t flat_linear_search_limit = 64;
+
+        template <typename Key, typename Compare>
+        inline constexpr bool is_plain_less_v = std::is_same_v<Compare, std::less<Key> > ||
+                                                std::is_same_v<Compare, std::less<> >;
+
+        /**
+         * Returns the index of the first key in the sorted range [keys, keys + size) that does not
+         * compare less than key.
+         */
+        template <std::size_t max_elements, typename Key, typename Compare>
+        constexpr std::size_t
+        flat_lower_bound(const Key *keys, const std::size_t size, const Key &key, const Compare &comp)
+        {
+            if constexpr (std::is_arithmetic_v<Key> && is_plain_less_v<Key, Compare> &&
+                          max_elements <= flat_linear_search_limit)
+            {
+                // In a sorted range the number of smaller keys is the lower bound. Counting them
+                // has no data-dependent branches, so the loop vectorizes.
+                std::size_t index{};
+                for (std::size_t i{}; i < size; ++i)
+                {
+                    index += static_cast<std::size_t>(keys[i] < key);
+                }
+                return index;
+            }
+            else
+            {
+                if (size == 0)
+                {
+                    return 0;
+                }
+                const Key  *base   = keys;
+                std::size_t length = size;
+                while (length > 1)
+                {
+                    const std::size_t half = length / 2;
+                    base                   = comp(base[half], key) ? base + half : base;
+                    length -= half;
+                }
+                return static_cast<std::size_t>(base - keys) + static_cast<std::size_t>(comp(*base, key));
+            }
+        }
+
+        /**
+         * Counts the keys of the sorted range [first, last) that are neither in the sorted range
+         * [keys, keys + size) nor equal to the preceding key of [first, last).
+         */
+        template <typename Key, typename ForwardIt, typename Projection, typename Compare>
+        constexpr std::size_t
+        flat_count_new_keys(const Key *keys, const std::size_t size, ForwardIt first, const ForwardIt last,
+                            const Projection &proj, const Compare &comp)
+        {
+            std::size_t count{};
+            std::size_t i{};
+            const Key  *previous = nullptr;
+            for (; first != last; ++first)
+            {
+                const Key &key = proj(*first);
+                if (previous != nullptr && !comp(*previous, key))
+                {
+                    continue;
+                }
+                previous = &key;
+                while (i < size && comp(keys[i], key))
+                {
+                    ++i;
+                }
+                if (i == size || comp(key, keys[i]))
+                {
+                    ++count;
+                }
+            }
+            return count;
+        }
+    }
+
+    template <typename Key, std::size_t max_elements, typename Compare = std::less<Key> >
+    class flat_set
+    {
+    public:
+        using key_type               = Key;
+        using value_type             = Key;
+        using key_compare            = Compare;
+        using value_compare          = Compare;
+        using size_type              = std::size_t;
+        using difference_type        = std::ptrdiff_t;
+        using const_reference        = const value_type &;
+        using const_pointer          = const value_type *;
+        using iterator               = const value_type *;
+        using const_iterator         = const value_type *;
+        using reverse_iterator       = std::reverse_iterator<const_iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        constexpr flat_set() = default;
+
+        explicit constexpr flat_set(const Compare &comp);
+
+
+        /*** Iterators ***/
+
+        [[nodiscard]] constexpr const_iterator begin() const noexcept;
+
+        [[nodiscard]] constexpr const_iterator cbegin() const noexcept;
+
+        [[nodiscard]] constexpr const_iterator end() const noexcept;
+
+        [[nodiscard]] constexpr const_iterator cend() const noexcept;
+
+        [[nodiscard]] constexpr const_reverse_iterator rbegin() const noexcept;
+
+        [[nodiscard]] constexpr const_reverse_iterator rend() const noexcept;
+
+        [[nodiscard]] constexpr const value_type *data() const noexcept;
+
+
+        /*** Capacity ***/
+
+        [[nodiscard]] constexpr bool empty() const noexcept;
+
+        [[nodiscard]] constexpr size_type size() const noexcept;
+
+        [[nodiscard]] constexpr size_type max_size() const noexcept;
+
+
+        /*** Modifiers ***/
+
+        constexpr void clear() noexcept;
+
+        constexpr std::pair<iterator, bool> insert(const value_type &key);
+
+        constexpr std::pair<iterator, bool> insert(value_type &&key);
+
+        /**
+         * Inserts the keys of the sorted range [first, last) that are not already present, with a
+         * single backwards merge into the unused capacity. Runs in O(n + k). If a key operation
+         * throws during the merge, the set is left empty.
+         */
+        template <class InputIt, typename = std::enable_if_t<std::is_base_of_v<
+                      std::input_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category> > >
+        constexpr void insert_sorted(InputIt first, InputIt last);
+
+        constexpr iterator erase(const_iterator pos);
+
+        constexpr size_type erase(const key_type &key);
+
+
+        /*** Lookup ***/
+
+        [[nodiscard]] constexpr const_iterator find(const key_type &key) const;
+
+        [[nodiscard]] constexpr bool contains(const key_type &key) const;
+
+        [[nodiscard]] constexpr size_type count(const key_type &key) const;
+
+        [[nodiscard]] constexpr const_iterator lower_bound(const key_type &key) const;
+
+        [[nodiscard]] constexpr const_iterator upper_bound(const key_type &key) const;
+
+
+        /*** Observers ***/
+
+        [[nodiscard]] constexpr key_compare key_comp() const;
+
+    private:
+        vector<key_type, max_elements> keys_;
+        [[no_unique_address]] Compare  comp_{};
+
+        [[nodiscard]] constexpr size_type index_of_lower_bound(const key_type &key) const;
+
+        template <typename K>
+        constexpr std::pair<iterator, bool> insert_key(K &&key);
+
+        /**
+         * The merge of insert_sorted: the added slots past old_size are constructed, and are filled
+         * from the back with the existing keys and the new keys of [first, last).
+         */
+        template <class BidirIt>
+        constexpr void merge_backwards(BidirIt first, BidirIt last, size_type old_size, size_type added);
+    };
+
+    template <typename Key, std::size_t SizeA, std::size_t SizeB, typename Compare>
+    constexpr bool
+    operator==(const flat_set<Key, SizeA, Compare> &lhs, const flat_set<Key, SizeB, Compare> &rhs)
+    {
+        return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+}
+
+template <typename Key, std::size_t max_elements, typename Compare>
+constexpr
+cesa::flat_set<Key, max_elements, Compare>::flat_set(const Compare &comp)
+    : comp_(comp)
+{
+}
+
+template <typename Key, std::size_t max_elements, typename Compare>
+constexpr typename cesa::flat_set<Key, max_elements, Compare>::const_iterator
+cesa::flat_set<Key, max_elements, Compare>::begin() const noexcept
+{
+    return keys_.data();
+}
+
+template <typename Key, std::size_t max_elements, typename Compare>
+constexpr typename cesa::flat_set<Key, max_elements, Compare>::const_iterator
+cesa::flat_set<Key, max_elements, Compare>::cbegin() const noexcept
+{
+    return keys_.data();
+}
+
+template <typename Key, std::size_t max_elements, typename Compare>
+constexpr typename cesa::flat_set<Key, max_elements, Compare>::const_iterator
+cesa::flat_set<Key, max_elements, Compare>::end() const noexcept
+{
+    return keys_.data() + keys_.size();
+}
+
+template <typename Key, std::size_t max_elements, typename Compare>
+constexpr typename cesa::flat_set<Key, max_elements, Compare>::const_iterator
+cesa::flat_set<Key, max_elements, Compare>::cend() const noexcept
+{
+    return keys_.data() + keys_.size();
+}
+
+template <typename Key, std::size_t max_elements, typename Compare>
+constexpr typename cesa::flat_set<Key, max_elements, Compare>::const_reverse_iterator
+cesa::flat_set<Key, max_elements, Compare>::rbegin() const noexcept
+{
+    return const_reverse_iterator(end());
+}
+
+template <typename Key, std::size_t max_elements, typename Compare>
+constexpr typename cesa::flat_set<Key, max_elements, Compare>::const_reverse_iterator
+cesa::flat_set<Key, max_elements, Compare>::rend() const noexcept
+{
+    return const_reverse_iterator(begin());
+}
+
+template <typename Key, std::size_t max_elements, typename Compare>
+constexpr const typename cesa::flat_set<Key, max_elements, Compare>::value_type *
+cesa::flat_set<Key, max_elements, Compare>::data() const noexcept
+{
+    return keys_.data();
+}
+
+template <typename Key, std::size_t max_elements, typename Compare>
+constexpr bool
+cesa::flat_set<Key, max_elements, Compare>::empty() const noexcept
+{
+    return keys_.empty();
+}
+
+template <typename Key, std::size_t max_elements, typename Compare>
+constexpr typename cesa::flat_set<Key, max_elements, Compare>::size_type
+cesa::flat_set<Key, max_elements, Compare>::size() const noexcept
+{
+    return keys_.size();
+}
+
+template <typename Key, std::size_t max_elements, typename Compare>
+constexpr typename cesa::flat_set<Key, max_elements, Compare>::size_type
+cesa::flat_set<Key, max_elements, Compare>::max_size() const noexcept
+{
+    return max_elements;
+}
+
+template <typename Key, std::size_t max_elements, typename Compare>
+constexpr void
+cesa::flat_set<Key, max_elements, Compare>::clear() noexcept
+{
+    keys_.clear();
+}
+
+template <typename Key, std::size_t max_elements, typename Compare>
+constexpr std::pair<typename cesa::flat_set<Key, max_elements, Compare>::iterator, bool>
+cesa::flat_set<Key, max_elements, Compare>::insert(const value_type &key)
+{
+    return insert_key(key);
+}
+
+template <typename Key, std::size_t max_elements, typename Compare>
+constexpr std::pair<typename cesa::flat_set<Key, max_elements, Compare>::iterator, bool>
+cesa::flat_set<Key, max_elements, Compare>::insert(value_type &&key)
+{
+    return insert_key(std::move(key));
+}
+
+template <typename Key, std::size_t max_elements, typename Compare>
+template <class InputIt, typename>
+constexpr void
+cesa::flat_set<Key, max_elements, Compare>::insert_sorted(InputIt first, InputIt last)
+{
+    if constexpr (!std::is_base_of_v<std::bidirectional_iterator_tag,
+                                     typename std::iterator_traits<InputIt>::iterator_category>)
+    {
+        // The merge walks the input backwards, so buffer single-pass and forward ranges first
+        const vector<key_type, max_elements> buffer(from_range, first, last);
+        insert_sorted(buffer.begin(), buffer.end());
+    }
+    else
+    {
+        const auto      identity = [](const key_type &key) -> const key_type & { return key; };
+        const size_type old_size = keys_.size();
+        const size_type added = detail::flat_count_new_keys(keys_.data(), old_size, first, last, identity, comp_);
+        if (added == 0)
+        {
+            return;
+        }
+        if (added > max_elements - old_size)
+        {
+            detail::report_error("flat_set capacity exceeded");
+        }
+        // Construct the new tail slots up front, then fill every slot by assignment from the back
+        keys_.insert(keys_.end(), added, *first);
+#if CESA_HAS_EXCEPTIONS
+        try
+        {
+            merge_backwards(first, last, old_size, added);
+        }
+        catch (...)
+        {
+            // An exception in the merge leaves the keys out of order, so restore the invariants by
+            // clearing, as std::flat_set does
+            clear();
+            throw;
+        }
+#else
+        merge_backwards(first, last, old_size, added);
+#endif
+    }
+}
+
+template <typename Key, std::size_t max_elements, typename Compare>
+template <class BidirIt>
+constexpr void
+cesa::flat_set<Key, max_elements, Compare>::merge_backwards(BidirIt first, BidirIt last, const size_type old_size,
+                                                           const size_type added)
+{
+    size_type old_index = old_size;
+    size_type write     = old_size + added;
+    while (first != last && write != old_index)
+    {
+        auto input = std::prev(last);
+        if (input != first && !comp_(*std::prev(input), *input))
+        {
+            // Only the first of a run of equal input keys is inserted
+            last = input;
+        }
+        else if (old_index > 0 && comp_(*input, keys_[old_index - 1]))
+        {
+            keys_[--write] = std::move(keys_[--old_index]);
+        }
+        else if (old_index > 0 && !comp_(keys_[old_index - 1], *input))
+        {
+            last = input;
+        }
+        else
+        {
+            keys_[--write] = *input;
+            last           = input;
+        }
+    }
+}
+
+template <typename Key, std::size_t max_elements, typename Compare>
+constexpr typename cesa::flat_set<Key, max_elements, Compare>::iterator
+cesa::flat_set<Key, max_elements, Compare>::erase(const_iterator pos)
+{
+    const auto index = pos - begin();
+    keys_.erase(keys_.begin() + index);
+    return begin() + index;
+}
+
+template <typename Key, std::size_t max_elements, typename Compare>
+constexpr typename cesa::flat_set<Key, max_elements, Compare>::size_type
+cesa::flat_set<Key, max_elements, Compare>::erase(const key_type &key)
+{
+    const const_iterator it = find(key);
+    if (it == end())
+    {
+        return 0;
+    }
+    erase(it);
+    return 1;
+}
+
+template <typename Key, std::size_t max_elements, typename Compare>
+constexpr typename cesa::flat_set<Key, max_elements, Compare>::const_iterator
+cesa::flat_set<Key, max_elements, Compare>::find(const key_type &key) const
+{
+    const size_type index = index_of_lower_bound(key);
+    if (index < keys_.size() && !comp_(key, keys_[index]))
+    {
+        return begin() + index;
+    }
+    return end();
+}
+
+template <typename Key, std::size_t max_elements, typename Compare>
+constexpr bool
+cesa::flat_set<Key, max_elements, Compare>::contains(const key_type &key) const
+{
+    return find(key) != end();
+}
+
+template <typename Key, std::size_t max_elements, typename Compare>
+constexpr typename cesa::flat_set<Key, max_elements, Compare>::size_type
+cesa::flat_set<Key, max_elements, Compare>::count(const key_type &key) const
+{
+    return contains(key) ? 1 : 0;
+}
+
+template <typename Key, std::size_t max_elements, typename Compare>
+constexpr typename cesa::flat_set<Key, max_elements, Compare>::const_iterator
+cesa::flat_set<Key, max_elements, Compare>::lower_bound(const key_type &key) const
+{
+    return begin() + index_of_lower_bound(key);
+}
+
+template <typename Key, std::size_t max_elements, typename Compare>
+constexpr typename cesa::flat_set<Key, max_elements, Compare>::const_iterator
+cesa::flat_set<Key, max_elements, Compare>::upper_bound(const key_type &key) const
+{
+    const const_iterator it = lower_bound(key);
+    return it != end() && !comp_(key, *it) ? it + 1 : it;
+}
+
+template <typename Key, std::size_t max_elements, typename Compare>
+constexpr typename cesa::flat_set<Key, max_elements, Compare>::key_compare
+cesa::flat_set<Key, max_elements, Compare>::key_comp() const
+{
+    return comp_;
+}
+
+template <typename Key, std::size_t max_elements, typename Compare>
+constexpr typename cesa::flat_set<Key, max_elements, Compare>::size_type
+cesa::flat_set<Key, max_elements, Compare>::index_of_lower_bound(const key_type &key) const
+{
+    return detail::flat_lower_bound<max_elements>(keys_.data(), keys_.size(), key, comp_);
+}
+
+template <typename Key, std::size_t max_elements, typename Compare>
+template <typename K>
+constexpr std::pair<typename cesa::flat_set<Key, max_elements, Compare>::iterator, bool>
+cesa::flat_set<Key, max_elements, Compare>::insert_key(K &&key)
+{
+    const size_type index = index_of_lower_bound(key);
+    if (index < keys_.size() && !comp_(key, keys_[index]))
+    {
+        return { begin() + index, false };
+    }
+    keys_.emplace(keys_.begin() + index, std::forward<K>(key));
+    return { begin() + index, true };
+}
+
+#endif
@@ -0,0 +1,305 @@
+#ifndef CESA_INSTRUMENTATION_HPP
+#define CESA_INSTRUMENTATION_HPP
+
+/**
+ * instrumentation.hpp
+ *
+ * Opt-in usage statistics for cesa::vector, for right-sizing capacities from production data.
+ *
+ * Defining CESA_INSTRUMENTATION to 1 before including any cesa header makes every cesa::vector
+ * instantiation record, across all of its instances:
+ *  - the high-water mark, the largest size any instance reached,
+ *  - the number of elements inserted and erased,
+ *  - the number of existing elements shifted to open or close a gap in the middle,
+ *  - the number of insertions rejected because the vector was full.
+ *
+ * Each instantiation registers its statistics with cesa::instrumentation_registry the first time
+ * it records something. cesa::instrumentation_registry::instance().dump() prints them all, one
+ * line per element type and capacity, the most recently registered first. The counters are
+ * relaxed atomics, so vectors used from many threads are counted correctly, at the price of an
+ * atomic operation per modification.
+ *
+ * Without CESA_INSTRUMENTATION the hooks are empty and inlined away, and no statistics are
+ * registered. Define it consistently across all translation units.
+ */
+
+#include "config.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <string_view>
+#include <type_traits>
+
+#ifndef CESA_INSTRUMENTATION
+#    define CESA_INSTRUMENTATION 0
+#endif
+
+namespace cesa
+{
+    /**
+     * The statistics of one cesa::vector instantiation.
+     */
+    class vector_stats
+    {
+    public:
+        vector_stats(std::string_view type_name, std::size_t capacity) noexcept;
+
+        vector_stats(const vector_stats &) = delete;
+
+        vector_stats &operator=(const vector_stats &) = delete;
+
+        [[nodiscard]] std::string_view type_name() const noexcept;
+
+        [[nodiscard]] std::size_t capacity() const noexcept;
+
+        [[nodiscard]] std::size_t high_water_mark() const noexcept;
+
+        [[nodiscard]] std::size_t inserted() const noexcept;
+
+        [[nodiscard]] std::size_t erased() const noexcept;
+
+        [[nodiscard]] std::size_t shifted() const noexcept;
+
+        [[nodiscard]] std::size_t overflows() const noexcept;
+
+        void record_insert(std::size_t count, std::size_t shifted, std::size_t new_size) noexcept;
+
+        void record_erase(std::size_t count, std::size_t shifted) noexcept;
+
+        void record_overflow() noexcept;
+
+    private:
+        friend class instrumentation_registry;
+
+        std::string_view         type_name_;
+        std::size_t              capacity_;
+        std::atomic<std::size_t> high_water_mark_{};
+        std::atomic<std::size_t> inserted_{};
+        std::atomic<std::size_t> erased_{};
+        std::atomic<std::size_t> shifted_{};
+        std::atomic<std::size_t> overflows_{};
+        vector_stats            *next_{};
+    };
+
+    /**
+     * The process-wide list of vector_stats. Registration is lock-free, and statistics are never
+     * unregistered, so for_each() and dump() may run concurrently with vectors being modified.
+     * add() pushes to the front of the list, so for_each() and dump() visit the statistics in
+     * reverse registration order.
+     */
+    class instrumentation_registry
+    {
+    public:
+        [[nodiscard]] static instrumentation_registry &instance() noexcept;
+
+        void add(vector_stats &stats) noexcept;
+
+        template <class F>
+        void for_each(F &&f) const;
+
+        /**
+         * Prints one line per registered instantiation, the most recently registered first.
+         */
+        void dump(std::FILE *out = stderr) const;
+
+    private:
+        std::atomic<vector_stats *> head_{};
+    };
+
+    namespace detail
+    {
+        /**
+         * The name of T as spelled by the compiler, extracted from the signature of this function.
+         */
+        template <typename T>
+        constexpr std::string_view
+        type_name() noexcept
+        {
+#if defined(__clang__) || defined(__GNUC__)
+            constexpr std::string_view signature = __PRETTY_FUNCTION__;
+            constexpr std::string_view prefix    = "T = ";
+            constexpr std::size_t      first     = signature.find(prefix) + prefix.size();
+            constexpr std::size_t      last      = signature.find_first_of(";]", first);
+            return signature.substr(first, last - first);
+#elif defined(_MSC_VER)
+            constexpr std::string_view signature = __FUNCSIG__;
+            constexpr std::size_t      first     = signature.find("type_name<") + 10;
+            constexpr std::size_t      last      = signature.rfind(">(void)");
+            return signature.substr(first, last - first);
+#else
+            return "unknown";
+#endif
+        }
+
+        /**
+         * The hooks cesa::vector<T, max_elements> calls on every modification. They are no-ops
+         * unless CESA_INSTRUMENTATION is enabled, and during constant evaluation.
+         */
+        template <typename T, std::size_t max_elements>
+        struct vector_instrumentation
+        {
+#if CESA_INSTRUMENTATION
+            static vector_stats &
+            stats() noexcept
+            {
+                static vector_stats instance(type_name<T>(), max_elements);
+                return instance;
+            }
+#endif
+
+            static constexpr void
+            on_insert([[maybe_unused]] const std::size_t count, [[maybe_unused]] const std::size_t shifted,
+                      [[maybe_unused]] const std::size_t new_size) noexcept
+            {
+#if CESA_INSTRUMENTATION
+                if (!std::is_constant_evaluated())
+                {
+                    stats().record_insert(count, shifted, new_size);
+                }
+#endif
+            }
+
+            static constexpr void
+            on_erase([[maybe_unused]] const std::size_t count, [[maybe_unused]] const std::size_t shifted) noexcept
+            {
+#if CESA_INSTRUMENTATION
+                if (!std::is_constant_evaluated())
+                {
+                    stats().record_erase(count, shifted);
+                }
+#endif
+            }
+
+            static constexpr void
+            on_overflow() noexcept
+            {
+#if CESA_INSTRUMENTATION
+                if (!std::is_constant_evaluated())
+                {
+                    stats().record_overflow();
+                }
+#endif
+            }
+        };
+    }
+}
+
+inline
+cesa::vector_stats::vector_stats(const std::string_view type_name, const std::size_t capacity) noexcept
+    : type_name_(type_name)
+    , capacity_(capacity)
+{
+    instrumentation_registry::instance().add(*this);
+}
+
+inline std::string_view
+cesa::vector_stats::type_name() const noexcept
+{
+    return type_name_;
+}
+
+inline std::size_t
+cesa::vector_stats::capacity() const noexcept
+{
+    return capacity_;
+}
+
+inline std::size_t
+cesa::vector_stats::high_water_mark() const noexcept
+{
+    return high_water_mark_.load(std::memory_order_relaxed);
+}
+
+inline std::size_t
+cesa::vector_stats::inserted() const noexcept
+{
+    return inserted_.load(std::memory_order_relaxed);
+}
+
+inline std::size_t
+cesa::vector_stats::erased() const noexcept
+{
+    return erased_.load(std::memory_order_relaxed);
+}
+
+inline std::size_t
+cesa::vector_stats::shifted() const noexcept
+{
+    return shifted_.load(std::memory_order_relaxed);
+}
+
+inline std::size_t
+cesa::vector_stats::overflows() const noexcept
+{
+    return overflows_.load(std::memory_order_relaxed);
+}
+
+inline void
+cesa::vector_stats::record_insert(const std::size_t count, const std::size_t shifted,
+                                  const std::size_t new_size) noexcept
+{
+    inserted_.fetch_add(count, std::memory_order_relaxed);
+    shifted_.fetch_add(shifted, std::memory_order_relaxed);
+    std::size_t high_water_mark = high_water_mark_.load(std::memory_order_relaxed);
+    while (new_size > high_water_mark &&
+           !high_water_mark_.compare_exchange_weak(high_water_mark, new_size, std::memory_order_relaxed))
+    {
+    }
+}
+
+inline void
+cesa::vector_stats::record_erase(const std::size_t count, const std::size_t shifted) noexcept
+{
+    erased_.fetch_add(count, std::memory_order_relaxed);
+    shifted_.fetch_add(shifted, std::memory_order_relaxed);
+}
+
+inline void
+cesa::vector_stats::record_overflow() noexcept
+{
+    overflows_.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline cesa::instrumentation_registry &
+cesa::instrumentation_registry::instance() noexcept
+{
+    static instrumentation_registry registry;
+    return registry;
+}
+
+inline void
+cesa::instrumentation_registry::add(vector_stats &stats) noexcept
+{
+    stats.next_ = head_.load(std::memory_order_relaxed);
+    while (!head_.compare_exchange_weak(stats.next_, &stats, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+}
+
+template <class F>
+void
+cesa::instrumentation_registry::for_each(F &&f) const
+{
+    for (const vector_stats *stats = head_.load(std::memory_order_acquire); stats != nullptr; stats = stats->next_)
+    {
+        f(*stats);
+    }
+}
+
+inline void
+cesa::instrumentation_registry::dump(std::FILE *out) const
+{
+    for_each([out](const vector_stats &stats) {
+        const double used = stats.capacity() == 0 ? 0.0 : 100.0 * static_cast<double>(stats.high_water_mark()) /
+                                                              static_cast<double>(stats.capacity());
+        std::fprintf(out,
+                     "cesa::vector<%.*s, %zu>: high-water mark %zu (%.1f%%), inserted %zu, erased %zu, "
+                     "shifted %zu, overflows %zu\n",
+                     static_cast<int>(stats.type_name().size()), stats.type_name().data(), stats.capacity(),
+                     stats.high_water_mark(), used, stats.inserted(), stats.erased(), stats.shifted(),
+                     stats.overflows());
+    });
+}
+
+#endif
@@ -0,0 +1,429 @@
+#ifndef CESA_SERIALIZATION_HPP
+#define CESA_SERIALIZATION_HPP
+
+/**
+ * serialization.hpp
+ *
+ * Zero-copy serialization of cesa::vector for trivially copyable element types.
+ *
+ * A serialized vector is a 16-byte serialization_header followed by the live elements, byte for
+ * byte as they are stored in the vector. serialize() does not copy anything: it returns the header
+ * and a span over the elements, which can be handed to a single writev() / WSASend() or copied
+ * into shared memory as they are:
+ *
+ *     const cesa::serialized bytes = cesa::serialize(v);
+ *     const auto [header, payload] = bytes.buffers();
+ *     const iovec iov[] = { { const_cast<std::byte *>(header.data()), header.size() },
+ *                           { const_cast<std::byte *>(payload.data()), payload.size() } };
+ *     writev(fd, iov, 2);
+ *
+ * On the receiving side, cesa::vector_view<T> overlays a received or memory-mapped buffer and
+ * checks it in O(1), without touching the elements, and deserialize() copies it into a
+ * cesa::vector with a single memcpy.
+ *
+ * Note:
+ * The format uses the byte order and object layout of the writer, so it is meant for exchange
+ * between processes on the same platform: a reader with a different byte order or element size
+ * rejects the data. The element type itself is not recorded; both sides must agree on it. The
+ * padding bytes of the elements, if any, are sent as they are. cesa::vector<bool, N> stores bits
+ * rather than elements and cannot be serialized.
+ */
+
+#include "config.hpp"
+#include "vector.hpp"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <span>
+#include <type_traits>
+
+namespace cesa
+{
+    /**
+     * The fixed header that precedes the elements of a serialized vector.
+     */
+    struct serialization_header
+    {
+        /**
+         * Identifies the format and its version, and tells apart a reader with a different byte
+         * order, which sees the bytes reversed.
+         */
+        static constexpr std::uint32_t format_magic = 0x31565343; // "CSV1" in little-endian byte order
+
+        std::uint32_t magic{format_magic};
+        std::uint32_t element_size{};
+        std::uint64_t size{};
+    };
+
+    static_assert(sizeof(serialization_header) == 16 && std::is_trivially_copyable_v<serialization_header>);
+
+    namespace detail
+    {
+        /**
+         * Whether vectors of T can be serialized: the elements are copied as bytes and must start
+         * at a suitably aligned offset after the header.
+         */
+        template <typename T>
+        inline constexpr bool is_serializable_element_v =
+            std::is_trivially_copyable_v<T> && sizeof(serialization_header) % alignof(T) == 0;
+
+        /**
+         * Reads the header at the start of bytes and stores the number of elements it announces in
+         * size. Returns false if bytes does not hold a valid header for elements of element_size
+         * bytes followed by that many elements.
+         */
+        [[nodiscard]] inline bool
+        read_serialization_header(const std::span<const std::byte> bytes, const std::size_t element_size,
+                                  std::size_t &size) noexcept
+        {
+            serialization_header header;
+            if (bytes.size() < sizeof(header))
+            {
+                return false;
+            }
+            std::memcpy(&header, bytes.data(), sizeof(header));
+            if (header.magic != serialization_header::format_magic || header.element_size != element_size ||
+                header.size > (bytes.size() - sizeof(header)) / element_size)
+            {
+                return false;
+            }
+            size = static_cast<std::size_t>(header.size);
+            return true;
+        }
+    }
+
+    /**
+     * The serialized form of a vector: its header, and a span over the live elements inside the
+     * vector. Valid for as long as the vector is alive and unmodified.
+     */
+    struct serialized
+    {
+        serialization_header       header;
+        std::span<const std::byte> payload;
+
+        /**
+         * The header and payload bytes, in the order they are to be written. The header span
+         * refers to this object, so it must not be moved or destroyed while the span is in use.
+         */
+        [[nodiscard]] std::array<std::span<const std::byte>, 2> buffers() const noexcept;
+
+        /**
+         * The total number of bytes of the serialized vector.
+         */
+        [[nodiscard]] std::size_t size_bytes() const noexcept;
+    };
+
+    /**
+     * Serializes v without copying its elements.
+     */
+    template <typename T, std::size_t max_elements, std::size_t alignment>
+    [[nodiscard]] serialized serialize(const vector<T, max_elements, alignment> &v) noexcept;
+
+    /**
+     * The number of bytes serialize(v) produces.
+     */
+    template <typename T, std::size_t max_elements, std::size_t alignment>
+    [[nodiscard]] std::size_t serialized_size(const vector<T, max_elements, alignment> &v) noexcept;
+
+    /**
+     * Replaces the contents of out with the vector serialized in bytes, which need not be aligned.
+     * Returns false and leaves out unchanged if bytes does not hold a valid serialized vector of T,
+     * or holds more than out can store.
+     */
+    template <typename T, std::size_t max_elements, std::size_t alignment>
+    [[nodiscard]] bool try_deserialize(std::span<const std::byte> bytes, vector<T, max_elements, alignment> &out);
+
+    /**
+     * Like try_deserialize(), but reports an error instead of returning false.
+     */
+    template <typename T, std::size_t max_elements, std::size_t alignment>
+    void deserialize(std::span<const std::byte> bytes, vector<T, max_elements, alignment> &out);
+
+    /**
+     * A read-only view of a serialized vector of T, overlaid on the buffer holding it, such as a
+     * memory-mapped file, a shared memory segment or a receive buffer. The buffer must stay alive
+     * and unmodified while the view is in use, and must be aligned to alignof(T).
+     */
+    template <typename T>
+    class vector_view
+    {
+        static_assert(detail::is_serializable_element_v<T>,
+                      "vector_view requires a trivially copyable T whose alignment divides 16");
+
+    public:
+        using value_type             = T;
+        using size_type              = std::size_t;
+        using difference_type        = std::ptrdiff_t;
+        using const_reference        = const value_type &;
+        using const_pointer          = const value_type *;
+        using const_iterator         = const value_type *;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        /**
+         * An empty view.
+         */
+        constexpr vector_view() noexcept = default;
+
+        /**
+         * Overlays the serialized vector at the start of bytes. Reports an error if validate(bytes)
+         * does not hold.
+         */
+        explicit vector_view(std::span<const std::byte> bytes);
+
+        /**
+         * Whether bytes starts with a valid serialized vector of T and is suitably aligned for a
+         * view. Only reads the header, so the cost does not depend on the number of elements.
+         */
+        [[nodiscard]] static bool validate(std::span<const std::byte> bytes) noexcept;
+
+        /*** Element access ***/
+        [[nodiscard]] const_reference at(size_type pos) const;
+
+        [[nodiscard]] const_reference operator[](size_type pos) const noexcept;
+
+        [[nodiscard]] const_reference front() const noexcept;
+
+        [[nodiscard]] const_reference back() const noexcept;
+
+        [[nodiscard]] constexpr const_pointer data() const noexcept;
+
+        [[nodiscard]] constexpr std::span<const value_type> span() const noexcept;
+
+        /*** Iterators ***/
+        [[nodiscard]] constexpr const_iterator begin() const noexcept;
+
+        [[nodiscard]] constexpr const_iterator end() const noexcept;
+
+        [[nodiscard]] constexpr const_iterator cbegin() const noexcept;
+
+        [[nodiscard]] constexpr const_iterator cend() const noexcept;
+
+        [[nodiscard]] constexpr const_reverse_iterator rbegin() const noexcept;
+
+        [[nodiscard]] constexpr const_reverse_iterator rend() const noexcept;
+
+        /*** Capacity ***/
+        [[nodiscard]] constexpr bool empty() const noexcept;
+
+        [[nodiscard]] constexpr size_type size() const noexcept;
+
+        /**
+         * The number of bytes of the serialized vector, i.e. the offset just past its last element.
+         */
+        [[nodiscard]] constexpr size_type size_bytes() const noexcept;
+
+    private:
+        const_pointer data_{};
+        size_type     size_{};
+    };
+}
+
+inline std::array<std::span<const std::byte>, 2>
+cesa::serialized::buffers() const noexcept
+{
+    return { std::as_bytes(std::span<const serialization_header, 1>(&header, 1)), payload };
+}
+
+inline std::size_t
+cesa::serialized::size_bytes() const noexcept
+{
+    return sizeof(header) + payload.size();
+}
+
+template <typename T, std::size_t max_elements, std::size_t alignment>
+cesa::serialized
+cesa::serialize(const vector<T, max_elements, alignment> &v) noexcept
+{
+    static_assert(detail::is_serializable_element_v<T>,
+                  "serialize requires a trivially copyable T whose alignment divides 16");
+    static_assert(!std::is_same_v<T, bool>, "serialize does not support the bit-packed cesa::vector<bool, N>");
+    serialized result;
+    result.header.element_size = static_cast<std::uint32_t>(sizeof(T));
+    result.header.size         = v.size();
+    result.payload             = std::as_bytes(std::span<const T>(v.data(), v.size()));
+    return result;
+}
+
+template <typename T, std::size_t max_elements, std::size_t alignment>
+std::size_t
+cesa::serialized_size(const vector<T, max_elements, alignment> &v) noexcept
+{
+    return sizeof(serialization_header) + v.size() * sizeof(T);
+}
+
+template <typename T, std::size_t max_elements, std::size_t alignment>
+bool
+cesa::try_deserialize(const std::span<const std::byte> bytes, vector<T, max_elements, alignment> &out)
+{
+    static_assert(detail::is_serializable_element_v<T>,
+                  "deserialize requires a trivially copyable T whose alignment divides 16");
+    static_assert(!std::is_same_v<T, bool>, "deserialize does not support the bit-packed cesa::vector<bool, N>");
+    std::size_t size{};
+    if (!detail::read_serialization_header(bytes, sizeof(T), size) || size > max_elements)
+    {
+        return false;
+    }
+    const std::byte *elements = bytes.data() + sizeof(serialization_header);
+    if (reinterpret_cast<std::uintptr_t>(elements) % alignof(T) == 0)
+    {
+        const T *first = reinterpret_cast<const T *>(elements);
+        out.assign(first, first + size);
+    }
+    else
+    {
+        out.clear();
+        for (std::size_t i{}; i < size; ++i)
+        {
+            std::array<std::byte, sizeof(T)> element;
+            std::memcpy(element.data(), elements + i * sizeof(T), sizeof(T));
+            out.unchecked_emplace_back(std::bit_cast<T>(element));
+        }
+    }
+    return true;
+}
+
+template <typename T, std::size_t max_elements, std::size_t alignment>
+void
+cesa::deserialize(const std::span<const std::byte> bytes, vector<T, max_elements, alignment> &out)
+{
+    if (!try_deserialize(bytes, out))
+    {
+        detail::report_error("invalid serialized vector");
+    }
+}
+
+template <typename T>
+cesa::vector_view<T>::vector_view(const std::span<const std::byte> bytes)
+{
+    if (!validate(bytes))
+    {
+        detail::report_error("invalid serialized vector");
+        return;
+    }
+    static_cast<void>(detail::read_serialization_header(bytes, sizeof(T), size_));
+    data_ = reinterpret_cast<const_pointer>(bytes.data() + sizeof(serialization_header));
+}
+
+template <typename T>
+bool
+cesa::vector_view<T>::validate(const std::span<const std::byte> bytes) noexcept
+{
+    std::size_t size{};
+    return reinterpret_cast<std::uintptr_t>(bytes.data()) % alignof(T) == 0 &&
+           detail::read_serialization_header(bytes, sizeof(T), size);
+}
+
+template <typename T>
+typename cesa::vector_view<T>::const_reference
+cesa::vector_view<T>::at(const size_type pos) const
+{
+    if (pos >= size_)
+    {
+        detail::report_error("index out of range");
+    }
+    return data_[pos];
+}
+
+template <typename T>
+typename cesa::vector_view<T>::const_reference
+cesa::vector_view<T>::operator[](const size_type pos) const noexcept
+{
+    return data_[pos];
+}
+
+template <typename T>
+typename cesa::vector_view<T>::const_reference
+cesa::vector_view<T>::front() const noexcept
+{
+    return data_[0];
+}
+
+template <typename T>
+typename cesa::vector_view<T>::const_reference
+cesa::vector_view<T>::back() const noexcept
+{
+    return data_[size_ - 1];
+}
+
+template <typename T>
+constexpr typename cesa::vector_view<T>::const_pointer
+cesa::vector_view<T>::data() const noexcept
+{
+    return data_;
+}
+
+template <typename T>
+constexpr std::span<const T>
+cesa::vector_view<T>::span() const noexcept
+{
+    return std::span<const T>(data_, size_);
+}
+
+template <typename T>
+constexpr typename cesa::vector_view<T>::const_iterator
+cesa::vector_view<T>::begin() const noexcept
+{
+    return data_;
+}
+
+template <typename T>
+constexpr typename cesa::vector_view<T>::const_iterator
+cesa::vector_view<T>::end() const noexcept
+{
+    return data_ + size_;
+}
+
+template <typename T>
+constexpr typename cesa::vector_view<T>::const_iterator
+cesa::vector_view<T>::cbegin() const noexcept
+{
+    return begin();
+}
+
+template <typename T>
+constexpr typename cesa::vector_view<T>::const_iterator
+cesa::vector_view<T>::cend() const noexcept
+{
+    return end();
+}
+
+template <typename T>
+constexpr typename cesa::vector_view<T>::const_reverse_iterator
+cesa::vector_view<T>::rbegin() const noexcept
+{
+    return const_reverse_iterator(end());
+}
+
+template <typename T>
+constexpr typename cesa::vector_view<T>::const_reverse_iterator
+cesa::vector_view<T>::rend() const noexcept
+{
+    return const_reverse_iterator(begin());
+}
+
+template <typename T>
+constexpr bool
+cesa::vector_view<T>::empty() const noexcept
+{
+    return size_ == 0;
+}
+
+template <typename T>
+constexpr typename cesa::vector_view<T>::size_type
+cesa::vector_view<T>::size() const noexcept
+{
+    return size_;
+}
+
+template <typename T>
+constexpr typename cesa::vector_view<T>::size_type
+cesa::vector_view<T>::size_bytes() const noexcept
+{
+    return sizeof(serialization_header) + size_ * sizeof(T);
+}
+
+#endif
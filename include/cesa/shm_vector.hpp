@@ -0,0 +1,383 @@
+#ifndef CESA_SHM_VECTOR_HPP
+#define CESA_SHM_VECTOR_HPP
+
+/**
+ * shm_vector.hpp
+ *
+ * A fixed-capacity vector for shared memory, with one writer and lock-free readers.
+ *
+ * The cesa::shm_vector class is a standard-layout object without pointers, whose layout only
+ * depends on T and the capacity: a 64-bit sequence counter at offset 0, the 64-bit size at offset
+ * 8, and the elements from the next cache line (or alignof(T), if larger) on. It can therefore be
+ * constructed in a POSIX or Windows shared memory segment by one process and used in place by
+ * every process that maps the segment:
+ *
+ *     auto *feed = new (segment) cesa::shm_vector<quote, 4096>();                // creator
+ *     auto *feed = static_cast<cesa::shm_vector<quote, 4096> *>(segment);        // others
+ *
+ * Reads and writes follow a seqlock protocol. The writer makes the sequence counter odd while it
+ * modifies the vector and even again when it is done. A reader copies the size and the live
+ * elements, and keeps the copy only if the counter was even and unchanged throughout, so it
+ * always obtains a consistent snapshot of the live prefix without locks, without blocking the
+ * writer and without copying the unused capacity. Every modifying member publishes its change on
+ * its own; begin_write() and end_write() group several modifications into one change.
+ *
+ * Attention:
+ * Calling the writer members (everything but the reader section) from more than one thread or
+ * process at a time is a data race. A writer dying between begin_write() and end_write() leaves
+ * readers retrying forever.
+ *
+ * Note:
+ * Readers copy the elements while the writer may be modifying them, and discard the copy if it
+ * overlapped a write. This is the standard seqlock pattern, which thread sanitizers report as a
+ * data race.
+ */
+
+#include "config.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <thread>
+#include <type_traits>
+
+namespace cesa
+{
+    template <typename T, std::size_t max_elements>
+    class shm_vector
+    {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_standard_layout_v<T>,
+                      "shm_vector requires a trivially copyable, standard-layout T");
+        static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                      "shm_vector requires lock-free 64-bit atomics, as only those work across processes");
+        static_assert(detail::check_inline_budget<sizeof(T) * max_elements>(),
+                      "shm_vector inline storage exceeds CESA_MAX_INLINE_BYTES");
+
+    public:
+        using value_type      = T;
+        using size_type       = std::size_t;
+        using const_reference = const value_type &;
+
+        shm_vector() noexcept;
+
+        shm_vector(const shm_vector &) = delete;
+
+        shm_vector &operator=(const shm_vector &) = delete;
+
+
+        /*** Writer ***/
+
+        /**
+         * Starts a change spanning several modifications, which readers see all at once when the
+         * matching end_write() is called. Calls may be nested.
+         */
+        void begin_write() noexcept;
+
+        void end_write() noexcept;
+
+        void push_back(const value_type &value);
+
+        [[nodiscard]] bool try_push_back(const value_type &value) noexcept;
+
+        /**
+         * Removes the last element, reporting an error if the vector is empty.
+         */
+        void pop_back();
+
+        /**
+         * Replaces the element at pos, reporting an error if pos is out of range.
+         */
+        void set(size_type pos, const value_type &value);
+
+        /**
+         * Replaces the contents with values, reporting an error if they do not fit.
+         */
+        void assign(std::span<const value_type> values);
+
+        void clear() noexcept;
+
+        /**
+         * The element at pos, for the writer only: readers must use read().
+         */
+        [[nodiscard]] const_reference writer_at(size_type pos) const noexcept;
+
+
+        /*** Reader ***/
+
+        /**
+         * The number of completed changes times two, plus one while a change is in progress.
+         * Readers can poll it to find out whether anything changed since their last snapshot.
+         */
+        [[nodiscard]] std::uint64_t version() const noexcept;
+
+        /**
+         * The current size, which may already be outdated when the call returns.
+         */
+        [[nodiscard]] size_type size() const noexcept;
+
+        [[nodiscard]] bool empty() const noexcept;
+
+        [[nodiscard]] static constexpr size_type max_size() noexcept;
+
+        /**
+         * Makes one attempt to copy the first min(size(), out.size()) elements into out. Returns
+         * false, leaving the contents of out unspecified, if a change was in progress or happened
+         * during the copy; otherwise stores the number of copied elements in count.
+         */
+        [[nodiscard]] bool try_read(std::span<value_type> out, size_type &count) const noexcept;
+
+        /**
+         * Copies the first min(size(), out.size()) elements into out, retrying until the copy is
+         * consistent, and returns the number of copied elements.
+         */
+        size_type read(std::span<value_type> out) const noexcept;
+
+        /**
+         * Replaces the contents of out with the first min(size(), out.max_size()) elements,
+         * retrying until the copy is consistent.
+         */
+        template <std::size_t out_elements, std::size_t out_alignment>
+        void read(vector<value_type, out_elements, out_alignment> &out) const;
+
+    private:
+        [[nodiscard]] value_type *ptr_at(size_type index) noexcept;
+
+        [[nodiscard]] const value_type *ptr_at(size_type index) const noexcept;
+
+        alignas(detail::cache_line_size) std::atomic<std::uint64_t> sequence_{};
+        std::atomic<std::uint64_t> size_{};
+        std::uint32_t              write_depth_{};
+
+        alignas(detail::cache_line_size) alignas(value_type) std::byte storage_[sizeof(value_type) * max_elements];
+    };
+}
+
+template <typename T, std::size_t max_elements>
+cesa::shm_vector<T, max_elements>::shm_vector() noexcept
+{
+    static_assert(std::is_standard_layout_v<shm_vector>, "shm_vector must be standard-layout");
+    static_assert(offsetof(shm_vector, sequence_) == 0 && offsetof(shm_vector, size_) == 8,
+                  "shm_vector header layout changed");
+}
+
+template <typename T, std::size_t max_elements>
+void
+cesa::shm_vector<T, max_elements>::begin_write() noexcept
+{
+    if (write_depth_++ == 0)
+    {
+        sequence_.store(sequence_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        // Orders the odd sequence before the modifications that follow
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+}
+
+template <typename T, std::size_t max_elements>
+void
+cesa::shm_vector<T, max_elements>::end_write() noexcept
+{
+    if (--write_depth_ == 0)
+    {
+        sequence_.store(sequence_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+}
+
+template <typename T, std::size_t max_elements>
+void
+cesa::shm_vector<T, max_elements>::push_back(const value_type &value)
+{
+    if (!try_push_back(value))
+    {
+        detail::report_error("shm_vector capacity exceeded");
+    }
+}
+
+template <typename T, std::size_t max_elements>
+bool
+cesa::shm_vector<T, max_elements>::try_push_back(const value_type &value) noexcept
+{
+    const std::uint64_t size = size_.load(std::memory_order_relaxed);
+    if (size == max_elements)
+    {
+        return false;
+    }
+    begin_write();
+    std::construct_at(ptr_at(size), value);
+    size_.store(size + 1, std::memory_order_relaxed);
+    end_write();
+    return true;
+}
+
+template <typename T, std::size_t max_elements>
+void
+cesa::shm_vector<T, max_elements>::pop_back()
+{
+    const std::uint64_t size = size_.load(std::memory_order_relaxed);
+    if (size == 0)
+    {
+        detail::report_error("shm_vector is empty");
+        return;
+    }
+    begin_write();
+    size_.store(size - 1, std::memory_order_relaxed);
+    end_write();
+}
+
+template <typename T, std::size_t max_elements>
+void
+cesa::shm_vector<T, max_elements>::set(const size_type pos, const value_type &value)
+{
+    if (pos >= size_.load(std::memory_order_relaxed))
+    {
+        detail::report_error("index out of range");
+        return;
+    }
+    begin_write();
+    *ptr_at(pos) = value;
+    end_write();
+}
+
+template <typename T, std::size_t max_elements>
+void
+cesa::shm_vector<T, max_elements>::assign(const std::span<const value_type> values)
+{
+    if (values.size() > max_elements)
+    {
+        detail::report_error("shm_vector capacity exceeded");
+        return;
+    }
+    begin_write();
+    if (!values.empty())
+    {
+        std::memcpy(static_cast<void *>(storage_), values.data(), values.size_bytes());
+    }
+    size_.store(values.size(), std::memory_order_relaxed);
+    end_write();
+}
+
+template <typename T, std::size_t max_elements>
+void
+cesa::shm_vector<T, max_elements>::clear() noexcept
+{
+    begin_write();
+    size_.store(0, std::memory_order_relaxed);
+    end_write();
+}
+
+template <typename T, std::size_t max_elements>
+typename cesa::shm_vector<T, max_elements>::const_reference
+cesa::shm_vector<T, max_elements>::writer_at(const size_type pos) const noexcept
+{
+    return *ptr_at(pos);
+}
+
+template <typename T, std::size_t max_elements>
+std::uint64_t
+cesa::shm_vector<T, max_elements>::version() const noexcept
+{
+    return sequence_.load(std::memory_order_acquire);
+}
+
+template <typename T, std::size_t max_elements>
+typename cesa::shm_vector<T, max_elements>::size_type
+cesa::shm_vector<T, max_elements>::size() const noexcept
+{
+    return static_cast<size_type>(size_.load(std::memory_order_acquire));
+}
+
+template <typename T, std::size_t max_elements>
+bool
+cesa::shm_vector<T, max_elements>::empty() const noexcept
+{
+    return size() == 0;
+}
+
+template <typename T, std::size_t max_elements>
+constexpr typename cesa::shm_vector<T, max_elements>::size_type
+cesa::shm_vector<T, max_elements>::max_size() noexcept
+{
+    return max_elements;
+}
+
+template <typename T, std::size_t max_elements>
+bool
+cesa::shm_vector<T, max_elements>::try_read(const std::span<value_type> out, size_type &count) const noexcept
+{
+    const std::uint64_t before = sequence_.load(std::memory_order_acquire);
+    if ((before & 1) != 0)
+    {
+        return false;
+    }
+    // The size may be torn from the elements, but never exceeds the capacity, so the copy stays in
+    // bounds and the sequence check below rejects it
+    const size_type copied =
+        std::min({ static_cast<size_type>(size_.load(std::memory_order_relaxed)), out.size(), max_elements });
+    if (copied != 0)
+    {
+        std::memcpy(static_cast<void *>(out.data()), storage_, copied * sizeof(value_type));
+    }
+    // Orders the copy before the second sequence load
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence_.load(std::memory_order_relaxed) != before)
+    {
+        return false;
+    }
+    count = copied;
+    return true;
+}
+
+template <typename T, std::size_t max_elements>
+typename cesa::shm_vector<T, max_elements>::size_type
+cesa::shm_vector<T, max_elements>::read(const std::span<value_type> out) const noexcept
+{
+    size_type count{};
+    while (!try_read(out, count))
+    {
+        std::this_thread::yield();
+    }
+    return count;
+}
+
+template <typename T, std::size_t max_elements>
+template <std::size_t out_elements, std::size_t out_alignment>
+void
+cesa::shm_vector<T, max_elements>::read(vector<value_type, out_elements, out_alignment> &out) const
+{
+    for (;;)
+    {
+        const std::uint64_t before = sequence_.load(std::memory_order_acquire);
+        if ((before & 1) == 0)
+        {
+            const size_type count = std::min(
+                { static_cast<size_type>(size_.load(std::memory_order_relaxed)), out_elements, max_elements });
+            out.assign(ptr_at(0), ptr_at(count));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == before)
+            {
+                return;
+            }
+        }
+        std::this_thread::yield();
+    }
+}
+
+template <typename T, std::size_t max_elements>
+typename cesa::shm_vector<T, max_elements>::value_type *
+cesa::shm_vector<T, max_elements>::ptr_at(const size_type index) noexcept
+{
+    return reinterpret_cast<value_type *>(&storage_[index * sizeof(value_type)]);
+}
+
+template <typename T, std::size_t max_elements>
+const typename cesa::shm_vector<T, max_elements>::value_type *
+cesa::shm_vector<T, max_elements>::ptr_at(const size_type index) const noexcept
+{
+    return reinterpret_cast<const value_type *>(&storage_[index * sizeof(value_type)]);
+}
+
+#endif
@@ -0,0 +1,430 @@
+#ifndef CESA_SIMD_HPP
+#define CESA_SIMD_HPP
+
+/**
+ * simd.hpp
+ *
+ * Vectorized search and comparison kernels used by the cesa containers.
+ *
+ * The kernels work on contiguous ranges of arithmetic elements and use AVX2 or SSE2 on x86 and
+ * NEON on AArch64, whichever the translation unit is compiled for. Other element types, other
+ * targets and constant evaluation use a plain scalar loop with the same results, so callers never
+ * need to check which path is taken. Floating-point elements are compared with IEEE semantics,
+ * exactly like operator==: NaN never compares equal and -0.0 equals +0.0.
+ *
+ * Defining CESA_NO_SIMD before including any cesa header disables the vectorized paths.
+ */
+
+#include "config.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if !defined(CESA_NO_SIMD)
+#    if defined(__AVX2__)
+#        define CESA_SIMD_AVX2 1
+#        include <immintrin.h>
+#    elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#        define CESA_SIMD_SSE2 1
+#        include <emmintrin.h>
+#    elif defined(__ARM_NEON) && defined(__aarch64__)
+#        define CESA_SIMD_NEON 1
+#        include <arm_neon.h>
+#    endif
+#endif
+
+namespace cesa
+{
+    namespace detail
+    {
+        /**
+         * Whether the vectorized kernels handle elements of type T. Holds for integers and for
+         * float and double, but not for bool or long double.
+         */
+        template <typename T>
+        inline constexpr bool is_simd_element_v =
+            (std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+             (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)) ||
+            std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+#if defined(CESA_SIMD_AVX2)
+        using simd_register = __m256i;
+
+        inline constexpr std::size_t simd_register_bytes = 32;
+        inline constexpr std::size_t simd_mask_bits_per_byte = 1;
+
+        template <typename T>
+        inline simd_register
+        simd_load(const T *p) noexcept
+        {
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        }
+
+        template <typename T>
+        inline simd_register
+        simd_splat(const T value) noexcept
+        {
+            if constexpr (std::is_same_v<T, float>)
+            {
+                return _mm256_castps_si256(_mm256_set1_ps(value));
+            }
+            else if constexpr (std::is_same_v<T, double>)
+            {
+                return _mm256_castpd_si256(_mm256_set1_pd(value));
+            }
+            else if constexpr (sizeof(T) == 1)
+            {
+                return _mm256_set1_epi8(std::bit_cast<std::int8_t>(value));
+            }
+            else if constexpr (sizeof(T) == 2)
+            {
+                return _mm256_set1_epi16(std::bit_cast<std::int16_t>(value));
+            }
+            else if constexpr (sizeof(T) == 4)
+            {
+                return _mm256_set1_epi32(std::bit_cast<std::int32_t>(value));
+            }
+            else
+            {
+                return _mm256_set1_epi64x(std::bit_cast<std::int64_t>(value));
+            }
+        }
+
+        template <typename T>
+        inline std::uint64_t
+        simd_equal_mask(const simd_register a, const simd_register b) noexcept
+        {
+            __m256i equal;
+            if constexpr (std::is_same_v<T, float>)
+            {
+                equal = _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_EQ_OQ));
+            }
+            else if constexpr (std::is_same_v<T, double>)
+            {
+                equal = _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_EQ_OQ));
+            }
+            else if constexpr (sizeof(T) == 1)
+            {
+                equal = _mm256_cmpeq_epi8(a, b);
+            }
+            else if constexpr (sizeof(T) == 2)
+            {
+                equal = _mm256_cmpeq_epi16(a, b);
+            }
+            else if constexpr (sizeof(T) == 4)
+            {
+                equal = _mm256_cmpeq_epi32(a, b);
+            }
+            else
+            {
+                equal = _mm256_cmpeq_epi64(a, b);
+            }
+            return static_cast<std::uint32_t>(_mm256_movemask_epi8(equal));
+        }
+#elif defined(CESA_SIMD_SSE2)
+        using simd_register = __m128i;
+
+        inline constexpr std::size_t simd_register_bytes = 16;
+        inline constexpr std::size_t simd_mask_bits_per_byte = 1;
+
+        template <typename T>
+        inline simd_register
+        simd_load(const T *p) noexcept
+        {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        }
+
+        template <typename T>
+        inline simd_register
+        simd_splat(const T value) noexcept
+        {
+            if constexpr (std::is_same_v<T, float>)
+            {
+                return _mm_castps_si128(_mm_set1_ps(value));
+            }
+            else if constexpr (std::is_same_v<T, double>)
+            {
+                return _mm_castpd_si128(_mm_set1_pd(value));
+            }
+            else if constexpr (sizeof(T) == 1)
+            {
+                return _mm_set1_epi8(std::bit_cast<std::int8_t>(value));
+            }
+            else if constexpr (sizeof(T) == 2)
+            {
+                return _mm_set1_epi16(std::bit_cast<std::int16_t>(value));
+            }
+            else if constexpr (sizeof(T) == 4)
+            {
+                return _mm_set1_epi32(std::bit_cast<std::int32_t>(value));
+            }
+            else
+            {
+                return _mm_set1_epi64x(std::bit_cast<std::int64_t>(value));
+            }
+        }
+
+        template <typename T>
+        inline std::uint64_t
+        simd_equal_mask(const simd_register a, const simd_register b) noexcept
+        {
+            __m128i equal;
+            if constexpr (std::is_same_v<T, float>)
+            {
+                equal = _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+            }
+            else if constexpr (std::is_same_v<T, double>)
+            {
+                equal = _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+            }
+            else if constexpr (sizeof(T) == 1)
+            {
+                equal = _mm_cmpeq_epi8(a, b);
+            }
+            else if constexpr (sizeof(T) == 2)
+            {
+                equal = _mm_cmpeq_epi16(a, b);
+            }
+            else if constexpr (sizeof(T) == 4)
+            {
+                equal = _mm_cmpeq_epi32(a, b);
+            }
+            else
+            {
+                // SSE2 has no 64-bit compare: both 32-bit halves must match
+                equal = _mm_cmpeq_epi32(a, b);
+                equal = _mm_and_si128(equal, _mm_shuffle_epi32(equal, _MM_SHUFFLE(2, 3, 0, 1)));
+            }
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(equal));
+        }
+#elif defined(CESA_SIMD_NEON)
+        using simd_register = uint8x16_t;
+
+        inline constexpr std::size_t simd_register_bytes = 16;
+        inline constexpr std::size_t simd_mask_bits_per_byte = 4;
+
+        template <typename T>
+        inline simd_register
+        simd_load(const T *p) noexcept
+        {
+            return vld1q_u8(reinterpret_cast<const std::uint8_t *>(p));
+        }
+
+        template <typename T>
+        inline simd_register
+        simd_splat(const T value) noexcept
+        {
+            if constexpr (sizeof(T) == 1)
+            {
+                return vdupq_n_u8(std::bit_cast<std::uint8_t>(value));
+            }
+            else if constexpr (sizeof(T) == 2)
+            {
+                return vreinterpretq_u8_u16(vdupq_n_u16(std::bit_cast<std::uint16_t>(value)));
+            }
+            else if constexpr (sizeof(T) == 4)
+            {
+                return vreinterpretq_u8_u32(vdupq_n_u32(std::bit_cast<std::uint32_t>(value)));
+            }
+            else
+            {
+                return vreinterpretq_u8_u64(vdupq_n_u64(std::bit_cast<std::uint64_t>(value)));
+            }
+        }
+
+        template <typename T>
+        inline std::uint64_t
+        simd_equal_mask(const simd_register a, const simd_register b) noexcept
+        {
+            uint8x16_t equal;
+            if constexpr (std::is_same_v<T, float>)
+            {
+                equal = vreinterpretq_u8_u32(vceqq_f32(vreinterpretq_f32_u8(a), vreinterpretq_f32_u8(b)));
+            }
+            else if constexpr (std::is_same_v<T, double>)
+            {
+                equal = vreinterpretq_u8_u64(vceqq_f64(vreinterpretq_f64_u8(a), vreinterpretq_f64_u8(b)));
+            }
+            else if constexpr (sizeof(T) == 1)
+            {
+                equal = vceqq_u8(a, b);
+            }
+            else if constexpr (sizeof(T) == 2)
+            {
+                equal = vreinterpretq_u8_u16(vceqq_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+            }
+            else if constexpr (sizeof(T) == 4)
+            {
+                equal = vreinterpretq_u8_u32(vceqq_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+            }
+            else
+            {
+                equal = vreinterpretq_u8_u64(vceqq_u64(vreinterpretq_u64_u8(a), vreinterpretq_u64_u8(b)));
+            }
+            // Narrow each byte of the comparison to a nibble, giving a 64-bit mask
+            const uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(equal), 4);
+            return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+        }
+#endif
+
+        /**
+         * Returns the index of the first element in [first, first + count) equal to value,
+         * or count if there is none.
+         */
+        template <typename T>
+        [[nodiscard]] constexpr std::size_t
+        find_index(const T *first, const std::size_t count, const T &value) noexcept(is_simd_element_v<T>)
+        {
+            std::size_t i{};
+#if defined(CESA_SIMD_AVX2) || defined(CESA_SIMD_SSE2) || defined(CESA_SIMD_NEON)
+            if constexpr (is_simd_element_v<T>)
+            {
+                if (!std::is_constant_evaluated())
+                {
+                    constexpr std::size_t lanes        = simd_register_bytes / sizeof(T);
+                    constexpr std::size_t element_bits = sizeof(T) * simd_mask_bits_per_byte;
+                    const simd_register   needle       = simd_splat(value);
+                    for (; i + lanes <= count; i += lanes)
+                    {
+                        const std::uint64_t mask = simd_equal_mask<T>(simd_load(first + i), needle);
+                        if (mask != 0)
+                        {
+                            return i + static_cast<std::size_t>(std::countr_zero(mask)) / element_bits;
+                        }
+                    }
+                }
+            }
+#endif
+            for (; i < count; ++i)
+            {
+                if (first[i] == value)
+                {
+                    return i;
+                }
+            }
+            return count;
+        }
+
+        /**
+         * Returns the number of elements in [first, first + count) equal to value.
+         */
+        template <typename T>
+        [[nodiscard]] constexpr std::size_t
+        count_equal(const T *first, const std::size_t count, const T &value) noexcept(is_simd_element_v<T>)
+        {
+            std::size_t i{};
+            std::size_t found{};
+#if defined(CESA_SIMD_AVX2) || defined(CESA_SIMD_SSE2) || defined(CESA_SIMD_NEON)
+            if constexpr (is_simd_element_v<T>)
+            {
+                if (!std::is_constant_evaluated())
+                {
+                    constexpr std::size_t lanes        = simd_register_bytes / sizeof(T);
+                    constexpr std::size_t element_bits = sizeof(T) * simd_mask_bits_per_byte;
+                    const simd_register   needle       = simd_splat(value);
+                    for (; i + lanes <= count; i += lanes)
+                    {
+                        const std::uint64_t mask = simd_equal_mask<T>(simd_load(first + i), needle);
+                        found += static_cast<std::size_t>(std::popcount(mask)) / element_bits;
+                    }
+                }
+            }
+#endif
+            for (; i < count; ++i)
+            {
+                found += first[i] == value ? 1 : 0;
+            }
+            return found;
+        }
+
+        /**
+         * Whether the elements of [lhs, lhs + count) and [rhs, rhs + count) are pairwise equal.
+         */
+        template <typename T>
+        [[nodiscard]] constexpr bool
+        equal_elements(const T *lhs, const T *rhs, const std::size_t count) noexcept(is_simd_element_v<T>)
+        {
+            std::size_t i{};
+#if defined(CESA_SIMD_AVX2) || defined(CESA_SIMD_SSE2) || defined(CESA_SIMD_NEON)
+            if constexpr (is_simd_element_v<T>)
+            {
+                if (!std::is_constant_evaluated())
+                {
+                    constexpr std::size_t   lanes     = simd_register_bytes / sizeof(T);
+                    constexpr std::size_t   mask_bits = simd_register_bytes * simd_mask_bits_per_byte;
+                    constexpr std::uint64_t all_equal =
+                        mask_bits == 64 ? ~std::uint64_t{} : (std::uint64_t{1} << mask_bits) - 1;
+                    for (; i + lanes <= count; i += lanes)
+                    {
+                        if (simd_equal_mask<T>(simd_load(lhs + i), simd_load(rhs + i)) != all_equal)
+                        {
+                            return false;
+                        }
+                    }
+                }
+            }
+#endif
+            for (; i < count; ++i)
+            {
+                if (!(lhs[i] == rhs[i]))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * Whether equal_block can compare arrays of capacity elements of type T: the kernels handle
+         * T and the arrays fill exactly one or two registers.
+         */
+#if defined(CESA_SIMD_AVX2) || defined(CESA_SIMD_SSE2) || defined(CESA_SIMD_NEON)
+        template <typename T, std::size_t capacity>
+        inline constexpr bool is_simd_block_v = is_simd_element_v<T> && capacity > 0 &&
+                                                sizeof(T) * capacity % simd_register_bytes == 0 &&
+                                                sizeof(T) * capacity <= 2 * simd_register_bytes;
+#else
+        template <typename T, std::size_t capacity>
+        inline constexpr bool is_simd_block_v = false;
+#endif
+
+        /**
+         * Whether the first count elements of two arrays of capacity elements are pairwise equal,
+         * like equal_elements(lhs, rhs, count). If is_simd_block_v<T, capacity>, the whole arrays are
+         * compared at once, without a loop, and the slots past count are masked out of the result, so
+         * they may hold any bytes.
+         */
+        template <std::size_t capacity, typename T>
+        [[nodiscard]] inline bool
+        equal_block(const T *lhs, const T *rhs, const std::size_t count) noexcept(is_simd_element_v<T>)
+        {
+#if defined(CESA_SIMD_AVX2) || defined(CESA_SIMD_SSE2) || defined(CESA_SIMD_NEON)
+            if constexpr (is_simd_block_v<T, capacity>)
+            {
+                constexpr std::size_t lanes        = simd_register_bytes / sizeof(T);
+                constexpr std::size_t element_bits = sizeof(T) * simd_mask_bits_per_byte;
+                // The mask bits of the first `elements` lanes of a register
+                constexpr auto valid = [](const std::size_t elements) noexcept {
+                    const std::size_t bits = (elements < lanes ? elements : lanes) * element_bits;
+                    return bits == 64 ? ~std::uint64_t{} : (std::uint64_t{1} << bits) - 1;
+                };
+                std::uint64_t differ = ~simd_equal_mask<T>(simd_load(lhs), simd_load(rhs)) & valid(count);
+                if constexpr (capacity > lanes)
+                {
+                    differ |= ~simd_equal_mask<T>(simd_load(lhs + lanes), simd_load(rhs + lanes)) &
+                              valid(count > lanes ? count - lanes : 0);
+                }
+                return differ == 0;
+            }
+            else
+#endif
+            {
+                return equal_elements(lhs, rhs, count);
+            }
+        }
+    }
+}
+
+#endif
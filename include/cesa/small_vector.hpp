@@ -0,0 +1,1042 @@
+#ifndef CESA_SMALL_VECTOR_HPP
+#define CESA_SMALL_VECTOR_HPP
+
+/**
+ * small_vector.hpp
+ *
+ * A vector with inline storage for a small number of elements that spills to an allocator beyond it.
+ *
+ * The cesa::small_vector class keeps up to inline_elements elements in inline storage, exactly like
+ * cesa::vector, so the common case never allocates. Growing past that moves the elements to a
+ * buffer obtained from the allocator, instead of reporting "capacity exceeded". The buffer grows
+ * geometrically from there, like std::vector.
+ *
+ * Any standard allocator may be used. cesa::pmr::small_vector uses std::pmr::polymorphic_allocator,
+ * so the spill path can be served by a std::pmr::monotonic_buffer_resource, a pool, or any other
+ * std::pmr::memory_resource instead of the global heap. The resource must outlive the vector.
+ *
+ * Attention:
+ * Iterator Invalidation:
+ * Follows the rules of std::vector: an insertion that exceeds capacity() invalidates all iterators
+ * and references, including the move from inline storage to the allocator. Moving a small_vector
+ * whose elements are inline invalidates iterators to them, unlike std::vector.
+ */
+
+#include "config.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+namespace cesa
+{
+    template <typename T, std::size_t inline_elements, typename Allocator = std::allocator<T> >
+    class small_vector
+    {
+        static_assert(inline_elements > 0, "small_vector needs room for at least one inline element");
+        static_assert(std::is_same_v<typename std::allocator_traits<Allocator>::value_type, T>,
+                      "small_vector allocator must allocate T");
+        static_assert(std::is_same_v<typename std::allocator_traits<Allocator>::pointer, T *>,
+                      "small_vector requires an allocator with raw pointers");
+        static_assert(detail::check_inline_budget<sizeof(T) * inline_elements>(),
+                      "small_vector inline storage exceeds CESA_MAX_INLINE_BYTES");
+
+    public:
+        using value_type             = T;
+        using allocator_type         = Allocator;
+        using size_type              = std::size_t;
+        using difference_type        = std::ptrdiff_t;
+        using reference              = value_type &;
+        using const_reference        = const value_type &;
+        using pointer                = value_type *;
+        using const_pointer          = const value_type *;
+        using iterator               = value_type *;
+        using const_iterator         = const value_type *;
+        using reverse_iterator       = std::reverse_iterator<value_type *>;
+        using const_reverse_iterator = std::reverse_iterator<const value_type *>;
+
+        constexpr small_vector() noexcept(noexcept(allocator_type()));
+
+        explicit constexpr small_vector(const allocator_type &allocator) noexcept;
+
+        constexpr small_vector(std::initializer_list<value_type> initializer_list,
+                               const allocator_type             &allocator = allocator_type());
+
+        constexpr small_vector(with_size_t, size_type count, const value_type &value,
+                               const allocator_type &allocator = allocator_type());
+
+        template <class InputIt, typename = std::enable_if_t<std::is_base_of_v<
+                      std::input_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category> > >
+        constexpr small_vector(from_range_t, InputIt first, InputIt last,
+                               const allocator_type &allocator = allocator_type());
+
+        constexpr small_vector(const small_vector &other);
+
+        /**
+         * Moving an inline small_vector relocates its elements, so the moves are noexcept only if
+         * value_type is trivially relocatable or nothrow move constructible.
+         */
+        constexpr small_vector(small_vector &&other) noexcept(nothrow_relocatable_);
+
+        constexpr small_vector &operator=(const small_vector &other);
+
+        constexpr small_vector &operator=(small_vector &&other) noexcept(
+            nothrow_relocatable_ && (std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
+                                     std::allocator_traits<Allocator>::is_always_equal::value));
+
+        constexpr ~small_vector();
+
+        [[nodiscard]] constexpr allocator_type get_allocator() const noexcept;
+
+
+        /*** Element access ***/
+
+        constexpr reference operator[](size_type i);
+
+        constexpr const_reference operator[](size_type i) const;
+
+        [[nodiscard]] constexpr reference at(size_type pos);
+
+        [[nodiscard]] constexpr const_reference at(size_type pos) const;
+
+        [[nodiscard]] constexpr reference front();
+
+        [[nodiscard]] constexpr const_reference front() const;
+
+        [[nodiscard]] constexpr reference back();
+
+        [[nodiscard]] constexpr const_reference back() const;
+
+        [[nodiscard]] constexpr value_type *data() noexcept;
+
+        [[nodiscard]] constexpr const value_type *data() const noexcept;
+
+
+        /*** Iterators ***/
+
+        [[nodiscard]] constexpr iterator begin() noexcept;
+
+        [[nodiscard]] constexpr const_iterator begin() const noexcept;
+
+        [[nodiscard]] constexpr const_iterator cbegin() const noexcept;
+
+        [[nodiscard]] constexpr iterator end() noexcept;
+
+        [[nodiscard]] constexpr const_iterator end() const noexcept;
+
+        [[nodiscard]] constexpr const_iterator cend() const noexcept;
+
+        [[nodiscard]] constexpr reverse_iterator rbegin() noexcept;
+
+        [[nodiscard]] constexpr const_reverse_iterator rbegin() const noexcept;
+
+        [[nodiscard]] constexpr reverse_iterator rend() noexcept;
+
+        [[nodiscard]] constexpr const_reverse_iterator rend() const noexcept;
+
+
+        /*** Capacity ***/
+
+        [[nodiscard]] constexpr bool empty() const noexcept;
+
+        [[nodiscard]] constexpr size_type size() const noexcept;
+
+        [[nodiscard]] constexpr size_type max_size() const noexcept;
+
+        [[nodiscard]] constexpr size_type capacity() const noexcept;
+
+        /**
+         * Whether the elements live in the inline storage, i.e. nothing has been allocated.
+         */
+        [[nodiscard]] constexpr bool is_inline() const noexcept;
+
+        constexpr void reserve(size_type new_capacity);
+
+        /**
+         * Moves the elements back to the inline storage if they fit, releasing the allocation.
+         */
+        constexpr void shrink_to_fit();
+
+        constexpr void resize(size_type count);
+
+        constexpr void resize(size_type count, const value_type &value);
+
+
+        /*** Modifiers ***/
+
+        constexpr void clear() noexcept;
+
+        template <class InputIt, typename = std::enable_if_t<std::is_base_of_v<
+                      std::input_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category> > >
+        constexpr void assign(InputIt first, InputIt last);
+
+        constexpr void assign(std::initializer_list<value_type> initializer_list);
+
+        constexpr iterator insert(const_iterator pos, const value_type &value);
+
+        constexpr iterator insert(const_iterator pos, value_type &&value);
+
+        template <class... Args>
+        constexpr iterator emplace(const_iterator pos, Args &&... args);
+
+        constexpr iterator erase(const_iterator pos);
+
+        constexpr iterator erase(const_iterator first, const_iterator last);
+
+        constexpr reference push_back(const value_type &value);
+
+        constexpr reference push_back(value_type &&value);
+
+        template <class... Args>
+        constexpr reference emplace_back(Args &&... args);
+
+        constexpr void pop_back();
+
+    private:
+        using allocator_traits = std::allocator_traits<Allocator>;
+
+        static constexpr bool nothrow_relocatable_ =
+            is_trivially_relocatable_v<value_type> || std::is_nothrow_move_constructible_v<value_type>;
+
+        union storage_type
+        {
+            constexpr storage_type() noexcept
+            {
+            }
+
+            constexpr ~storage_type()
+            {
+            }
+
+            value_type elements[inline_elements];
+        };
+
+        storage_type                         storage_;
+        pointer                              data_     = storage_.elements;
+        size_type                            size_     = 0;
+        size_type                            capacity_ = inline_elements;
+        [[no_unique_address]] allocator_type allocator_;
+
+        /**
+         * The capacity to grow to so that at least required elements fit.
+         */
+        [[nodiscard]] constexpr size_type next_capacity(size_type required) const;
+
+        /**
+         * Moves the elements to a buffer of new_capacity elements, which is the inline storage if
+         * new_capacity is inline_elements, and an allocation otherwise. If relocating throws, the
+         * new allocation is released and the elements stay where they were.
+         */
+        constexpr void reallocate(size_type new_capacity);
+
+        /**
+         * Releases the allocation, if any, and points data_ back to the inline storage.
+         * The elements must have been destroyed or relocated already.
+         */
+        constexpr void release_allocation() noexcept;
+
+        /**
+         * Steals the allocation or relocates the inline elements of other, leaving other empty.
+         */
+        constexpr void take_elements(small_vector &other) noexcept(nothrow_relocatable_);
+
+        /**
+         * Move-constructs [first, last) to out and destroys the originals. As with
+         * std::move_if_noexcept, the elements are copied instead if their move constructor may
+         * throw and they are copyable, so that a throwing construction leaves the originals intact
+         * and out empty.
+         */
+        static constexpr void relocate(pointer first, pointer last, pointer out) noexcept(nothrow_relocatable_);
+
+        /**
+         * Relocates the elements in [index, size()) count slots towards the end, leaving
+         * [index, index + count) uninitialized. Requires capacity() >= size() + count. If a move
+         * throws, the elements stay in [0, size()), although some may have been moved from.
+         */
+        constexpr void open_gap(size_type index, size_type count);
+
+        /**
+         * Undoes open_gap(index, count) when filling the gap failed, relocating the elements in
+         * [index + count, size() + count) back to index. If a move throws, the elements from index
+         * on are destroyed and size_ is set to index.
+         */
+        constexpr void close_gap(size_type index, size_type count);
+    };
+
+    template <typename T, std::size_t inline_elements, typename Allocator>
+    [[nodiscard]] constexpr bool
+    operator==(const small_vector<T, inline_elements, Allocator> &lhs,
+               const small_vector<T, inline_elements, Allocator> &rhs)
+    {
+        return lhs.size() == rhs.size() && detail::equal_elements(lhs.data(), rhs.data(), lhs.size());
+    }
+
+    namespace pmr
+    {
+        /**
+         * A small_vector whose spill buffer comes from a std::pmr::memory_resource.
+         */
+        template <typename T, std::size_t inline_elements>
+        using small_vector = cesa::small_vector<T, inline_elements, std::pmr::polymorphic_allocator<T> >;
+    }
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr
+cesa::small_vector<T, inline_elements, Allocator>::small_vector() noexcept(noexcept(allocator_type()))
+    : allocator_()
+{
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr
+cesa::small_vector<T, inline_elements, Allocator>::small_vector(const allocator_type &allocator) noexcept
+    : allocator_(allocator)
+{
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr
+cesa::small_vector<T, inline_elements, Allocator>::small_vector(std::initializer_list<value_type> initializer_list,
+                                                                const allocator_type             &allocator)
+    : allocator_(allocator)
+{
+    assign(initializer_list.begin(), initializer_list.end());
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr
+cesa::small_vector<T, inline_elements, Allocator>::small_vector(with_size_t, const size_type count,
+                                                                const value_type     &value,
+                                                                const allocator_type &allocator)
+    : allocator_(allocator)
+{
+    resize(count, value);
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+template <class InputIt, typename>
+constexpr
+cesa::small_vector<T, inline_elements, Allocator>::small_vector(from_range_t, InputIt first, InputIt last,
+                                                                const allocator_type &allocator)
+    : allocator_(allocator)
+{
+    assign(first, last);
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr
+cesa::small_vector<T, inline_elements, Allocator>::small_vector(const small_vector &other)
+    : allocator_(allocator_traits::select_on_container_copy_construction(other.allocator_))
+{
+    assign(other.begin(), other.end());
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr
+cesa::small_vector<T, inline_elements, Allocator>::small_vector(small_vector &&other) noexcept(nothrow_relocatable_)
+    : allocator_(std::move(other.allocator_))
+{
+    take_elements(other);
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr cesa::small_vector<T, inline_elements, Allocator> &
+cesa::small_vector<T, inline_elements, Allocator>::operator=(const small_vector &other)
+{
+    if (this != &other)
+    {
+        if constexpr (allocator_traits::propagate_on_container_copy_assignment::value)
+        {
+            if (allocator_ != other.allocator_)
+            {
+                clear();
+                release_allocation();
+            }
+            allocator_ = other.allocator_;
+        }
+        assign(other.begin(), other.end());
+    }
+    return *this;
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr cesa::small_vector<T, inline_elements, Allocator> &
+cesa::small_vector<T, inline_elements, Allocator>::operator=(small_vector &&other) noexcept(
+    nothrow_relocatable_ && (std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
+                             std::allocator_traits<Allocator>::is_always_equal::value))
+{
+    if (this == &other)
+    {
+        return *this;
+    }
+    clear();
+    if constexpr (allocator_traits::propagate_on_container_move_assignment::value)
+    {
+        release_allocation();
+        allocator_ = std::move(other.allocator_);
+        take_elements(other);
+    }
+    else
+    {
+        if (allocator_ == other.allocator_)
+        {
+            release_allocation();
+            take_elements(other);
+        }
+        else
+        {
+            // The allocation cannot change hands, so move the elements one by one
+            reserve(other.size_);
+            detail::uninitialized_move(other.begin(), other.end(), data_);
+            size_ = other.size_;
+            other.clear();
+        }
+    }
+    return *this;
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr cesa::small_vector<T, inline_elements, Allocator>::~small_vector()
+{
+    clear();
+    release_allocation();
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::allocator_type
+cesa::small_vector<T, inline_elements, Allocator>::get_allocator() const noexcept
+{
+    return allocator_;
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::reference
+cesa::small_vector<T, inline_elements, Allocator>::operator[](const size_type i)
+{
+    return data_[i];
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::const_reference
+cesa::small_vector<T, inline_elements, Allocator>::operator[](const size_type i) const
+{
+    return data_[i];
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::reference
+cesa::small_vector<T, inline_elements, Allocator>::at(const size_type pos)
+{
+    if (pos >= size_)
+    {
+        detail::report_error("index out of range");
+    }
+    return data_[pos];
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::const_reference
+cesa::small_vector<T, inline_elements, Allocator>::at(const size_type pos) const
+{
+    if (pos >= size_)
+    {
+        detail::report_error("index out of range");
+    }
+    return data_[pos];
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::reference
+cesa::small_vector<T, inline_elements, Allocator>::front()
+{
+    return data_[0];
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::const_reference
+cesa::small_vector<T, inline_elements, Allocator>::front() const
+{
+    return data_[0];
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::reference
+cesa::small_vector<T, inline_elements, Allocator>::back()
+{
+    return data_[size_ - 1];
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::const_reference
+cesa::small_vector<T, inline_elements, Allocator>::back() const
+{
+    return data_[size_ - 1];
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::value_type *
+cesa::small_vector<T, inline_elements, Allocator>::data() noexcept
+{
+    return data_;
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr const typename cesa::small_vector<T, inline_elements, Allocator>::value_type *
+cesa::small_vector<T, inline_elements, Allocator>::data() const noexcept
+{
+    return data_;
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::iterator
+cesa::small_vector<T, inline_elements, Allocator>::begin() noexcept
+{
+    return data_;
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::const_iterator
+cesa::small_vector<T, inline_elements, Allocator>::begin() const noexcept
+{
+    return data_;
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::const_iterator
+cesa::small_vector<T, inline_elements, Allocator>::cbegin() const noexcept
+{
+    return data_;
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::iterator
+cesa::small_vector<T, inline_elements, Allocator>::end() noexcept
+{
+    return data_ + size_;
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::const_iterator
+cesa::small_vector<T, inline_elements, Allocator>::end() const noexcept
+{
+    return data_ + size_;
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::const_iterator
+cesa::small_vector<T, inline_elements, Allocator>::cend() const noexcept
+{
+    return data_ + size_;
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::reverse_iterator
+cesa::small_vector<T, inline_elements, Allocator>::rbegin() noexcept
+{
+    return reverse_iterator(end());
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::const_reverse_iterator
+cesa::small_vector<T, inline_elements, Allocator>::rbegin() const noexcept
+{
+    return const_reverse_iterator(end());
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::reverse_iterator
+cesa::small_vector<T, inline_elements, Allocator>::rend() noexcept
+{
+    return reverse_iterator(begin());
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::const_reverse_iterator
+cesa::small_vector<T, inline_elements, Allocator>::rend() const noexcept
+{
+    return const_reverse_iterator(begin());
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr bool
+cesa::small_vector<T, inline_elements, Allocator>::empty() const noexcept
+{
+    return size_ == 0;
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::size_type
+cesa::small_vector<T, inline_elements, Allocator>::size() const noexcept
+{
+    return size_;
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::size_type
+cesa::small_vector<T, inline_elements, Allocator>::max_size() const noexcept
+{
+    return std::max<size_type>(allocator_traits::max_size(allocator_), inline_elements);
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::size_type
+cesa::small_vector<T, inline_elements, Allocator>::capacity() const noexcept
+{
+    return capacity_;
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr bool
+cesa::small_vector<T, inline_elements, Allocator>::is_inline() const noexcept
+{
+    return data_ == storage_.elements;
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr void
+cesa::small_vector<T, inline_elements, Allocator>::reserve(const size_type new_capacity)
+{
+    if (new_capacity > capacity_)
+    {
+        if (new_capacity > max_size())
+        {
+            detail::report_error("small_vector capacity exceeded");
+        }
+        reallocate(new_capacity);
+    }
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr void
+cesa::small_vector<T, inline_elements, Allocator>::shrink_to_fit()
+{
+    if (!is_inline() && size_ <= inline_elements)
+    {
+        reallocate(inline_elements);
+    }
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr void
+cesa::small_vector<T, inline_elements, Allocator>::resize(const size_type count)
+{
+    if (count < size_)
+    {
+        std::destroy(begin() + count, end());
+    }
+    else
+    {
+        reserve(count);
+        detail::uninitialized_value_construct(end(), begin() + count);
+    }
+    size_ = count;
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr void
+cesa::small_vector<T, inline_elements, Allocator>::resize(const size_type count, const value_type &value)
+{
+    if (count < size_)
+    {
+        std::destroy(begin() + count, end());
+    }
+    else if (count > size_)
+    {
+        // Copy first, as value may refer to an element that is about to be relocated
+        const value_type copy(value);
+        reserve(count);
+        detail::uninitialized_fill_n(end(), count - size_, copy);
+    }
+    size_ = count;
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr void
+cesa::small_vector<T, inline_elements, Allocator>::clear() noexcept
+{
+    std::destroy(begin(), end());
+    size_ = 0;
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+template <class InputIt, typename>
+constexpr void
+cesa::small_vector<T, inline_elements, Allocator>::assign(InputIt first, InputIt last)
+{
+    clear();
+    if constexpr (detail::is_forward_iterator_v<InputIt>)
+    {
+        const auto count = static_cast<size_type>(std::distance(first, last));
+        reserve(count);
+        detail::uninitialized_copy(first, last, data_);
+        size_ = count;
+    }
+    else
+    {
+        for (; first != last; ++first)
+        {
+            emplace_back(*first);
+        }
+    }
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr void
+cesa::small_vector<T, inline_elements, Allocator>::assign(std::initializer_list<value_type> initializer_list)
+{
+    assign(initializer_list.begin(), initializer_list.end());
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::iterator
+cesa::small_vector<T, inline_elements, Allocator>::insert(const_iterator pos, const value_type &value)
+{
+    return emplace(pos, value);
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::iterator
+cesa::small_vector<T, inline_elements, Allocator>::insert(const_iterator pos, value_type &&value)
+{
+    return emplace(pos, std::move(value));
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+template <class... Args>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::iterator
+cesa::small_vector<T, inline_elements, Allocator>::emplace(const_iterator pos, Args &&... args)
+{
+    const auto index = static_cast<size_type>(pos - cbegin());
+    if (index == size_)
+    {
+        emplace_back(std::forward<Args>(args)...);
+    }
+    else
+    {
+        // Construct first, as args may refer to an element that is about to be shifted
+        value_type value(std::forward<Args>(args)...);
+        if (size_ == capacity_)
+        {
+            reallocate(next_capacity(size_ + 1));
+        }
+        open_gap(index, 1);
+#if CESA_HAS_EXCEPTIONS
+        try
+        {
+            std::construct_at(data_ + index, std::move(value));
+        }
+        catch (...)
+        {
+            close_gap(index, 1);
+            throw;
+        }
+#else
+        std::construct_at(data_ + index, std::move(value));
+#endif
+        ++size_;
+    }
+    return begin() + index;
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::iterator
+cesa::small_vector<T, inline_elements, Allocator>::erase(const_iterator pos)
+{
+    return erase(pos, pos + 1);
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::iterator
+cesa::small_vector<T, inline_elements, Allocator>::erase(const_iterator first, const_iterator last)
+{
+    const auto index = static_cast<size_type>(first - cbegin());
+    const auto count = static_cast<size_type>(last - first);
+    if (count > 0)
+    {
+        std::move(begin() + index + count, end(), begin() + index);
+        std::destroy(end() - count, end());
+        size_ -= count;
+    }
+    return begin() + index;
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::reference
+cesa::small_vector<T, inline_elements, Allocator>::push_back(const value_type &value)
+{
+    return emplace_back(value);
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::reference
+cesa::small_vector<T, inline_elements, Allocator>::push_back(value_type &&value)
+{
+    return emplace_back(std::move(value));
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+template <class... Args>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::reference
+cesa::small_vector<T, inline_elements, Allocator>::emplace_back(Args &&... args)
+{
+    if (size_ < capacity_)
+    {
+        pointer element = std::construct_at(data_ + size_, std::forward<Args>(args)...);
+        ++size_;
+        return *element;
+    }
+
+    // Construct the new element before relocating, as args may refer to an existing element
+    const size_type new_capacity = next_capacity(size_ + 1);
+    pointer         buffer       = allocator_traits::allocate(allocator_, new_capacity);
+#if CESA_HAS_EXCEPTIONS
+    try
+    {
+        std::construct_at(buffer + size_, std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+        allocator_traits::deallocate(allocator_, buffer, new_capacity);
+        throw;
+    }
+    try
+    {
+        relocate(begin(), end(), buffer);
+    }
+    catch (...)
+    {
+        std::destroy_at(buffer + size_);
+        allocator_traits::deallocate(allocator_, buffer, new_capacity);
+        throw;
+    }
+#else
+    std::construct_at(buffer + size_, std::forward<Args>(args)...);
+    relocate(begin(), end(), buffer);
+#endif
+    release_allocation();
+    data_     = buffer;
+    capacity_ = new_capacity;
+    ++size_;
+    return data_[size_ - 1];
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr void
+cesa::small_vector<T, inline_elements, Allocator>::pop_back()
+{
+    if (size_ > 0)
+    {
+        --size_;
+        std::destroy_at(data_ + size_);
+    }
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr typename cesa::small_vector<T, inline_elements, Allocator>::size_type
+cesa::small_vector<T, inline_elements, Allocator>::next_capacity(const size_type required) const
+{
+    const size_type limit = max_size();
+    if (required > limit)
+    {
+        detail::report_error("small_vector capacity exceeded");
+    }
+    return capacity_ > limit / 2 ? limit : std::max(capacity_ * 2, required);
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr void
+cesa::small_vector<T, inline_elements, Allocator>::reallocate(const size_type new_capacity)
+{
+    pointer buffer = new_capacity == inline_elements ? storage_.elements
+                                                     : allocator_traits::allocate(allocator_, new_capacity);
+#if CESA_HAS_EXCEPTIONS
+    try
+    {
+        relocate(begin(), end(), buffer);
+    }
+    catch (...)
+    {
+        if (buffer != storage_.elements)
+        {
+            allocator_traits::deallocate(allocator_, buffer, new_capacity);
+        }
+        throw;
+    }
+#else
+    relocate(begin(), end(), buffer);
+#endif
+    release_allocation();
+    data_     = buffer;
+    capacity_ = new_capacity;
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr void
+cesa::small_vector<T, inline_elements, Allocator>::release_allocation() noexcept
+{
+    if (!is_inline())
+    {
+        allocator_traits::deallocate(allocator_, data_, capacity_);
+        data_     = storage_.elements;
+        capacity_ = inline_elements;
+    }
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr void
+cesa::small_vector<T, inline_elements, Allocator>::take_elements(small_vector &other) noexcept(nothrow_relocatable_)
+{
+    if (other.is_inline())
+    {
+        relocate(other.begin(), other.end(), data_);
+        size_ = other.size_;
+    }
+    else
+    {
+        data_           = other.data_;
+        size_           = other.size_;
+        capacity_       = other.capacity_;
+        other.data_     = other.storage_.elements;
+        other.capacity_ = inline_elements;
+    }
+    other.size_ = 0;
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr void
+cesa::small_vector<T, inline_elements, Allocator>::relocate(const pointer first, const pointer last,
+                                                            const pointer out) noexcept(nothrow_relocatable_)
+{
+    if (is_trivially_relocatable_v<value_type> && !std::is_constant_evaluated())
+    {
+        if (first != last)
+        {
+            std::memcpy(static_cast<void *>(out), first, static_cast<size_type>(last - first) * sizeof(value_type));
+        }
+    }
+    else
+    {
+        // std::uninitialized_copy and std::uninitialized_move destroy what they constructed on failure
+        if constexpr (std::is_nothrow_move_constructible_v<value_type> || !std::is_copy_constructible_v<value_type>)
+        {
+            detail::uninitialized_move(first, last, out);
+        }
+        else
+        {
+            detail::uninitialized_copy(first, last, out);
+        }
+        std::destroy(first, last);
+    }
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr void
+cesa::small_vector<T, inline_elements, Allocator>::open_gap(const size_type index, const size_type count)
+{
+    if (is_trivially_relocatable_v<value_type> && !std::is_constant_evaluated())
+    {
+        std::memmove(static_cast<void *>(data_ + index + count), data_ + index, (size_ - index) * sizeof(value_type));
+    }
+    else if (std::is_nothrow_move_constructible_v<value_type>)
+    {
+        for (size_type i = size_; i-- > index;)
+        {
+            std::construct_at(data_ + i + count, std::move(data_[i]));
+            std::destroy_at(data_ + i);
+        }
+    }
+    else
+    {
+        // Construct the slots past the end first and shift the rest by assignment, so that every
+        // element stays alive until the shift is complete, as in cesa::vector::open_gap
+        const size_type split       = std::max<size_type>(size_, index + count);
+        size_type       constructed = split;
+        const auto      shift       = [&]
+        {
+            for (; constructed < size_ + count; ++constructed)
+            {
+                std::construct_at(data_ + constructed, std::move_if_noexcept(data_[constructed - count]));
+            }
+            std::move_backward(data_ + index, data_ + split - count, data_ + split);
+        };
+#if CESA_HAS_EXCEPTIONS
+        try
+        {
+            shift();
+        }
+        catch (...)
+        {
+            std::destroy(data_ + split, data_ + constructed);
+            throw;
+        }
+#else
+        shift();
+#endif
+        std::destroy(data_ + index, data_ + std::min<size_type>(size_, index + count));
+    }
+}
+
+template <typename T, std::size_t inline_elements, typename Allocator>
+constexpr void
+cesa::small_vector<T, inline_elements, Allocator>::close_gap(const size_type index, const size_type count)
+{
+    if (is_trivially_relocatable_v<value_type> && !std::is_constant_evaluated())
+    {
+        std::memmove(static_cast<void *>(data_ + index), data_ + index + count, (size_ - index) * sizeof(value_type));
+    }
+    else if (std::is_nothrow_move_constructible_v<value_type>)
+    {
+        for (size_type i = index; i < size_; ++i)
+        {
+            std::construct_at(data_ + i, std::move(data_[i + count]));
+            std::destroy_at(data_ + i + count);
+        }
+    }
+    else
+    {
+        // Construct the uninitialized slots and assign the others, then destroy the elements left
+        // past the end. A failure leaves a hole that cannot be closed without another move.
+        const size_type old_end = size_ + count;
+        size_type       i       = index;
+        const auto      shift   = [&]
+        {
+            for (; i < size_; ++i)
+            {
+                if (i < index + count)
+                {
+                    std::construct_at(data_ + i, std::move_if_noexcept(data_[i + count]));
+                }
+                else
+                {
+                    data_[i] = std::move(data_[i + count]);
+                }
+            }
+        };
+#if CESA_HAS_EXCEPTIONS
+        try
+        {
+            shift();
+        }
+        catch (...)
+        {
+            std::destroy(data_ + index, data_ + std::min<size_type>(i, index + count));
+            std::destroy(data_ + index + count, data_ + old_end);
+            size_ = index;
+            throw;
+        }
+#else
+        shift();
+#endif
+        std::destroy(data_ + std::max<size_type>(size_, index + count), data_ + old_end);
+    }
+}
+
+#endif
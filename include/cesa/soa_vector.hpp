@@ -0,0 +1,884 @@
+#ifndef CESA_SOA_VECTOR_HPP
+#define CESA_SOA_VECTOR_HPP
+
+/**
+ * soa_vector.hpp
+ *
+ * A fixed-capacity structure-of-arrays vector with inline storage.
+ *
+ * The cesa::soa_vector class stores each field of its elements in a separate contiguous column,
+ * so that a loop touching only some of the fields streams through exactly the memory it needs
+ * instead of skipping over the unused fields of every record. Each column starts on its own cache
+ * line. All columns share one size counter.
+ *
+ * The interface follows cesa::vector, except that an element is a set of fields: push_back() takes
+ * a std::tuple, emplace_back() takes one argument per field, and the element accessors and iterators
+ * yield std::tuple of references. column<I>() returns a std::span over field I, which is the
+ * preferred input for SIMD loops and parallel algorithms.
+ *
+ * Every field must be nothrow move constructible or trivially relocatable. Insertion and erasure
+ * shift each column in turn, and a move that throws halfway through one column could not be undone
+ * without moving the other columns back.
+ *
+ * Note:
+ * The iterators are proxy iterators. They work with range-for (including structured bindings) and
+ * the classic iterator-based algorithms, but do not model the C++20 iterator concepts, as
+ * std::tuple of references has no common reference with std::tuple of values before C++23.
+ *
+ * Attention:
+ * Iterator Invalidation:
+ * Follows the rules of cesa::vector: any insertion or erasure invalidates iterators, references
+ * and column spans at or after the affected position.
+ */
+
+#include "config.hpp"
+#include "vector.hpp"
+
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace cesa
+{
+    namespace detail
+    {
+        /**
+         * Uninitialized storage for one column. As in cesa::vector, the elements are a union member,
+         * which is not initialized unless done so explicitly, and can be created with
+         * std::construct_at and accessed during constant evaluation.
+         */
+        template <typename T, std::size_t max_elements>
+        struct soa_column
+        {
+            union storage_type
+            {
+                constexpr storage_type() noexcept
+                {
+                }
+
+                constexpr ~storage_type()
+                {
+                }
+
+                T elements[max_elements];
+            };
+
+            alignas(cache_line_size) alignas(T) storage_type storage;
+
+            [[nodiscard]] constexpr T *
+            data() noexcept
+            {
+                return storage.elements;
+            }
+
+            [[nodiscard]] constexpr const T *
+            data() const noexcept
+            {
+                return storage.elements;
+            }
+        };
+    }
+
+    template <std::size_t max_elements, typename... Fields>
+    class soa_vector
+    {
+        static_assert(sizeof...(Fields) > 0, "soa_vector needs at least one field");
+        static_assert(detail::check_inline_budget<(sizeof(Fields) + ...) * max_elements>(),
+                      "soa_vector inline storage exceeds CESA_MAX_INLINE_BYTES");
+        static_assert(((is_trivially_relocatable_v<Fields> || std::is_nothrow_move_constructible_v<Fields>) && ...),
+                      "soa_vector fields must be nothrow move constructible or trivially relocatable");
+
+        template <bool is_const>
+        class basic_iterator;
+
+    public:
+        using value_type      = std::tuple<Fields...>;
+        using size_type       = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference       = std::tuple<Fields &...>;
+        using const_reference = std::tuple<const Fields &...>;
+        using iterator        = basic_iterator<false>;
+        using const_iterator  = basic_iterator<true>;
+
+        template <std::size_t I>
+        using field_type = std::tuple_element_t<I, value_type>;
+
+        explicit constexpr soa_vector() noexcept = default;
+
+        constexpr soa_vector(const soa_vector &other);
+
+        /**
+         * Moves do not throw: every field is trivially relocatable, which moves its column with
+         * memcpy, or nothrow move constructible.
+         */
+        constexpr soa_vector(soa_vector &&other) noexcept;
+
+        constexpr soa_vector &operator=(const soa_vector &other);
+
+        constexpr soa_vector &operator=(soa_vector &&other) noexcept;
+
+        constexpr ~soa_vector();
+
+
+        /*** Element access ***/
+
+        constexpr reference operator[](size_type i);
+
+        constexpr const_reference operator[](size_type i) const;
+
+        [[nodiscard]] constexpr reference at(size_type pos);
+
+        [[nodiscard]] constexpr const_reference at(size_type pos) const;
+
+        [[nodiscard]] constexpr reference front();
+
+        [[nodiscard]] constexpr const_reference front() const;
+
+        [[nodiscard]] constexpr reference back();
+
+        [[nodiscard]] constexpr const_reference back() const;
+
+        template <std::size_t I>
+        [[nodiscard]] constexpr std::span<field_type<I> > column() noexcept;
+
+        template <std::size_t I>
+        [[nodiscard]] constexpr std::span<const field_type<I> > column() const noexcept;
+
+        template <std::size_t I>
+        [[nodiscard]] constexpr field_type<I> *data() noexcept;
+
+        template <std::size_t I>
+        [[nodiscard]] constexpr const field_type<I> *data() const noexcept;
+
+
+        /*** Iterators ***/
+
+        [[nodiscard]] constexpr iterator begin() noexcept;
+
+        [[nodiscard]] constexpr const_iterator begin() const noexcept;
+
+        [[nodiscard]] constexpr const_iterator cbegin() const noexcept;
+
+        [[nodiscard]] constexpr iterator end() noexcept;
+
+        [[nodiscard]] constexpr const_iterator end() const noexcept;
+
+        [[nodiscard]] constexpr const_iterator cend() const noexcept;
+
+
+        /*** Capacity ***/
+
+        [[nodiscard]] constexpr bool empty() const noexcept;
+
+        [[nodiscard]] constexpr size_type size() const noexcept;
+
+        [[nodiscard]] constexpr size_type max_size() const noexcept;
+
+
+        /*** Modifiers ***/
+
+        constexpr void clear() noexcept;
+
+        constexpr reference push_back(const value_type &value);
+
+        constexpr reference push_back(value_type &&value);
+
+        /**
+         * Appends an element whose field I is constructed from args[I].
+         */
+        template <class... Args, typename = std::enable_if_t<sizeof...(Args) == sizeof...(Fields)> >
+        constexpr reference emplace_back(Args &&... args);
+
+        constexpr iterator insert(const_iterator pos, const value_type &value);
+
+        constexpr iterator insert(const_iterator pos, value_type &&value);
+
+        constexpr iterator erase(const_iterator pos);
+
+        constexpr iterator erase(const_iterator first, const_iterator last);
+
+        constexpr void pop_back();
+
+    private:
+        using size_counter_type = detail::size_counter_t<max_elements>;
+
+        std::tuple<detail::soa_column<Fields, max_elements>...> columns_;
+        size_counter_type                                     size_{};
+
+        template <class F>
+        static constexpr void for_each_field(F &&f);
+
+        /**
+         * Calls construct.template operator()<I>() for every field I in order. Each call must leave
+         * nothing behind if it throws. If one throws, undo.template operator()<I>() is called for
+         * the fields before it, and the exception is rethrown.
+         */
+        template <class Construct, class Undo>
+        static constexpr void construct_fields(Construct &&construct, Undo &&undo);
+
+        /**
+         * Copies or moves the elements of other into this vector, which must be empty.
+         */
+        constexpr void copy_from(const soa_vector &other);
+
+        constexpr void move_from(soa_vector &other) noexcept;
+
+        template <typename Tuple>
+        constexpr void construct_at_end(Tuple &&fields);
+
+        template <typename Tuple>
+        constexpr iterator insert_fields(size_type index, Tuple &&fields);
+
+        /**
+         * Relocates the elements in [index, size()) count slots towards the end, leaving
+         * [index, index + count) uninitialized in every column. Does not update size_.
+         */
+        constexpr void open_gap(size_type index, size_type count);
+
+        /**
+         * Undoes open_gap(index, count) when filling the gap failed.
+         */
+        constexpr void close_gap(size_type index, size_type count);
+    };
+
+    template <std::size_t max_elements, typename... Fields>
+    template <bool is_const>
+    class soa_vector<max_elements, Fields...>::basic_iterator
+    {
+        using owner_type = std::conditional_t<is_const, const soa_vector, soa_vector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = std::tuple<Fields...>;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = std::conditional_t<is_const, const_reference, soa_vector::reference>;
+        using pointer           = void;
+
+        constexpr basic_iterator() noexcept = default;
+
+        constexpr basic_iterator(owner_type *owner, const difference_type index) noexcept
+            : owner_(owner)
+            , index_(index)
+        {
+        }
+
+        template <bool other_const, typename = std::enable_if_t<is_const && !other_const> >
+        constexpr basic_iterator(const basic_iterator<other_const> &other) noexcept
+            : owner_(other.owner_)
+            , index_(other.index_)
+        {
+        }
+
+        constexpr reference
+        operator*() const
+        {
+            return (*owner_)[static_cast<size_type>(index_)];
+        }
+
+        constexpr reference
+        operator[](const difference_type n) const
+        {
+            return (*owner_)[static_cast<size_type>(index_ + n)];
+        }
+
+        constexpr basic_iterator &
+        operator++() noexcept
+        {
+            ++index_;
+            return *this;
+        }
+
+        constexpr basic_iterator
+        operator++(int) noexcept
+        {
+            basic_iterator copy = *this;
+            ++index_;
+            return copy;
+        }
+
+        constexpr basic_iterator &
+        operator--() noexcept
+        {
+            --index_;
+            return *this;
+        }
+
+        constexpr basic_iterator
+        operator--(int) noexcept
+        {
+            basic_iterator copy = *this;
+            --index_;
+            return copy;
+        }
+
+        constexpr basic_iterator &
+        operator+=(const difference_type n) noexcept
+        {
+            index_ += n;
+            return *this;
+        }
+
+        constexpr basic_iterator &
+        operator-=(const difference_type n) noexcept
+        {
+            index_ -= n;
+            return *this;
+        }
+
+        friend constexpr basic_iterator
+        operator+(basic_iterator it, const difference_type n) noexcept
+        {
+            return it += n;
+        }
+
+        friend constexpr basic_iterator
+        operator+(const difference_type n, basic_iterator it) noexcept
+        {
+            return it += n;
+        }
+
+        friend constexpr basic_iterator
+        operator-(basic_iterator it, const difference_type n) noexcept
+        {
+            return it -= n;
+        }
+
+        friend constexpr difference_type
+        operator-(const basic_iterator &lhs, const basic_iterator &rhs) noexcept
+        {
+            return lhs.index_ - rhs.index_;
+        }
+
+        friend constexpr bool
+        operator==(const basic_iterator &lhs, const basic_iterator &rhs) noexcept
+        {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend constexpr auto
+        operator<=>(const basic_iterator &lhs, const basic_iterator &rhs) noexcept
+        {
+            return lhs.index_ <=> rhs.index_;
+        }
+
+        [[nodiscard]] constexpr difference_type
+        index() const noexcept
+        {
+            return index_;
+        }
+
+    private:
+        template <bool>
+        friend class basic_iterator;
+
+        owner_type     *owner_{};
+        difference_type index_{};
+    };
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr
+cesa::soa_vector<max_elements, Fields...>::soa_vector(const soa_vector &other)
+{
+    copy_from(other);
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr
+cesa::soa_vector<max_elements, Fields...>::soa_vector(soa_vector &&other) noexcept
+{
+    move_from(other);
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr cesa::soa_vector<max_elements, Fields...> &
+cesa::soa_vector<max_elements, Fields...>::operator=(const soa_vector &other)
+{
+    if (this != &other)
+    {
+        clear();
+        copy_from(other);
+    }
+    return *this;
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr cesa::soa_vector<max_elements, Fields...> &
+cesa::soa_vector<max_elements, Fields...>::operator=(soa_vector &&other) noexcept
+{
+    if (this != &other)
+    {
+        clear();
+        move_from(other);
+    }
+    return *this;
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr cesa::soa_vector<max_elements, Fields...>::~soa_vector()
+{
+    clear();
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr typename cesa::soa_vector<max_elements, Fields...>::reference
+cesa::soa_vector<max_elements, Fields...>::operator[](const size_type i)
+{
+    return [&]<std::size_t... I>(std::index_sequence<I...>) {
+        return reference(data<I>()[i]...);
+    }(std::index_sequence_for<Fields...>{});
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr typename cesa::soa_vector<max_elements, Fields...>::const_reference
+cesa::soa_vector<max_elements, Fields...>::operator[](const size_type i) const
+{
+    return [&]<std::size_t... I>(std::index_sequence<I...>) {
+        return const_reference(data<I>()[i]...);
+    }(std::index_sequence_for<Fields...>{});
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr typename cesa::soa_vector<max_elements, Fields...>::reference
+cesa::soa_vector<max_elements, Fields...>::at(const size_type pos)
+{
+    if (pos >= size_)
+    {
+        detail::report_error("index out of range");
+    }
+    return (*this)[pos];
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr typename cesa::soa_vector<max_elements, Fields...>::const_reference
+cesa::soa_vector<max_elements, Fields...>::at(const size_type pos) const
+{
+    if (pos >= size_)
+    {
+        detail::report_error("index out of range");
+    }
+    return (*this)[pos];
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr typename cesa::soa_vector<max_elements, Fields...>::reference
+cesa::soa_vector<max_elements, Fields...>::front()
+{
+    return (*this)[0];
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr typename cesa::soa_vector<max_elements, Fields...>::const_reference
+cesa::soa_vector<max_elements, Fields...>::front() const
+{
+    return (*this)[0];
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr typename cesa::soa_vector<max_elements, Fields...>::reference
+cesa::soa_vector<max_elements, Fields...>::back()
+{
+    return (*this)[size_ - 1U];
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr typename cesa::soa_vector<max_elements, Fields...>::const_reference
+cesa::soa_vector<max_elements, Fields...>::back() const
+{
+    return (*this)[size_ - 1U];
+}
+
+template <std::size_t max_elements, typename... Fields>
+template <std::size_t I>
+constexpr std::span<typename cesa::soa_vector<max_elements, Fields...>::template field_type<I> >
+cesa::soa_vector<max_elements, Fields...>::column() noexcept
+{
+    return { data<I>(), size_ };
+}
+
+template <std::size_t max_elements, typename... Fields>
+template <std::size_t I>
+constexpr std::span<const typename cesa::soa_vector<max_elements, Fields...>::template field_type<I> >
+cesa::soa_vector<max_elements, Fields...>::column() const noexcept
+{
+    return { data<I>(), size_ };
+}
+
+template <std::size_t max_elements, typename... Fields>
+template <std::size_t I>
+constexpr typename cesa::soa_vector<max_elements, Fields...>::template field_type<I> *
+cesa::soa_vector<max_elements, Fields...>::data() noexcept
+{
+    return std::get<I>(columns_).data();
+}
+
+template <std::size_t max_elements, typename... Fields>
+template <std::size_t I>
+constexpr const typename cesa::soa_vector<max_elements, Fields...>::template field_type<I> *
+cesa::soa_vector<max_elements, Fields...>::data() const noexcept
+{
+    return std::get<I>(columns_).data();
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr typename cesa::soa_vector<max_elements, Fields...>::iterator
+cesa::soa_vector<max_elements, Fields...>::begin() noexcept
+{
+    return iterator(this, 0);
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr typename cesa::soa_vector<max_elements, Fields...>::const_iterator
+cesa::soa_vector<max_elements, Fields...>::begin() const noexcept
+{
+    return const_iterator(this, 0);
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr typename cesa::soa_vector<max_elements, Fields...>::const_iterator
+cesa::soa_vector<max_elements, Fields...>::cbegin() const noexcept
+{
+    return const_iterator(this, 0);
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr typename cesa::soa_vector<max_elements, Fields...>::iterator
+cesa::soa_vector<max_elements, Fields...>::end() noexcept
+{
+    return iterator(this, size_);
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr typename cesa::soa_vector<max_elements, Fields...>::const_iterator
+cesa::soa_vector<max_elements, Fields...>::end() const noexcept
+{
+    return const_iterator(this, size_);
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr typename cesa::soa_vector<max_elements, Fields...>::const_iterator
+cesa::soa_vector<max_elements, Fields...>::cend() const noexcept
+{
+    return const_iterator(this, size_);
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr bool
+cesa::soa_vector<max_elements, Fields...>::empty() const noexcept
+{
+    return size_ == 0;
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr typename cesa::soa_vector<max_elements, Fields...>::size_type
+cesa::soa_vector<max_elements, Fields...>::size() const noexcept
+{
+    return size_;
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr typename cesa::soa_vector<max_elements, Fields...>::size_type
+cesa::soa_vector<max_elements, Fields...>::max_size() const noexcept
+{
+    return max_elements;
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr void
+cesa::soa_vector<max_elements, Fields...>::clear() noexcept
+{
+    for_each_field([&]<std::size_t I>() {
+        std::destroy_n(data<I>(), size_);
+    });
+    size_ = 0;
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr typename cesa::soa_vector<max_elements, Fields...>::reference
+cesa::soa_vector<max_elements, Fields...>::push_back(const value_type &value)
+{
+    construct_at_end(value);
+    return back();
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr typename cesa::soa_vector<max_elements, Fields...>::reference
+cesa::soa_vector<max_elements, Fields...>::push_back(value_type &&value)
+{
+    construct_at_end(std::move(value));
+    return back();
+}
+
+template <std::size_t max_elements, typename... Fields>
+template <class... Args, typename>
+constexpr typename cesa::soa_vector<max_elements, Fields...>::reference
+cesa::soa_vector<max_elements, Fields...>::emplace_back(Args &&... args)
+{
+    construct_at_end(std::forward_as_tuple(std::forward<Args>(args)...));
+    return back();
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr typename cesa::soa_vector<max_elements, Fields...>::iterator
+cesa::soa_vector<max_elements, Fields...>::insert(const_iterator pos, const value_type &value)
+{
+    return insert_fields(static_cast<size_type>(pos.index()), value);
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr typename cesa::soa_vector<max_elements, Fields...>::iterator
+cesa::soa_vector<max_elements, Fields...>::insert(const_iterator pos, value_type &&value)
+{
+    return insert_fields(static_cast<size_type>(pos.index()), std::move(value));
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr typename cesa::soa_vector<max_elements, Fields...>::iterator
+cesa::soa_vector<max_elements, Fields...>::erase(const_iterator pos)
+{
+    return erase(pos, pos + 1);
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr typename cesa::soa_vector<max_elements, Fields...>::iterator
+cesa::soa_vector<max_elements, Fields...>::erase(const_iterator first, const_iterator last)
+{
+    const auto index = static_cast<size_type>(first.index());
+    const auto count = static_cast<size_type>(last - first);
+    if (count > 0)
+    {
+        for_each_field([&]<std::size_t I>() {
+            using field  = field_type<I>;
+            field *begin = data<I>();
+            if (is_trivially_relocatable_v<field> && !std::is_constant_evaluated())
+            {
+                std::destroy(begin + index, begin + index + count);
+                std::memmove(static_cast<void *>(begin + index), begin + index + count,
+                             (size_ - index - count) * sizeof(field));
+            }
+            else
+            {
+                std::move(begin + index + count, begin + size_, begin + index);
+                std::destroy(begin + size_ - count, begin + size_);
+            }
+        });
+        size_ = static_cast<size_counter_type>(size_ - count);
+    }
+    return iterator(this, static_cast<difference_type>(index));
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr void
+cesa::soa_vector<max_elements, Fields...>::pop_back()
+{
+    if (size_ > 0)
+    {
+        size_ -= 1;
+        for_each_field([&]<std::size_t I>() {
+            std::destroy_at(data<I>() + size_);
+        });
+    }
+}
+
+template <std::size_t max_elements, typename... Fields>
+template <class F>
+constexpr void
+cesa::soa_vector<max_elements, Fields...>::for_each_field(F &&f)
+{
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (f.template operator()<I>(), ...);
+    }(std::index_sequence_for<Fields...>{});
+}
+
+template <std::size_t max_elements, typename... Fields>
+template <class Construct, class Undo>
+constexpr void
+cesa::soa_vector<max_elements, Fields...>::construct_fields(Construct &&construct, Undo &&undo)
+{
+#if CESA_HAS_EXCEPTIONS
+    std::size_t constructed{};
+    try
+    {
+        for_each_field([&]<std::size_t I>() {
+            construct.template operator()<I>();
+            ++constructed;
+        });
+    }
+    catch (...)
+    {
+        for_each_field([&]<std::size_t I>() {
+            if (I < constructed)
+            {
+                undo.template operator()<I>();
+            }
+        });
+        throw;
+    }
+#else
+    (void)undo;
+    for_each_field([&]<std::size_t I>() {
+        construct.template operator()<I>();
+    });
+#endif
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr void
+cesa::soa_vector<max_elements, Fields...>::copy_from(const soa_vector &other)
+{
+    const size_type count = other.size_;
+    construct_fields(
+        [&]<std::size_t I>() {
+            detail::uninitialized_copy(other.template data<I>(), other.template data<I>() + count, data<I>());
+        },
+        [&]<std::size_t I>() {
+            std::destroy_n(data<I>(), count);
+        });
+    size_ = other.size_;
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr void
+cesa::soa_vector<max_elements, Fields...>::move_from(soa_vector &other) noexcept
+{
+    // A relocated column is a bitwise copy, which other keeps owning until every column has moved
+    const size_type count = other.size_;
+    construct_fields(
+        [&]<std::size_t I>() {
+            using field = field_type<I>;
+            if (is_trivially_relocatable_v<field> && !std::is_constant_evaluated())
+            {
+                std::memcpy(static_cast<void *>(data<I>()), other.template data<I>(), count * sizeof(field));
+            }
+            else
+            {
+                detail::uninitialized_move(other.template data<I>(), other.template data<I>() + count, data<I>());
+            }
+        },
+        [&]<std::size_t I>() {
+            if (!is_trivially_relocatable_v<field_type<I> > || std::is_constant_evaluated())
+            {
+                std::destroy_n(data<I>(), count);
+            }
+        });
+    for_each_field([&]<std::size_t I>() {
+        if (!is_trivially_relocatable_v<field_type<I> > || std::is_constant_evaluated())
+        {
+            std::destroy_n(other.template data<I>(), count);
+        }
+    });
+    size_       = other.size_;
+    other.size_ = 0;
+}
+
+template <std::size_t max_elements, typename... Fields>
+template <typename Tuple>
+constexpr void
+cesa::soa_vector<max_elements, Fields...>::construct_at_end(Tuple &&fields)
+{
+    if (size_ >= max_elements)
+    {
+        detail::report_error("soa_vector capacity exceeded");
+    }
+    construct_fields(
+        [&]<std::size_t I>() {
+            std::construct_at(data<I>() + size_, std::get<I>(std::forward<Tuple>(fields)));
+        },
+        [&]<std::size_t I>() {
+            std::destroy_at(data<I>() + size_);
+        });
+    size_ += 1;
+}
+
+template <std::size_t max_elements, typename... Fields>
+template <typename Tuple>
+constexpr typename cesa::soa_vector<max_elements, Fields...>::iterator
+cesa::soa_vector<max_elements, Fields...>::insert_fields(const size_type index, Tuple &&fields)
+{
+    if (size_ >= max_elements)
+    {
+        detail::report_error("soa_vector capacity exceeded");
+    }
+    const auto construct = [&]<std::size_t I>() {
+        std::construct_at(data<I>() + index, std::get<I>(std::forward<Tuple>(fields)));
+    };
+    const auto undo = [&]<std::size_t I>() {
+        std::destroy_at(data<I>() + index);
+    };
+    open_gap(index, 1);
+#if CESA_HAS_EXCEPTIONS
+    try
+    {
+        construct_fields(construct, undo);
+    }
+    catch (...)
+    {
+        close_gap(index, 1);
+        throw;
+    }
+#else
+    construct_fields(construct, undo);
+#endif
+    size_ += 1;
+    return iterator(this, static_cast<difference_type>(index));
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr void
+cesa::soa_vector<max_elements, Fields...>::open_gap(const size_type index, const size_type count)
+{
+    if (index >= size_ || count == 0)
+    {
+        return;
+    }
+    for_each_field([&]<std::size_t I>() {
+        using field  = field_type<I>;
+        field *begin = data<I>();
+        if (is_trivially_relocatable_v<field> && !std::is_constant_evaluated())
+        {
+            std::memmove(static_cast<void *>(begin + index + count), begin + index, (size_ - index) * sizeof(field));
+        }
+        else
+        {
+            for (size_type i = size_; i-- > index;)
+            {
+                std::construct_at(begin + i + count, std::move(begin[i]));
+                std::destroy_at(begin + i);
+            }
+        }
+    });
+}
+
+template <std::size_t max_elements, typename... Fields>
+constexpr void
+cesa::soa_vector<max_elements, Fields...>::close_gap(const size_type index, const size_type count)
+{
+    if (index >= size_ || count == 0)
+    {
+        return;
+    }
+    for_each_field([&]<std::size_t I>() {
+        using field  = field_type<I>;
+        field *begin = data<I>();
+        if (is_trivially_relocatable_v<field> && !std::is_constant_evaluated())
+        {
+            std::memmove(static_cast<void *>(begin + index), begin + index + count, (size_ - index) * sizeof(field));
+        }
+        else
+        {
+            for (size_type i = index; i < size_; ++i)
+            {
+                std::construct_at(begin + i, std::move(begin[i + count]));
+                std::destroy_at(begin + i + count);
+            }
+        }
+    });
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,316 @@
+#ifndef CESA_SPSC_QUEUE_HPP
+#define CESA_SPSC_QUEUE_HPP
+
+/**
+ * spsc_queue.hpp
+ *
+ * A fixed-capacity, lock-free single-producer/single-consumer ring buffer with inline storage.
+ *
+ * The cesa::spsc_queue class hands elements from exactly one producer thread to exactly one
+ * consumer thread without locks or heap allocation. The capacity must be a power of two. The
+ * producer and consumer indices live on separate cache lines, together with a cached copy of the
+ * other side's index, so that the two threads only touch each other's cache line when the queue
+ * looks full or empty.
+ *
+ * The bulk operations (push_n, pop_n, try_push_batch and pop_batch) publish all of their elements
+ * with a single release store, so handing over a whole cesa::vector costs one atomic operation.
+ *
+ * Attention:
+ * Calling the producer members (try_push, try_emplace, push_n, try_push_batch) from more than one
+ * thread, or the consumer members (try_pop, pop_n, pop_batch) from more than one thread, is a data
+ * race.
+ */
+
+#include "config.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace cesa
+{
+    template <typename T, std::size_t capacity_elements>
+    class spsc_queue
+    {
+        static_assert(capacity_elements > 0 && (capacity_elements & (capacity_elements - 1)) == 0,
+                      "spsc_queue capacity must be a power of two");
+        static_assert(detail::check_inline_budget<sizeof(T) * capacity_elements>(),
+                      "spsc_queue inline storage exceeds CESA_MAX_INLINE_BYTES");
+
+    public:
+        using value_type = T;
+        using size_type  = std::size_t;
+
+        constexpr spsc_queue() noexcept = default;
+
+        spsc_queue(const spsc_queue &) = delete;
+
+        spsc_queue &operator=(const spsc_queue &) = delete;
+
+        ~spsc_queue();
+
+
+        /*** Producer ***/
+
+        [[nodiscard]] bool try_push(const value_type &value);
+
+        [[nodiscard]] bool try_push(value_type &&value);
+
+        template <class... Args>
+        [[nodiscard]] bool try_emplace(Args &&... args);
+
+        /**
+         * Pushes up to count elements read from first, and returns how many were pushed.
+         */
+        template <class InputIt>
+        size_type push_n(InputIt first, size_type count);
+
+        /**
+         * Pushes all elements of batch if they fit, otherwise pushes nothing.
+         */
+        template <std::size_t batch_elements, std::size_t batch_alignment>
+        [[nodiscard]] bool try_push_batch(const vector<value_type, batch_elements, batch_alignment> &batch);
+
+
+        /*** Consumer ***/
+
+        [[nodiscard]] bool try_pop(value_type &out);
+
+        /**
+         * Pops up to count elements, move-assigning them to out, and returns how many were popped.
+         */
+        template <class OutputIt>
+        size_type pop_n(OutputIt out, size_type count);
+
+        /**
+         * Pops as many elements as fit in the remaining capacity of sink, appending them to it.
+         * Returns how many were popped.
+         */
+        template <std::size_t batch_elements, std::size_t batch_alignment>
+        size_type pop_batch(vector<value_type, batch_elements, batch_alignment> &sink);
+
+
+        /*** Capacity ***/
+
+        /**
+         * The number of elements in the queue. Only exact when called from the producer or
+         * consumer thread while the other side is idle.
+         */
+        [[nodiscard]] size_type size_approx() const noexcept;
+
+        [[nodiscard]] bool empty_approx() const noexcept;
+
+        [[nodiscard]] static constexpr size_type capacity() noexcept;
+
+    private:
+        static constexpr size_type mask_ = capacity_elements - 1;
+
+        // Consumer cache line
+        alignas(detail::cache_line_size) std::atomic<size_type> head_{};
+        size_type                                               cached_tail_{};
+
+        // Producer cache line
+        alignas(detail::cache_line_size) std::atomic<size_type> tail_{};
+        size_type                                               cached_head_{};
+
+        alignas(detail::cache_line_size) alignas(value_type) std::byte storage_[sizeof(value_type) * capacity_elements];
+
+        [[nodiscard]] value_type *slot(size_type index) noexcept;
+
+        [[nodiscard]] size_type reserve_for_push(size_type tail, size_type count) noexcept;
+
+        [[nodiscard]] size_type reserve_for_pop(size_type head, size_type count) noexcept;
+    };
+}
+
+template <typename T, std::size_t capacity_elements>
+cesa::spsc_queue<T, capacity_elements>::~spsc_queue()
+{
+    if constexpr (!std::is_trivially_destructible_v<value_type>)
+    {
+        const size_type tail = tail_.load(std::memory_order_acquire);
+        for (size_type head = head_.load(std::memory_order_relaxed); head != tail; ++head)
+        {
+            std::destroy_at(slot(head));
+        }
+    }
+}
+
+template <typename T, std::size_t capacity_elements>
+bool
+cesa::spsc_queue<T, capacity_elements>::try_push(const value_type &value)
+{
+    return try_emplace(value);
+}
+
+template <typename T, std::size_t capacity_elements>
+bool
+cesa::spsc_queue<T, capacity_elements>::try_push(value_type &&value)
+{
+    return try_emplace(std::move(value));
+}
+
+template <typename T, std::size_t capacity_elements>
+template <class... Args>
+bool
+cesa::spsc_queue<T, capacity_elements>::try_emplace(Args &&... args)
+{
+    const size_type tail = tail_.load(std::memory_order_relaxed);
+    if (reserve_for_push(tail, 1) == 0)
+    {
+        return false;
+    }
+    new(slot(tail)) value_type(std::forward<Args>(args)...);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T, std::size_t capacity_elements>
+template <class InputIt>
+typename cesa::spsc_queue<T, capacity_elements>::size_type
+cesa::spsc_queue<T, capacity_elements>::push_n(InputIt first, const size_type count)
+{
+    const size_type tail   = tail_.load(std::memory_order_relaxed);
+    const size_type pushed = reserve_for_push(tail, count);
+    // Copy in at most two contiguous chunks, split where the ring wraps around
+    const size_type start = tail & mask_;
+    const size_type chunk = std::min(pushed, capacity_elements - start);
+    first = std::ranges::uninitialized_copy_n(first, chunk, slot(start), slot(start) + chunk).in;
+    std::ranges::uninitialized_copy_n(first, pushed - chunk, slot(0), slot(0) + (pushed - chunk));
+    tail_.store(tail + pushed, std::memory_order_release);
+    return pushed;
+}
+
+template <typename T, std::size_t capacity_elements>
+template <std::size_t batch_elements, std::size_t batch_alignment>
+bool
+cesa::spsc_queue<T, capacity_elements>::try_push_batch(const vector<value_type, batch_elements, batch_alignment> &batch)
+{
+    const size_type tail = tail_.load(std::memory_order_relaxed);
+    if (reserve_for_push(tail, batch.size()) < batch.size())
+    {
+        return false;
+    }
+    const size_type start = tail & mask_;
+    const size_type chunk = std::min(batch.size(), capacity_elements - start);
+    std::uninitialized_copy(batch.begin(), batch.begin() + chunk, slot(start));
+    std::uninitialized_copy(batch.begin() + chunk, batch.end(), slot(0));
+    tail_.store(tail + batch.size(), std::memory_order_release);
+    return true;
+}
+
+template <typename T, std::size_t capacity_elements>
+bool
+cesa::spsc_queue<T, capacity_elements>::try_pop(value_type &out)
+{
+    return pop_n(&out, 1) == 1;
+}
+
+template <typename T, std::size_t capacity_elements>
+template <class OutputIt>
+typename cesa::spsc_queue<T, capacity_elements>::size_type
+cesa::spsc_queue<T, capacity_elements>::pop_n(OutputIt out, const size_type count)
+{
+    const size_type head   = head_.load(std::memory_order_relaxed);
+    const size_type popped = reserve_for_pop(head, count);
+    const size_type start  = head & mask_;
+    const size_type chunk  = std::min(popped, capacity_elements - start);
+    out = std::move(slot(start), slot(start) + chunk, out);
+    std::move(slot(0), slot(0) + (popped - chunk), out);
+    std::destroy(slot(start), slot(start) + chunk);
+    std::destroy(slot(0), slot(0) + (popped - chunk));
+    head_.store(head + popped, std::memory_order_release);
+    return popped;
+}
+
+template <typename T, std::size_t capacity_elements>
+template <std::size_t batch_elements, std::size_t batch_alignment>
+typename cesa::spsc_queue<T, capacity_elements>::size_type
+cesa::spsc_queue<T, capacity_elements>::pop_batch(vector<value_type, batch_elements, batch_alignment> &sink)
+{
+    const size_type head   = head_.load(std::memory_order_relaxed);
+    const size_type popped = reserve_for_pop(head, sink.max_size() - sink.size());
+    const size_type start  = head & mask_;
+    const size_type chunk  = std::min(popped, capacity_elements - start);
+    if constexpr (std::is_trivial_v<value_type>)
+    {
+        const auto destination = sink.append_uninitialized(popped);
+        std::copy(slot(start), slot(start) + chunk, destination.begin());
+        std::copy(slot(0), slot(0) + (popped - chunk), destination.begin() + chunk);
+    }
+    else
+    {
+        for (size_type i{}; i < popped; ++i)
+        {
+            value_type *element = slot(head + i);
+            sink.unchecked_emplace_back(std::move(*element));
+            std::destroy_at(element);
+        }
+    }
+    head_.store(head + popped, std::memory_order_release);
+    return popped;
+}
+
+template <typename T, std::size_t capacity_elements>
+typename cesa::spsc_queue<T, capacity_elements>::size_type
+cesa::spsc_queue<T, capacity_elements>::size_approx() const noexcept
+{
+    const size_type head = head_.load(std::memory_order_acquire);
+    const size_type tail = tail_.load(std::memory_order_acquire);
+    return tail - head;
+}
+
+template <typename T, std::size_t capacity_elements>
+bool
+cesa::spsc_queue<T, capacity_elements>::empty_approx() const noexcept
+{
+    return size_approx() == 0;
+}
+
+template <typename T, std::size_t capacity_elements>
+constexpr typename cesa::spsc_queue<T, capacity_elements>::size_type
+cesa::spsc_queue<T, capacity_elements>::capacity() noexcept
+{
+    return capacity_elements;
+}
+
+template <typename T, std::size_t capacity_elements>
+typename cesa::spsc_queue<T, capacity_elements>::value_type *
+cesa::spsc_queue<T, capacity_elements>::slot(const size_type index) noexcept
+{
+    return reinterpret_cast<value_type *>(&storage_[(index & mask_) * sizeof(value_type)]);
+}
+
+template <typename T, std::size_t capacity_elements>
+typename cesa::spsc_queue<T, capacity_elements>::size_type
+cesa::spsc_queue<T, capacity_elements>::reserve_for_push(const size_type tail, const size_type count) noexcept
+{
+    size_type free = capacity_elements - (tail - cached_head_);
+    if (free < count)
+    {
+        cached_head_ = head_.load(std::memory_order_acquire);
+        free         = capacity_elements - (tail - cached_head_);
+    }
+    return std::min(free, count);
+}
+
+template <typename T, std::size_t capacity_elements>
+typename cesa::spsc_queue<T, capacity_elements>::size_type
+cesa::spsc_queue<T, capacity_elements>::reserve_for_pop(const size_type head, const size_type count) noexcept
+{
+    size_type available = cached_tail_ - head;
+    if (available < count)
+    {
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+        available    = cached_tail_ - head;
+    }
+    return std::min(available, count);
+}
+
+#endif
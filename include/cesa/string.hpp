@@ -0,0 +1,761 @@
+#ifndef CESA_STRING_HPP
+#define CESA_STRING_HPP
+
+/**
+ * string.hpp
+ *
+ * A fixed-capacity, NUL-terminated string with inline storage.
+ *
+ * The cesa::basic_string class follows the storage model of cesa::vector: the characters live
+ * inside the object, next to a size counter that is only as wide as max_length requires. It never
+ * allocates, which makes it suitable for short identifiers such as protocol field names, symbols and
+ * log tags that exceed the small string optimization of std::string.
+ *
+ * The buffer holds max_length + 1 characters so that c_str() is always NUL-terminated. Only the
+ * characters up to the terminator are written at run time; during constant evaluation the whole
+ * buffer is zeroed, so that a string can be a constexpr variable, e.g. a log tag. Comparison,
+ * search and hashing only ever touch the live prefix and go through std::char_traits, which maps
+ * to memcmp/memchr for the standard character types.
+ *
+ * Attention:
+ * Iterators, pointers and string views into a cesa::basic_string are invalidated by any operation
+ * that changes its contents, and by moving or destroying the string.
+ */
+
+#include "config.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace cesa
+{
+    template <typename CharT, std::size_t max_length>
+    class basic_string
+    {
+        static_assert(detail::check_inline_budget<sizeof(CharT) * (max_length + 1)>(),
+                      "basic_string inline storage exceeds CESA_MAX_INLINE_BYTES");
+
+    public:
+        using traits_type            = std::char_traits<CharT>;
+        using value_type             = CharT;
+        using size_type              = std::size_t;
+        using difference_type        = std::ptrdiff_t;
+        using reference              = value_type &;
+        using const_reference        = const value_type &;
+        using pointer                = value_type *;
+        using const_pointer          = const value_type *;
+        using iterator               = value_type *;
+        using const_iterator         = const value_type *;
+        using reverse_iterator       = std::reverse_iterator<value_type *>;
+        using const_reverse_iterator = std::reverse_iterator<const value_type *>;
+        using view_type              = std::basic_string_view<CharT>;
+
+        static constexpr size_type npos = view_type::npos;
+
+        constexpr basic_string() noexcept;
+
+        constexpr basic_string(const CharT *str);
+
+        explicit constexpr basic_string(view_type view);
+
+        constexpr basic_string(size_type count, CharT ch);
+
+        constexpr basic_string(const basic_string &other) noexcept;
+
+        constexpr basic_string &operator=(const basic_string &other) noexcept;
+
+        constexpr basic_string &operator=(view_type view);
+
+        constexpr basic_string &operator=(const CharT *str);
+
+
+        /*** Element access ***/
+
+        constexpr reference operator[](size_type i);
+
+        constexpr const_reference operator[](size_type i) const;
+
+        [[nodiscard]] constexpr reference at(size_type pos);
+
+        [[nodiscard]] constexpr const_reference at(size_type pos) const;
+
+        [[nodiscard]] constexpr reference front();
+
+        [[nodiscard]] constexpr const_reference front() const;
+
+        [[nodiscard]] constexpr reference back();
+
+        [[nodiscard]] constexpr const_reference back() const;
+
+        [[nodiscard]] constexpr CharT *data() noexcept;
+
+        [[nodiscard]] constexpr const CharT *data() const noexcept;
+
+        [[nodiscard]] constexpr const CharT *c_str() const noexcept;
+
+        [[nodiscard]] constexpr view_type view() const noexcept;
+
+        constexpr operator view_type() const noexcept;
+
+
+        /*** Iterators ***/
+
+        [[nodiscard]] constexpr iterator begin() noexcept;
+
+        [[nodiscard]] constexpr const_iterator begin() const noexcept;
+
+        [[nodiscard]] constexpr const_iterator cbegin() const noexcept;
+
+        [[nodiscard]] constexpr iterator end() noexcept;
+
+        [[nodiscard]] constexpr const_iterator end() const noexcept;
+
+        [[nodiscard]] constexpr const_iterator cend() const noexcept;
+
+        [[nodiscard]] constexpr reverse_iterator rbegin() noexcept;
+
+        [[nodiscard]] constexpr const_reverse_iterator rbegin() const noexcept;
+
+        [[nodiscard]] constexpr reverse_iterator rend() noexcept;
+
+        [[nodiscard]] constexpr const_reverse_iterator rend() const noexcept;
+
+
+        /*** Capacity ***/
+
+        [[nodiscard]] constexpr bool empty() const noexcept;
+
+        [[nodiscard]] constexpr size_type size() const noexcept;
+
+        [[nodiscard]] constexpr size_type length() const noexcept;
+
+        [[nodiscard]] constexpr size_type max_size() const noexcept;
+
+
+        /*** Modifiers ***/
+
+        constexpr void clear() noexcept;
+
+        constexpr void push_back(CharT ch);
+
+        constexpr void pop_back();
+
+        constexpr basic_string &append(view_type view);
+
+        constexpr basic_string &append(size_type count, CharT ch);
+
+        constexpr basic_string &operator+=(view_type view);
+
+        constexpr basic_string &operator+=(CharT ch);
+
+        /**
+         * Inserts view or count copies of ch before the character at index. Reports an error if
+         * index is greater than size() or the result does not fit, leaving the string unchanged.
+         */
+        constexpr basic_string &insert(size_type index, view_type view);
+
+        constexpr basic_string &insert(size_type index, size_type count, CharT ch);
+
+        /**
+         * Erases min(count, size() - index) characters starting at index. Reports an error if
+         * index is greater than size().
+         */
+        constexpr basic_string &erase(size_type index = 0, size_type count = npos);
+
+        constexpr void resize(size_type count, CharT ch = CharT());
+
+
+        /*** Operations ***/
+
+        [[nodiscard]] constexpr int compare(view_type view) const noexcept;
+
+        [[nodiscard]] constexpr size_type find(view_type view, size_type pos = 0) const noexcept;
+
+        [[nodiscard]] constexpr size_type find(CharT ch, size_type pos = 0) const noexcept;
+
+        [[nodiscard]] constexpr size_type rfind(view_type view, size_type pos = npos) const noexcept;
+
+        [[nodiscard]] constexpr size_type rfind(CharT ch, size_type pos = npos) const noexcept;
+
+        [[nodiscard]] constexpr bool contains(view_type view) const noexcept;
+
+        [[nodiscard]] constexpr bool contains(CharT ch) const noexcept;
+
+        [[nodiscard]] constexpr bool starts_with(view_type view) const noexcept;
+
+        [[nodiscard]] constexpr bool ends_with(view_type view) const noexcept;
+
+    private:
+        using size_counter_type = detail::size_counter_t<max_length>;
+
+        CharT             chars_[max_length + 1];
+        size_counter_type size_{};
+
+        constexpr void set_size(size_type count) noexcept;
+
+        /**
+         * Zeroes the buffer during constant evaluation, where a constexpr variable must have every
+         * character initialized. Does nothing at run time.
+         */
+        constexpr void initialize_for_constant_evaluation() noexcept;
+    };
+
+    template <std::size_t max_length>
+    using string = basic_string<char, max_length>;
+
+    template <std::size_t max_length>
+    using wstring = basic_string<wchar_t, max_length>;
+
+    template <typename CharT, std::size_t SizeA, std::size_t SizeB>
+    constexpr bool
+    operator==(const basic_string<CharT, SizeA> &lhs, const basic_string<CharT, SizeB> &rhs) noexcept
+    {
+        return lhs.view() == rhs.view();
+    }
+
+    template <typename CharT, std::size_t max_length>
+    constexpr bool
+    operator==(const basic_string<CharT, max_length>            &lhs,
+               std::type_identity_t<std::basic_string_view<CharT> > rhs) noexcept
+    {
+        return lhs.view() == rhs;
+    }
+
+    template <typename CharT, std::size_t SizeA, std::size_t SizeB>
+    constexpr auto
+    operator<=>(const basic_string<CharT, SizeA> &lhs, const basic_string<CharT, SizeB> &rhs) noexcept
+    {
+        return lhs.view() <=> rhs.view();
+    }
+
+    template <typename CharT, std::size_t max_length>
+    constexpr auto
+    operator<=>(const basic_string<CharT, max_length>            &lhs,
+                std::type_identity_t<std::basic_string_view<CharT> > rhs) noexcept
+    {
+        return lhs.view() <=> rhs;
+    }
+}
+
+template <typename CharT, std::size_t max_length>
+struct std::hash<cesa::basic_string<CharT, max_length> >
+{
+    std::size_t
+    operator()(const cesa::basic_string<CharT, max_length> &str) const noexcept
+    {
+        return std::hash<std::basic_string_view<CharT> >{}(str.view());
+    }
+};
+
+template <typename CharT, std::size_t max_length>
+constexpr
+cesa::basic_string<CharT, max_length>::basic_string() noexcept
+{
+    initialize_for_constant_evaluation();
+    chars_[0] = CharT();
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr
+cesa::basic_string<CharT, max_length>::basic_string(const CharT *str)
+    : basic_string(view_type(str))
+{
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr
+cesa::basic_string<CharT, max_length>::basic_string(const view_type view)
+{
+    initialize_for_constant_evaluation();
+    if (view.size() > max_length)
+    {
+        detail::report_error("string capacity exceeded");
+    }
+    traits_type::copy(chars_, view.data(), view.size());
+    set_size(view.size());
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr
+cesa::basic_string<CharT, max_length>::basic_string(const size_type count, const CharT ch)
+{
+    initialize_for_constant_evaluation();
+    if (count > max_length)
+    {
+        detail::report_error("string capacity exceeded");
+    }
+    traits_type::assign(chars_, count, ch);
+    set_size(count);
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr
+cesa::basic_string<CharT, max_length>::basic_string(const basic_string &other) noexcept
+{
+    initialize_for_constant_evaluation();
+    traits_type::copy(chars_, other.chars_, other.size_);
+    set_size(other.size_);
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr cesa::basic_string<CharT, max_length> &
+cesa::basic_string<CharT, max_length>::operator=(const basic_string &other) noexcept
+{
+    if (this != &other)
+    {
+        traits_type::copy(chars_, other.chars_, other.size_);
+        set_size(other.size_);
+    }
+    return *this;
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr cesa::basic_string<CharT, max_length> &
+cesa::basic_string<CharT, max_length>::operator=(const view_type view)
+{
+    if (view.size() > max_length)
+    {
+        detail::report_error("string capacity exceeded");
+    }
+    // The view may point into this string, so the ranges can overlap
+    traits_type::move(chars_, view.data(), view.size());
+    set_size(view.size());
+    return *this;
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr cesa::basic_string<CharT, max_length> &
+cesa::basic_string<CharT, max_length>::operator=(const CharT *str)
+{
+    return *this = view_type(str);
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr typename cesa::basic_string<CharT, max_length>::reference
+cesa::basic_string<CharT, max_length>::operator[](const size_type i)
+{
+    return chars_[i];
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr typename cesa::basic_string<CharT, max_length>::const_reference
+cesa::basic_string<CharT, max_length>::operator[](const size_type i) const
+{
+    return chars_[i];
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr typename cesa::basic_string<CharT, max_length>::reference
+cesa::basic_string<CharT, max_length>::at(const size_type pos)
+{
+    if (pos >= size_)
+    {
+        detail::report_error("index out of range");
+    }
+    return chars_[pos];
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr typename cesa::basic_string<CharT, max_length>::const_reference
+cesa::basic_string<CharT, max_length>::at(const size_type pos) const
+{
+    if (pos >= size_)
+    {
+        detail::report_error("index out of range");
+    }
+    return chars_[pos];
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr typename cesa::basic_string<CharT, max_length>::reference
+cesa::basic_string<CharT, max_length>::front()
+{
+    return chars_[0];
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr typename cesa::basic_string<CharT, max_length>::const_reference
+cesa::basic_string<CharT, max_length>::front() const
+{
+    return chars_[0];
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr typename cesa::basic_string<CharT, max_length>::reference
+cesa::basic_string<CharT, max_length>::back()
+{
+    return chars_[size_ - 1];
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr typename cesa::basic_string<CharT, max_length>::const_reference
+cesa::basic_string<CharT, max_length>::back() const
+{
+    return chars_[size_ - 1];
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr CharT *
+cesa::basic_string<CharT, max_length>::data() noexcept
+{
+    return chars_;
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr const CharT *
+cesa::basic_string<CharT, max_length>::data() const noexcept
+{
+    return chars_;
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr const CharT *
+cesa::basic_string<CharT, max_length>::c_str() const noexcept
+{
+    return chars_;
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr typename cesa::basic_string<CharT, max_length>::view_type
+cesa::basic_string<CharT, max_length>::view() const noexcept
+{
+    return view_type(chars_, size_);
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr
+cesa::basic_string<CharT, max_length>::operator view_type() const noexcept
+{
+    return view();
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr typename cesa::basic_string<CharT, max_length>::iterator
+cesa::basic_string<CharT, max_length>::begin() noexcept
+{
+    return chars_;
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr typename cesa::basic_string<CharT, max_length>::const_iterator
+cesa::basic_string<CharT, max_length>::begin() const noexcept
+{
+    return chars_;
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr typename cesa::basic_string<CharT, max_length>::const_iterator
+cesa::basic_string<CharT, max_length>::cbegin() const noexcept
+{
+    return chars_;
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr typename cesa::basic_string<CharT, max_length>::iterator
+cesa::basic_string<CharT, max_length>::end() noexcept
+{
+    return chars_ + size_;
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr typename cesa::basic_string<CharT, max_length>::const_iterator
+cesa::basic_string<CharT, max_length>::end() const noexcept
+{
+    return chars_ + size_;
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr typename cesa::basic_string<CharT, max_length>::const_iterator
+cesa::basic_string<CharT, max_length>::cend() const noexcept
+{
+    return chars_ + size_;
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr typename cesa::basic_string<CharT, max_length>::reverse_iterator
+cesa::basic_string<CharT, max_length>::rbegin() noexcept
+{
+    return reverse_iterator(end());
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr typename cesa::basic_string<CharT, max_length>::const_reverse_iterator
+cesa::basic_string<CharT, max_length>::rbegin() const noexcept
+{
+    return const_reverse_iterator(end());
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr typename cesa::basic_string<CharT, max_length>::reverse_iterator
+cesa::basic_string<CharT, max_length>::rend() noexcept
+{
+    return reverse_iterator(begin());
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr typename cesa::basic_string<CharT, max_length>::const_reverse_iterator
+cesa::basic_string<CharT, max_length>::rend() const noexcept
+{
+    return const_reverse_iterator(begin());
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr bool
+cesa::basic_string<CharT, max_length>::empty() const noexcept
+{
+    return size_ == 0;
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr typename cesa::basic_string<CharT, max_length>::size_type
+cesa::basic_string<CharT, max_length>::size() const noexcept
+{
+    return size_;
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr typename cesa::basic_string<CharT, max_length>::size_type
+cesa::basic_string<CharT, max_length>::length() const noexcept
+{
+    return size_;
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr typename cesa::basic_string<CharT, max_length>::size_type
+cesa::basic_string<CharT, max_length>::max_size() const noexcept
+{
+    return max_length;
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr void
+cesa::basic_string<CharT, max_length>::clear() noexcept
+{
+    set_size(0);
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr void
+cesa::basic_string<CharT, max_length>::push_back(const CharT ch)
+{
+    if (size_ >= max_length)
+    {
+        detail::report_error("string capacity exceeded");
+    }
+    chars_[size_] = ch;
+    set_size(size_ + 1U);
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr void
+cesa::basic_string<CharT, max_length>::pop_back()
+{
+    if (size_ > 0)
+    {
+        set_size(size_ - 1U);
+    }
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr cesa::basic_string<CharT, max_length> &
+cesa::basic_string<CharT, max_length>::append(const view_type view)
+{
+    if (view.size() > max_length - size_)
+    {
+        detail::report_error("string capacity exceeded");
+    }
+    // The view may point into this string, but never into the unused space being written to
+    traits_type::copy(chars_ + size_, view.data(), view.size());
+    set_size(size_ + view.size());
+    return *this;
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr cesa::basic_string<CharT, max_length> &
+cesa::basic_string<CharT, max_length>::append(const size_type count, const CharT ch)
+{
+    if (count > max_length - size_)
+    {
+        detail::report_error("string capacity exceeded");
+    }
+    traits_type::assign(chars_ + size_, count, ch);
+    set_size(size_ + count);
+    return *this;
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr cesa::basic_string<CharT, max_length> &
+cesa::basic_string<CharT, max_length>::operator+=(const view_type view)
+{
+    return append(view);
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr cesa::basic_string<CharT, max_length> &
+cesa::basic_string<CharT, max_length>::operator+=(const CharT ch)
+{
+    push_back(ch);
+    return *this;
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr cesa::basic_string<CharT, max_length> &
+cesa::basic_string<CharT, max_length>::insert(const size_type index, const view_type view)
+{
+    if (index > size_)
+    {
+        detail::report_error("index out of range");
+    }
+    if (view.size() > max_length - size_)
+    {
+        detail::report_error("string capacity exceeded");
+    }
+    // The view may point into this string, so copy it to the unused space first, which it never
+    // overlaps, and then rotate it into place
+    traits_type::copy(chars_ + size_, view.data(), view.size());
+    std::rotate(chars_ + index, chars_ + size_, chars_ + size_ + view.size());
+    set_size(size_ + view.size());
+    return *this;
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr cesa::basic_string<CharT, max_length> &
+cesa::basic_string<CharT, max_length>::insert(const size_type index, const size_type count, const CharT ch)
+{
+    if (index > size_)
+    {
+        detail::report_error("index out of range");
+    }
+    if (count > max_length - size_)
+    {
+        detail::report_error("string capacity exceeded");
+    }
+    traits_type::move(chars_ + index + count, chars_ + index, size_ - index);
+    traits_type::assign(chars_ + index, count, ch);
+    set_size(size_ + count);
+    return *this;
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr cesa::basic_string<CharT, max_length> &
+cesa::basic_string<CharT, max_length>::erase(const size_type index, const size_type count)
+{
+    if (index > size_)
+    {
+        detail::report_error("index out of range");
+    }
+    const size_type erased = std::min<size_type>(count, size_ - index);
+    traits_type::move(chars_ + index, chars_ + index + erased, size_ - index - erased);
+    set_size(size_ - erased);
+    return *this;
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr void
+cesa::basic_string<CharT, max_length>::resize(const size_type count, const CharT ch)
+{
+    if (count > max_length)
+    {
+        detail::report_error("string capacity exceeded");
+    }
+    if (count > size_)
+    {
+        traits_type::assign(chars_ + size_, count - size_, ch);
+    }
+    set_size(count);
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr int
+cesa::basic_string<CharT, max_length>::compare(const view_type view) const noexcept
+{
+    return this->view().compare(view);
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr typename cesa::basic_string<CharT, max_length>::size_type
+cesa::basic_string<CharT, max_length>::find(const view_type view, const size_type pos) const noexcept
+{
+    return this->view().find(view, pos);
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr typename cesa::basic_string<CharT, max_length>::size_type
+cesa::basic_string<CharT, max_length>::find(const CharT ch, const size_type pos) const noexcept
+{
+    if (pos >= size_)
+    {
+        return npos;
+    }
+    const CharT *match = traits_type::find(chars_ + pos, size_ - pos, ch);
+    return match == nullptr ? npos : static_cast<size_type>(match - chars_);
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr typename cesa::basic_string<CharT, max_length>::size_type
+cesa::basic_string<CharT, max_length>::rfind(const view_type view, const size_type pos) const noexcept
+{
+    return this->view().rfind(view, pos);
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr typename cesa::basic_string<CharT, max_length>::size_type
+cesa::basic_string<CharT, max_length>::rfind(const CharT ch, const size_type pos) const noexcept
+{
+    return view().rfind(ch, pos);
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr bool
+cesa::basic_string<CharT, max_length>::contains(const view_type view) const noexcept
+{
+    return find(view) != npos;
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr bool
+cesa::basic_string<CharT, max_length>::contains(const CharT ch) const noexcept
+{
+    return find(ch) != npos;
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr bool
+cesa::basic_string<CharT, max_length>::starts_with(const view_type view) const noexcept
+{
+    return this->view().starts_with(view);
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr bool
+cesa::basic_string<CharT, max_length>::ends_with(const view_type view) const noexcept
+{
+    return this->view().ends_with(view);
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr void
+cesa::basic_string<CharT, max_length>::set_size(const size_type count) noexcept
+{
+    size_         = static_cast<size_counter_type>(count);
+    chars_[count] = CharT();
+}
+
+template <typename CharT, std::size_t max_length>
+constexpr void
+cesa::basic_string<CharT, max_length>::initialize_for_constant_evaluation() noexcept
+{
+    if (std::is_constant_evaluated())
+    {
+        traits_type::assign(chars_, max_length + 1, CharT());
+    }
+}
+
+#endif
@@ -23,18 +23,241 @@
  * (e.g., insertion, erasure, assignment to a smaller size).
  * Iterators to elements after the insertion/erasure point are invalidated.
  * Therefore, if element erasure is required while iterating, a reverse iterator is recommended.
+ * Defining CESA_DEBUG (see debug.hpp) makes the use of an invalidated iterator a reported error.
  */
 
+#include "config.hpp"
+#include "debug.hpp"
+#include "instrumentation.hpp"
+#include "simd.hpp"
+
+#include <algorithm>
 #include <new>
+#include <memory>
 #include <cstddef>
-#include <iostream>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <iterator>
+#include <span>
+#include <type_traits>
+#include <utility>
 
 namespace cesa
 {
-    template <typename T, std::size_t max_elements>
+    namespace detail
+    {
+        /**
+         * The smallest unsigned integer type able to hold every value in [0, max_elements].
+         * Used for the size counter so that small vectors do not pay for a full std::size_t.
+         */
+        template <std::size_t max_elements>
+        using size_counter_t = std::conditional_t<
+            max_elements <= UINT8_MAX, std::uint8_t,
+            std::conditional_t<max_elements <= UINT16_MAX, std::uint16_t,
+                               std::conditional_t<max_elements <= UINT32_MAX, std::uint32_t, std::uint64_t> > >;
+
+        /**
+         * Whether the storage of a vector of max_elements objects of type T is tiny, i.e. fits in a
+         * cache line, which is two AVX2 or four SSE2/NEON registers. Tiny vectors of trivially copyable
+         * elements copy their whole storage instead of size() elements, and shift their elements with
+         * unrolled_shift, so that neither takes a loop or a memcpy/memmove call of runtime length.
+         */
+        template <typename T, std::size_t max_elements>
+        inline constexpr bool is_tiny_storage_v = sizeof(T) * max_elements <= cache_line_size;
+
+        /**
+         * Relocates the elements in [first, last) of an array of max_elements trivially relocatable
+         * objects count slots towards the end (towards_end) or the beginning. Makes one predicated
+         * copy per slot of the capacity, unrolled at compile time, in an order that copies every
+         * element before its slot is overwritten.
+         */
+        template <std::size_t max_elements, bool towards_end, typename T>
+        inline void
+        unrolled_shift(T *elements, const std::size_t first, const std::size_t last, const std::size_t count) noexcept
+        {
+            [&]<std::size_t... step>(std::index_sequence<step...>) {
+                const auto shift = [&](const std::size_t i) {
+                    if (i >= first && i < last)
+                    {
+                        T *const destination = towards_end ? elements + i + count : elements + i - count;
+                        std::memcpy(static_cast<void *>(destination), elements + i, sizeof(T));
+                    }
+                };
+                (shift(towards_end ? max_elements - 1 - step : step), ...);
+            }(std::make_index_sequence<max_elements>{});
+        }
+    }
+
+    /**
+     * Whether objects of type T may be relocated, i.e. moved to new storage with their old storage
+     * reused without running the destructor, by copying their bytes. Defaults to
+     * std::is_trivially_copyable. Types that are relocatable in practice, such as
+     * std::unique_ptr<X>, can opt in by specializing this trait, which lets cesa::vector move,
+     * swap and shift them with memcpy/memmove.
+     */
+    template <typename T>
+    struct is_trivially_relocatable : std::is_trivially_copyable<T>
+    {
+    };
+
+    template <typename T>
+    inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+    /**
+     * The number of bytes an object of a cesa container type occupies, inline storage included,
+     * i.e. what one such local variable costs on the stack. Defaults to sizeof(Container).
+     * Specializations may report a different figure for types whose footprint sizeof() does not
+     * capture.
+     */
+    template <class Container>
+    struct storage_bytes : std::integral_constant<std::size_t, sizeof(Container)>
+    {
+    };
+
+    template <class Container>
+    inline constexpr std::size_t storage_bytes_v = storage_bytes<Container>::value;
+
+    /**
+     * Tags selecting the bulk constructors, e.g. vector<int, 8>(cesa::with_size, 4, 0) or
+     * vector<int, 8>(cesa::from_range, first, last). Plain vector(args...) constructs one element
+     * per argument, so the bulk forms need a tag to not be ambiguous with it.
+     */
+    struct with_size_t
+    {
+        explicit with_size_t() = default;
+    };
+
+    inline constexpr with_size_t with_size{};
+
+    struct from_range_t
+    {
+        explicit from_range_t() = default;
+    };
+
+    inline constexpr from_range_t from_range{};
+
+    /**
+     * Tag for resize() requesting default-initialization instead of value-initialization,
+     * which leaves new elements of trivially default constructible types uninitialized.
+     */
+    struct default_init_t
+    {
+        explicit default_init_t() = default;
+    };
+
+    inline constexpr default_init_t default_init{};
+
+    namespace detail
+    {
+        template <typename T>
+        inline constexpr bool is_construction_tag_v = std::is_same_v<T, with_size_t> ||
+                                                      std::is_same_v<T, from_range_t> ||
+                                                      std::is_same_v<T, default_init_t>;
+
+        template <typename InputIt>
+        inline constexpr bool is_forward_iterator_v = std::is_base_of_v<
+            std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>;
+
+        /**
+         * Counterparts of the <memory> uninitialized algorithms, which are not constexpr before
+         * C++26. During constant evaluation they construct the elements one by one with
+         * std::construct_at, otherwise they forward to the standard algorithm.
+         */
+        template <typename InputIt, typename T>
+        constexpr T *
+        uninitialized_copy(InputIt first, InputIt last, T *out)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                return std::uninitialized_copy(first, last, out);
+            }
+            for (; first != last; ++first, ++out)
+            {
+                std::construct_at(out, *first);
+            }
+            return out;
+        }
+
+        template <typename T>
+        constexpr T *
+        uninitialized_move(T *first, T *last, T *out)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                return std::uninitialized_move(first, last, out);
+            }
+            for (; first != last; ++first, ++out)
+            {
+                std::construct_at(out, std::move(*first));
+            }
+            return out;
+        }
+
+        template <typename T>
+        constexpr T *
+        uninitialized_fill_n(T *out, std::size_t count, const T &value)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                return std::uninitialized_fill_n(out, count, value);
+            }
+            for (; count > 0; --count, ++out)
+            {
+                std::construct_at(out, value);
+            }
+            return out;
+        }
+
+        template <typename T>
+        constexpr void
+        uninitialized_value_construct(T *first, T *last)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                std::uninitialized_value_construct(first, last);
+                return;
+            }
+            for (; first != last; ++first)
+            {
+                std::construct_at(first);
+            }
+        }
+
+        /**
+         * During constant evaluation the elements are value-initialized, as the constant
+         * evaluator does not allow objects with indeterminate values.
+         */
+        template <typename T>
+        constexpr void
+        uninitialized_default_construct(T *first, T *last)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                std::uninitialized_default_construct(first, last);
+                return;
+            }
+            for (; first != last; ++first)
+            {
+                std::construct_at(first);
+            }
+        }
+    }
+
+    /**
+     * The storage buffer is aligned to alignment bytes, which defaults to alignof(T). Raising it to
+     * detail::cache_line_size or a SIMD register width (see cesa::aligned_vector) lets data() and
+     * begin() promise that alignment to the compiler, and keeps the buffer off cache lines shared
+     * with neighbouring objects.
+     */
+    template <typename T, std::size_t max_elements, std::size_t alignment = alignof(T)>
     class vector
     {
+        static_assert(alignment >= alignof(T) && (alignment & (alignment - 1)) == 0,
+                      "vector alignment must be a power of two no smaller than alignof(T)");
+        static_assert(detail::check_inline_budget<sizeof(T) * max_elements>(),
+                      "vector inline storage exceeds CESA_MAX_INLINE_BYTES");
+
     public:
         using value_type             = T;
         using size_type              = std::size_t;
@@ -43,16 +266,34 @@ namespace cesa
         using const_reference        = const value_type &;
         using pointer                = value_type *;
         using const_pointer          = const value_type *;
-        using iterator               = value_type *;
-        using const_iterator         = const value_type *;
-        using reverse_iterator       = std::reverse_iterator<value_type *>;
-        using const_reverse_iterator = std::reverse_iterator<const value_type *>;
+#if CESA_DEBUG
+        using iterator       = detail::checked_iterator<vector, false>;
+        using const_iterator = detail::checked_iterator<vector, true>;
+#else
+        using iterator       = value_type *;
+        using const_iterator = const value_type *;
+#endif
+        using reverse_iterator       = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        static constexpr size_type npos = static_cast<size_type>(-1);
 
         explicit constexpr vector() noexcept = default;
 
-        template <class... Args, typename = std::enable_if_t<(std::is_constructible_v<value_type, Args &&> && ...)> >
+        template <class... Args,
+                  typename = std::enable_if_t<((std::is_constructible_v<value_type, Args &&> &&
+                                                !detail::is_construction_tag_v<std::remove_cvref_t<Args> >) &&
+                                               ...)> >
         explicit constexpr vector(Args &&... args);
 
+        constexpr vector(with_size_t, size_type count);
+
+        constexpr vector(with_size_t, size_type count, const value_type &value);
+
+        template <class InputIt, typename = std::enable_if_t<std::is_base_of_v<
+                      std::input_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category> > >
+        constexpr vector(from_range_t, InputIt first, InputIt last);
+
         constexpr vector(const vector &other);
 
         constexpr vector(vector &&other) noexcept;
@@ -61,7 +302,10 @@ namespace cesa
 
         constexpr vector &operator=(vector &&other) noexcept;
 
-        ~vector();
+        constexpr ~vector();
+
+        constexpr void swap(vector &other) noexcept(std::is_nothrow_swappable_v<value_type> &&
+                                                    std::is_nothrow_move_constructible_v<value_type>);
 
 
         /*** Element access ***/
@@ -87,6 +331,26 @@ namespace cesa
         [[nodiscard]] constexpr const value_type *data() const noexcept;
 
 
+        /*** Lookup ***/
+
+        /**
+         * The lookup members compare elements with operator==, and are vectorized for
+         * arithmetic element types (see simd.hpp).
+         */
+        [[nodiscard]] constexpr iterator find(const value_type &value);
+
+        [[nodiscard]] constexpr const_iterator find(const value_type &value) const;
+
+        /**
+         * Returns the index of the first element equal to value, or npos if there is none.
+         */
+        [[nodiscard]] constexpr size_type index_of(const value_type &value) const;
+
+        [[nodiscard]] constexpr bool contains(const value_type &value) const;
+
+        [[nodiscard]] constexpr size_type count(const value_type &value) const;
+
+
         /*** Iterators ***/
 
         [[nodiscard]] constexpr iterator begin() noexcept;
@@ -122,10 +386,24 @@ namespace cesa
 
         [[nodiscard]] constexpr size_type max_size() const noexcept;
 
+        constexpr void resize(size_type count);
+
+        constexpr void resize(size_type count, const value_type &value);
+
+        constexpr void resize(size_type count, default_init_t);
+
 
         /*** Modifiers ***/
         constexpr void clear() noexcept;
 
+        constexpr void assign(size_type count, const value_type &value);
+
+        template <class InputIt, typename = std::enable_if_t<std::is_base_of_v<
+                      std::input_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category> > >
+        constexpr void assign(InputIt first, InputIt last);
+
+        constexpr void assign(std::initializer_list<value_type> initializer_list);
+
         constexpr iterator insert(const_iterator pos, const value_type &value);
 
         constexpr iterator insert(const_iterator pos, value_type &&value);
@@ -145,6 +423,57 @@ namespace cesa
 
         constexpr iterator erase(const_iterator first, const_iterator last);
 
+        /**
+         * Erases the element at pos in O(1) by moving the last element into its place.
+         * Does not preserve the order of the remaining elements.
+         */
+        constexpr iterator erase_unordered(const_iterator pos);
+
+        /**
+         * Erases every element satisfying pred, filling each hole with the last element.
+         * Does not preserve the order of the remaining elements. Returns the number of elements erased.
+         */
+        template <class UnaryPredicate>
+        constexpr size_type erase_unordered_if(UnaryPredicate pred);
+
+        /**
+         * Erases every element satisfying pred in a single compaction pass, preserving the order of
+         * the remaining elements. Returns the number of elements erased.
+         */
+        template <class UnaryPredicate>
+        constexpr size_type erase_if(UnaryPredicate pred);
+
+        /**
+         * Inserts value after the elements it does not compare less than, keeping a vector that is
+         * sorted by comp sorted. Finds the position with a binary search.
+         */
+        template <class Compare = std::less<>>
+        constexpr iterator insert_sorted(const value_type &value, Compare comp = {});
+
+        template <class Compare = std::less<>>
+        constexpr iterator insert_sorted(value_type &&value, Compare comp = {});
+
+        /**
+         * Merges the range [first, last), which must be sorted by comp, into a vector that is sorted
+         * by comp, in O(size() + std::distance(first, last)). Bidirectional ranges are merged
+         * backwards from the end of the unused capacity in place. Forward ranges are merged forwards
+         * after relocating the elements to the end of the merged range, and only single-pass ranges
+         * are buffered. Equal elements from the range are placed after the existing ones. If comp or
+         * an element operation throws, the vector holds a valid subset of the elements, which is
+         * still sorted when merging a forward range.
+         */
+        template <class InputIt, class Compare = std::less<>,
+                  typename = std::enable_if_t<std::is_base_of_v<
+                      std::input_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category> > >
+        constexpr void merge_sorted(InputIt first, InputIt last, Compare comp = {});
+
+        /**
+         * Erases all but the first of every run of consecutive elements satisfying pred in a single
+         * compaction pass. Returns the number of elements erased.
+         */
+        template <class BinaryPredicate = std::equal_to<>>
+        constexpr size_type unique_sorted(BinaryPredicate pred = {});
+
         constexpr reference push_back(const value_type &value);
 
         constexpr reference push_back(value_type &&value);
@@ -152,455 +481,1489 @@ namespace cesa
         template <class... Args>
         constexpr reference emplace_back(Args &&... args);
 
+        /**
+         * Constructs an element at the end without checking the capacity.
+         * The behavior is undefined if size() == max_size().
+         */
+        template <class... Args>
+        constexpr reference unchecked_emplace_back(Args &&... args) noexcept(
+            std::is_nothrow_constructible_v<value_type, Args &&...>);
+
+        /**
+         * Constructs an element at the end if there is room for it.
+         * Returns a pointer to the new element, or nullptr if the vector is full.
+         */
+        template <class... Args>
+        constexpr pointer try_emplace_back(Args &&... args) noexcept(
+            std::is_nothrow_constructible_v<value_type, Args &&...>);
+
+        /**
+         * Grows the vector by count elements without initializing them, and returns the new
+         * elements so they can be written in place. Only available for trivial element types.
+         */
+        constexpr std::span<value_type> append_uninitialized(size_type count);
+
+        /**
+         * Resizes the vector to count elements. Elements added by growing are left uninitialized
+         * and must be written before being read. Only available for trivial element types.
+         */
+        constexpr void resize_for_overwrite(size_type count);
+
         constexpr void pop_back();
 
     private:
-        alignas(value_type) std::byte storage_[sizeof(value_type) * max_elements]{};
-        size_type                     size_{};
-        size_type                     max_size_{ max_elements };
-
-        [[nodiscard]] pointer ptr_at(size_type index) noexcept;
+        template <typename, bool>
+        friend class detail::checked_iterator;
+
+        using size_counter_type = detail::size_counter_t<max_elements>;
+        using instrumentation   = detail::vector_instrumentation<value_type, max_elements>;
+
+        /**
+         * Uninitialized storage for the elements. A union member is not initialized unless done so
+         * explicitly, and unlike a std::byte buffer, its elements can be created with
+         * std::construct_at and accessed during constant evaluation.
+         */
+        union storage_type
+        {
+            constexpr storage_type() noexcept
+            {
+            }
 
-        [[nodiscard]] const_pointer ptr_at(size_type index) const noexcept;
+            constexpr ~storage_type()
+            {
+            }
 
-        template <typename S, std::size_t SizeA, std::size_t SizeB>
-        friend constexpr bool
-        operator==(vector<S, SizeA> &,
-                   vector<S, SizeB> &);
+            value_type elements[max_elements];
+        };
+
+        alignas(alignment) storage_type      storage_;
+        size_counter_type                    size_{};
+#if CESA_DEBUG
+        std::size_t generation_{};
+#endif
+
+        [[nodiscard]] constexpr pointer ptr_at(size_type index) noexcept;
+
+        [[nodiscard]] constexpr const_pointer ptr_at(size_type index) const noexcept;
+
+        [[nodiscard]] constexpr iterator make_iterator(size_type index) noexcept;
+
+        [[nodiscard]] constexpr const_iterator make_iterator(size_type index) const noexcept;
+
+        /**
+         * The index of pos, which must be in [begin(), end()]. With CESA_DEBUG, reports a pos that
+         * is not, or that belongs to another vector or was invalidated.
+         */
+        [[nodiscard]] constexpr size_type index_of_position(const_iterator pos) const;
+
+        /**
+         * Called by every operation that changes the size or replaces the contents. With CESA_DEBUG,
+         * this outdates all existing iterators; otherwise it does nothing.
+         */
+        constexpr void invalidate_iterators() noexcept;
+
+        /**
+         * Relocates the elements in [index, size()) count slots towards the end, leaving
+         * [index, index + count) uninitialized. Does not update size_. If a move throws, the
+         * elements stay in [0, size()), although some may have been moved from.
+         */
+        constexpr void open_gap(size_type index, size_type count);
+
+        /**
+         * Undoes open_gap(index, count) when filling the gap failed, relocating the elements in
+         * [index + count, size() + count) back to index. If a move throws, the elements from index
+         * on are destroyed and size_ is set to index.
+         */
+        constexpr void close_gap(size_type index, size_type count);
+
+        /**
+         * Moves value into the slot opened by open_gap(index, 1), closing the gap again if the move
+         * throws.
+         */
+        constexpr void fill_gap(size_type index, value_type &&value);
+
+        /**
+         * The two halves of merge_sorted. Both fill [0, new_size) from the elements in
+         * [0, old_size) and the count = new_size - old_size elements of [first, last), and leave
+         * size_ to the caller. merge_backwards fills the slots from the back, so that no element is
+         * moved before its slot is free. merge_forwards relocates the elements to the back first
+         * and fills the slots from the front. Both return the number of elements moved.
+         */
+        template <class BidirIt, class Compare>
+        constexpr size_type merge_backwards(BidirIt first, BidirIt last, Compare &comp, size_type old_size,
+                                       size_type new_size);
+
+        template <class ForwardIt, class Compare>
+        constexpr size_type merge_forwards(ForwardIt first, ForwardIt last, Compare &comp, size_type old_size,
+                                      size_type new_size);
+
+        /**
+         * Copies the elements of other, which must be trivially relocatable, into the uninitialized
+         * storage of this vector. Does not update size_. Tiny vectors copy the whole storage, which
+         * has a size known at compile time.
+         */
+        void copy_storage(const vector &other) noexcept;
+
+        /**
+         * Relocates the trivially relocatable elements in [first, last) count slots towards the end
+         * (towards_end) or the beginning, with unrolled_shift for tiny vectors and std::memmove
+         * otherwise.
+         */
+        template <bool towards_end>
+        void shift_elements(size_type first, size_type last, size_type count) noexcept;
     };
+
+    /**
+     * Vectors compare equal if they hold the same number of elements and the elements compare
+     * equal pairwise, regardless of their capacity or alignment. Vectors of the same capacity whose
+     * storage fills one or two SIMD registers are compared with a masked compare of their whole
+     * storage (see detail::equal_block) instead of a loop over size() elements.
+     */
+    template <typename T, std::size_t max_elements_lhs, std::size_t alignment_lhs, std::size_t max_elements_rhs,
+              std::size_t alignment_rhs>
+    [[nodiscard]] constexpr bool
+    operator==(const vector<T, max_elements_lhs, alignment_lhs> &lhs,
+               const vector<T, max_elements_rhs, alignment_rhs> &rhs)
+    {
+        if constexpr (max_elements_lhs == max_elements_rhs && detail::is_simd_block_v<T, max_elements_lhs>)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                return lhs.size() == rhs.size() &&
+                       detail::equal_block<max_elements_lhs>(lhs.data(), rhs.data(), lhs.size());
+            }
+        }
+        return lhs.size() == rhs.size() && detail::equal_elements(lhs.data(), rhs.data(), lhs.size());
+    }
+
+    template <typename T, std::size_t max_elements, std::size_t alignment>
+    constexpr void
+    swap(vector<T, max_elements, alignment> &lhs, vector<T, max_elements, alignment> &rhs) noexcept(
+        noexcept(lhs.swap(rhs)))
+    {
+        lhs.swap(rhs);
+    }
+
+    /**
+     * A vector whose storage is aligned to a cache line, or to a wider SIMD register size such as 64
+     * for AVX-512, so that aligned vector loads and stores can be used on data().
+     */
+    template <typename T, std::size_t max_elements, std::size_t alignment = detail::cache_line_size>
+    using aligned_vector = vector<T, max_elements, alignment>;
+
+    namespace detail
+    {
+        /**
+         * max_elements rounded up to a whole number of alignment-sized SIMD registers.
+         */
+        template <typename T, std::size_t max_elements, std::size_t alignment>
+        inline constexpr std::size_t lane_padded_size_v =
+            alignment <= sizeof(T)
+                ? max_elements
+                : (max_elements + alignment / sizeof(T) - 1) / (alignment / sizeof(T)) * (alignment / sizeof(T));
+    }
+
+    /**
+     * An aligned_vector whose capacity is padded up to a whole number of SIMD registers. As the
+     * storage between size() and the next register boundary always exists, a loop over trivial
+     * elements may process whole registers and skip the scalar tail loop, as long as it ignores the
+     * results for the lanes past size() (which hold unspecified values).
+     */
+    template <typename T, std::size_t max_elements, std::size_t alignment = detail::cache_line_size>
+    using lane_padded_vector = vector<T, detail::lane_padded_size_v<T, max_elements, alignment>, alignment>;
 }
 
-template <typename T, std::size_t maximum_size>
-cesa::vector<T, maximum_size>::~vector()
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr cesa::vector<T, maximum_size, alignment>::~vector()
 {
-    clear();
+    if constexpr (!std::is_trivially_destructible_v<value_type>)
+    {
+        std::destroy(ptr_at(0), ptr_at(size_));
+    }
 }
 
-template <typename T, std::size_t maximum_size>
+template <typename T, std::size_t maximum_size, std::size_t alignment>
 template <class... Args, typename>
 constexpr
-cesa::vector<T, maximum_size>::vector(Args &&... args)
+cesa::vector<T, maximum_size, alignment>::vector(Args &&... args)
 {
     static_assert(sizeof...(args) <= maximum_size, "Too many arguments");
     ((emplace_back(std::forward<Args>(args))), ...);
 }
 
-template <typename T, std::size_t maximum_size>
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr
+cesa::vector<T, maximum_size, alignment>::vector(with_size_t, const size_type count)
+{
+    resize(count);
+}
+
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr
+cesa::vector<T, maximum_size, alignment>::vector(with_size_t, const size_type count, const value_type &value)
+{
+    resize(count, value);
+}
+
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+template <class InputIt, typename>
+constexpr
+cesa::vector<T, maximum_size, alignment>::vector(from_range_t, InputIt first, InputIt last)
+{
+    assign(first, last);
+}
+
+template <typename T, std::size_t maximum_size, std::size_t alignment>
 constexpr
-cesa::vector<T, maximum_size>::vector(const vector &other)
+cesa::vector<T, maximum_size, alignment>::vector(const vector &other)
 {
-    for (size_type i{}; i < other.size_; ++i)
+    if (std::is_trivially_copyable_v<value_type> && !std::is_constant_evaluated())
     {
-        emplace_back(*other.ptr_at(i));
+        copy_storage(other);
+    }
+    else
+    {
+        detail::uninitialized_copy(other.ptr_at(0), other.ptr_at(other.size_), ptr_at(0));
     }
     size_ = other.size_;
+    invalidate_iterators();
+    instrumentation::on_insert(size_, 0, size_);
 }
 
-template <typename T, std::size_t maximum_size>
+template <typename T, std::size_t maximum_size, std::size_t alignment>
 constexpr
-cesa::vector<T, maximum_size>::vector(vector &&other) noexcept
+cesa::vector<T, maximum_size, alignment>::vector(vector &&other) noexcept
 {
-    for (size_type i{}; i < other.size_; ++i)
+    if (is_trivially_relocatable_v<value_type> && !std::is_constant_evaluated())
     {
-        emplace_back(std::move(*other.ptr_at(i)));
+        copy_storage(other);
+        size_       = other.size_;
+        other.size_ = 0;
+        invalidate_iterators();
+        other.invalidate_iterators();
     }
-    size_ = other.size_;
-    other.clear();
+    else
+    {
+        detail::uninitialized_move(other.ptr_at(0), other.ptr_at(other.size_), ptr_at(0));
+        size_ = other.size_;
+        invalidate_iterators();
+        other.clear();
+    }
+    instrumentation::on_insert(size_, 0, size_);
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr cesa::vector<T, maximum_size> &
-cesa::vector<T, maximum_size>::operator=(const vector &other)
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr cesa::vector<T, maximum_size, alignment> &
+cesa::vector<T, maximum_size, alignment>::operator=(const vector &other)
 {
     if (this != &other)
     {
         clear();
-        for (size_type i{}; i < other.size_; ++i)
+        if (std::is_trivially_copyable_v<value_type> && !std::is_constant_evaluated())
+        {
+            copy_storage(other);
+        }
+        else
         {
-            emplace_back(*other.ptr_at(i));
+            detail::uninitialized_copy(other.ptr_at(0), other.ptr_at(other.size_), ptr_at(0));
         }
         size_ = other.size_;
+        invalidate_iterators();
+        instrumentation::on_insert(size_, 0, size_);
     }
     return *this;
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr cesa::vector<T, maximum_size> &
-cesa::vector<T, maximum_size>::operator=(vector &&other) noexcept
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr cesa::vector<T, maximum_size, alignment> &
+cesa::vector<T, maximum_size, alignment>::operator=(vector &&other) noexcept
 {
     if (this != &other)
     {
         clear();
-        for (size_type i{}; i < other.size_; ++i)
+        if (is_trivially_relocatable_v<value_type> && !std::is_constant_evaluated())
         {
-            emplace_back(std::move(*other.ptr_at(i)));
+            copy_storage(other);
+            size_       = other.size_;
+            other.size_ = 0;
+            invalidate_iterators();
+            other.invalidate_iterators();
         }
-        size_ = other.size_;
-        other.clear();
+        else
+        {
+            detail::uninitialized_move(other.ptr_at(0), other.ptr_at(other.size_), ptr_at(0));
+            size_ = other.size_;
+            invalidate_iterators();
+            other.clear();
+        }
+        instrumentation::on_insert(size_, 0, size_);
     }
     return *this;
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr typename cesa::vector<T, maximum_size>::reference
-cesa::vector<T, maximum_size>::operator[](const size_type i)
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr void
+cesa::vector<T, maximum_size, alignment>::swap(vector &other) noexcept(std::is_nothrow_swappable_v<value_type> &&
+                                                                       std::is_nothrow_move_constructible_v<value_type>)
 {
+    if (this == &other)
+    {
+        return;
+    }
+    if (is_trivially_relocatable_v<value_type> && detail::is_tiny_storage_v<value_type, maximum_size> &&
+        !std::is_constant_evaluated())
+    {
+        std::byte buffer[sizeof(storage_type)];
+        std::memcpy(buffer, &storage_, sizeof(storage_type));
+        std::memcpy(static_cast<void *>(&storage_), &other.storage_, sizeof(storage_type));
+        std::memcpy(static_cast<void *>(&other.storage_), buffer, sizeof(storage_type));
+    }
+    else if (is_trivially_relocatable_v<value_type> && !std::is_constant_evaluated())
+    {
+        const size_type bytes = std::max<size_type>(size_, other.size_) * sizeof(value_type);
+        auto           *lhs   = reinterpret_cast<std::byte *>(data());
+        std::swap_ranges(lhs, lhs + bytes, reinterpret_cast<std::byte *>(other.data()));
+    }
+    else
+    {
+        vector &longer  = size_ < other.size_ ? other : *this;
+        vector &shorter = size_ < other.size_ ? *this : other;
+        std::swap_ranges(shorter.ptr_at(0), shorter.ptr_at(shorter.size_), longer.ptr_at(0));
+        detail::uninitialized_move(longer.ptr_at(shorter.size_), longer.ptr_at(longer.size_),
+                                   shorter.ptr_at(shorter.size_));
+        std::destroy(longer.ptr_at(shorter.size_), longer.ptr_at(longer.size_));
+    }
+    std::swap(size_, other.size_);
+    invalidate_iterators();
+    other.invalidate_iterators();
+}
+
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::reference
+cesa::vector<T, maximum_size, alignment>::operator[](const size_type i)
+{
+    detail::debug_check(i < size_, "index out of range");
     return *ptr_at(i);
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr typename cesa::vector<T, maximum_size>::const_reference
-cesa::vector<T, maximum_size>::operator[](const size_type i) const
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::const_reference
+cesa::vector<T, maximum_size, alignment>::operator[](const size_type i) const
 {
+    detail::debug_check(i < size_, "index out of range");
     return *ptr_at(i);
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr typename cesa::vector<T, maximum_size>::reference
-cesa::vector<T, maximum_size>::at(const size_type pos)
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::reference
+cesa::vector<T, maximum_size, alignment>::at(const size_type pos)
 {
     if (pos >= size_)
     {
-        throw std::out_of_range("index out of range");
+        detail::report_error("index out of range");
     }
     return *ptr_at(pos);
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr typename cesa::vector<T, maximum_size>::const_reference
-cesa::vector<T, maximum_size>::at(const size_type pos) const
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::const_reference
+cesa::vector<T, maximum_size, alignment>::at(const size_type pos) const
 {
     if (pos >= size_)
     {
-        throw std::out_of_range("index out of range");
+        detail::report_error("index out of range");
     }
     return *ptr_at(pos);
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr typename cesa::vector<T, maximum_size>::reference
-cesa::vector<T, maximum_size>::front()
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::reference
+cesa::vector<T, maximum_size, alignment>::front()
 {
+    detail::debug_check(size_ > 0, "front() called on an empty vector");
     return *ptr_at(0);
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr typename cesa::vector<T, maximum_size>::const_reference
-cesa::vector<T, maximum_size>::front() const
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::const_reference
+cesa::vector<T, maximum_size, alignment>::front() const
 {
+    detail::debug_check(size_ > 0, "front() called on an empty vector");
     return *ptr_at(0);
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr typename cesa::vector<T, maximum_size>::reference
-cesa::vector<T, maximum_size>::back()
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::reference
+cesa::vector<T, maximum_size, alignment>::back()
 {
+    detail::debug_check(size_ > 0, "back() called on an empty vector");
     return *ptr_at(size_ - 1);
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr typename cesa::vector<T, maximum_size>::const_reference
-cesa::vector<T, maximum_size>::back() const
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::const_reference
+cesa::vector<T, maximum_size, alignment>::back() const
 {
+    detail::debug_check(size_ > 0, "back() called on an empty vector");
     return *ptr_at(size_ - 1);
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr typename cesa::vector<T, maximum_size>::value_type *
-cesa::vector<T, maximum_size>::data() noexcept
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::value_type *
+cesa::vector<T, maximum_size, alignment>::data() noexcept
 {
-    return reinterpret_cast<value_type *>(storage_);
+    return std::assume_aligned<alignment>(storage_.elements);
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr const typename cesa::vector<T, maximum_size>::value_type *
-cesa::vector<T, maximum_size>::data() const noexcept
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr const typename cesa::vector<T, maximum_size, alignment>::value_type *
+cesa::vector<T, maximum_size, alignment>::data() const noexcept
 {
-    return reinterpret_cast<const value_type *>(storage_);
+    return std::assume_aligned<alignment>(storage_.elements);
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr typename cesa::vector<T, maximum_size>::iterator
-cesa::vector<T, maximum_size>::begin() noexcept
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::iterator
+cesa::vector<T, maximum_size, alignment>::find(const value_type &value)
 {
-    return data();
+    return make_iterator(detail::find_index(data(), size_, value));
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr typename cesa::vector<T, maximum_size>::const_iterator
-cesa::vector<T, maximum_size>::begin() const noexcept
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::const_iterator
+cesa::vector<T, maximum_size, alignment>::find(const value_type &value) const
 {
-    return data();
+    return make_iterator(detail::find_index(data(), size_, value));
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr typename cesa::vector<T, maximum_size>::const_iterator
-cesa::vector<T, maximum_size>::cbegin() const noexcept
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::size_type
+cesa::vector<T, maximum_size, alignment>::index_of(const value_type &value) const
 {
-    return data();
+    const size_type index = detail::find_index(data(), size_, value);
+    return index == size_ ? npos : index;
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr typename cesa::vector<T, maximum_size>::iterator
-cesa::vector<T, maximum_size>::end() noexcept
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr bool
+cesa::vector<T, maximum_size, alignment>::contains(const value_type &value) const
 {
-    return data() + size_;
+    return detail::find_index(data(), size_, value) != size_;
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr typename cesa::vector<T, maximum_size>::const_iterator
-cesa::vector<T, maximum_size>::end() const noexcept
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::size_type
+cesa::vector<T, maximum_size, alignment>::count(const value_type &value) const
 {
-    return data() + size_;
+    return detail::count_equal(data(), size_, value);
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr typename cesa::vector<T, maximum_size>::const_iterator
-cesa::vector<T, maximum_size>::cend() const noexcept
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::iterator
+cesa::vector<T, maximum_size, alignment>::begin() noexcept
 {
-    return data() + size_;
+    return make_iterator(0);
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr typename cesa::vector<T, maximum_size>::reverse_iterator
-cesa::vector<T, maximum_size>::rbegin() noexcept
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::const_iterator
+cesa::vector<T, maximum_size, alignment>::begin() const noexcept
+{
+    return make_iterator(0);
+}
+
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::const_iterator
+cesa::vector<T, maximum_size, alignment>::cbegin() const noexcept
+{
+    return make_iterator(0);
+}
+
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::iterator
+cesa::vector<T, maximum_size, alignment>::end() noexcept
+{
+    return make_iterator(size_);
+}
+
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::const_iterator
+cesa::vector<T, maximum_size, alignment>::end() const noexcept
+{
+    return make_iterator(size_);
+}
+
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::const_iterator
+cesa::vector<T, maximum_size, alignment>::cend() const noexcept
+{
+    return make_iterator(size_);
+}
+
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::reverse_iterator
+cesa::vector<T, maximum_size, alignment>::rbegin() noexcept
 {
     return reverse_iterator(end());
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr typename cesa::vector<T, maximum_size>::const_reverse_iterator
-cesa::vector<T, maximum_size>::rbegin() const noexcept
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::const_reverse_iterator
+cesa::vector<T, maximum_size, alignment>::rbegin() const noexcept
 {
     return const_reverse_iterator(end());
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr typename cesa::vector<T, maximum_size>::const_reverse_iterator
-cesa::vector<T, maximum_size>::crbegin() const noexcept
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::const_reverse_iterator
+cesa::vector<T, maximum_size, alignment>::crbegin() const noexcept
 {
     return const_reverse_iterator(end());
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr typename cesa::vector<T, maximum_size>::reverse_iterator
-cesa::vector<T, maximum_size>::rend() noexcept
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::reverse_iterator
+cesa::vector<T, maximum_size, alignment>::rend() noexcept
 {
     return reverse_iterator(begin());
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr typename cesa::vector<T, maximum_size>::const_reverse_iterator
-cesa::vector<T, maximum_size>::rend() const noexcept
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::const_reverse_iterator
+cesa::vector<T, maximum_size, alignment>::rend() const noexcept
 {
     return const_reverse_iterator(begin());
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr typename cesa::vector<T, maximum_size>::const_reverse_iterator
-cesa::vector<T, maximum_size>::crend() const noexcept
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::const_reverse_iterator
+cesa::vector<T, maximum_size, alignment>::crend() const noexcept
 {
     return const_reverse_iterator(begin());
 }
 
-template <typename T, std::size_t maximum_size>
+template <typename T, std::size_t maximum_size, std::size_t alignment>
 constexpr bool
-cesa::vector<T, maximum_size>::empty() const noexcept
+cesa::vector<T, maximum_size, alignment>::empty() const noexcept
 {
     return size_ == 0;
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr typename cesa::vector<T, maximum_size>::size_type
-cesa::vector<T, maximum_size>::size() const noexcept
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::size_type
+cesa::vector<T, maximum_size, alignment>::size() const noexcept
 {
     return size_;
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr typename cesa::vector<T, maximum_size>::size_type
-cesa::vector<T, maximum_size>::max_size() const noexcept
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::size_type
+cesa::vector<T, maximum_size, alignment>::max_size() const noexcept
 {
-    return max_size_;
+    return maximum_size;
 }
 
-template <typename T, std::size_t maximum_size>
+template <typename T, std::size_t maximum_size, std::size_t alignment>
 constexpr void
-cesa::vector<T, maximum_size>::clear() noexcept
+cesa::vector<T, maximum_size, alignment>::resize(const size_type count)
 {
-    if constexpr (std::is_trivially_destructible_v<value_type>)
+    if (count > maximum_size)
+    {
+        instrumentation::on_overflow();
+        detail::report_error("vector capacity exceeded");
+    }
+    if (count < size_)
+    {
+        instrumentation::on_erase(size_ - count, 0);
+        std::destroy(ptr_at(count), ptr_at(size_));
+    }
+    else
     {
-        size_ = 0;
+        instrumentation::on_insert(count - size_, 0, count);
+        detail::uninitialized_value_construct(ptr_at(size_), ptr_at(count));
+    }
+    size_ = static_cast<size_counter_type>(count);
+    invalidate_iterators();
+}
+
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr void
+cesa::vector<T, maximum_size, alignment>::resize(const size_type count, const value_type &value)
+{
+    if (count > maximum_size)
+    {
+        instrumentation::on_overflow();
+        detail::report_error("vector capacity exceeded");
+    }
+    if (count < size_)
+    {
+        instrumentation::on_erase(size_ - count, 0);
+        std::destroy(ptr_at(count), ptr_at(size_));
+    }
+    else
+    {
+        instrumentation::on_insert(count - size_, 0, count);
+        detail::uninitialized_fill_n(ptr_at(size_), count - size_, value);
+    }
+    size_ = static_cast<size_counter_type>(count);
+    invalidate_iterators();
+}
+
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr void
+cesa::vector<T, maximum_size, alignment>::resize(const size_type count, default_init_t)
+{
+    if (count > maximum_size)
+    {
+        instrumentation::on_overflow();
+        detail::report_error("vector capacity exceeded");
+    }
+    if (count < size_)
+    {
+        instrumentation::on_erase(size_ - count, 0);
+        std::destroy(ptr_at(count), ptr_at(size_));
+    }
+    else
+    {
+        instrumentation::on_insert(count - size_, 0, count);
+        detail::uninitialized_default_construct(ptr_at(size_), ptr_at(count));
+    }
+    size_ = static_cast<size_counter_type>(count);
+    invalidate_iterators();
+}
+
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr void
+cesa::vector<T, maximum_size, alignment>::clear() noexcept
+{
+    if constexpr (!std::is_trivially_destructible_v<value_type>)
+    {
+        std::destroy(ptr_at(0), ptr_at(size_));
+    }
+    instrumentation::on_erase(size_, 0);
+    size_ = 0;
+    invalidate_iterators();
+}
+
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr void
+cesa::vector<T, maximum_size, alignment>::assign(const size_type count, const value_type &value)
+{
+    if (count > maximum_size)
+    {
+        instrumentation::on_overflow();
+        detail::report_error("vector capacity exceeded");
+    }
+    // Copy first, as value may refer to an element that is about to be destroyed
+    const value_type copy(value);
+    clear();
+    detail::uninitialized_fill_n(ptr_at(0), count, copy);
+    size_ = static_cast<size_counter_type>(count);
+    invalidate_iterators();
+    instrumentation::on_insert(count, 0, count);
+}
+
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+template <class InputIt, typename>
+constexpr void
+cesa::vector<T, maximum_size, alignment>::assign(InputIt first, InputIt last)
+{
+    clear();
+    if constexpr (detail::is_forward_iterator_v<InputIt>)
+    {
+        const auto count = static_cast<size_type>(std::distance(first, last));
+        if (count > maximum_size)
+        {
+            instrumentation::on_overflow();
+            detail::report_error("vector capacity exceeded");
+        }
+        if constexpr (std::contiguous_iterator<InputIt> && std::is_trivially_copyable_v<value_type> &&
+                      std::is_same_v<std::iter_value_t<InputIt>, value_type>)
+        {
+            if (count > 0 && !std::is_constant_evaluated())
+            {
+                std::memcpy(static_cast<void *>(data()), std::to_address(first), count * sizeof(value_type));
+            }
+            else
+            {
+                detail::uninitialized_copy(first, last, ptr_at(0));
+            }
+        }
+        else
+        {
+            detail::uninitialized_copy(first, last, ptr_at(0));
+        }
+        size_ = static_cast<size_counter_type>(count);
+        invalidate_iterators();
+        instrumentation::on_insert(count, 0, count);
     }
     else
     {
-        while (size_ > 0)
+        for (; first != last; ++first)
         {
-            pop_back();
+            emplace_back(*first);
         }
     }
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr typename cesa::vector<T, maximum_size>::iterator
-cesa::vector<T, maximum_size>::insert(const_iterator pos, const value_type &value)
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr void
+cesa::vector<T, maximum_size, alignment>::assign(std::initializer_list<value_type> initializer_list)
+{
+    assign(initializer_list.begin(), initializer_list.end());
+}
+
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::iterator
+cesa::vector<T, maximum_size, alignment>::insert(const_iterator pos, const value_type &value)
 {
     return emplace(pos, value);
 }
 
-template <typename T, std::size_t max_elements>
-constexpr typename cesa::vector<T, max_elements>::iterator
-cesa::vector<T, max_elements>::insert(const_iterator pos, value_type &&value)
+template <typename T, std::size_t max_elements, std::size_t alignment>
+constexpr typename cesa::vector<T, max_elements, alignment>::iterator
+cesa::vector<T, max_elements, alignment>::insert(const_iterator pos, value_type &&value)
 {
     return emplace(pos, std::move(value));
 }
 
-template <typename T, std::size_t max_elements>
-constexpr typename cesa::vector<T, max_elements>::iterator
-cesa::vector<T, max_elements>::insert(const_iterator pos, size_type count, const value_type &value)
+template <typename T, std::size_t max_elements, std::size_t alignment>
+constexpr typename cesa::vector<T, max_elements, alignment>::iterator
+cesa::vector<T, max_elements, alignment>::insert(const_iterator pos, const size_type count, const value_type &value)
 {
-    iterator it = begin() + std::distance(cbegin(), pos);
-    while (count-- > 0)
+    const size_type index = index_of_position(pos);
+    if (count > max_elements - size_)
+    {
+        instrumentation::on_overflow();
+        detail::report_error("vector capacity exceeded");
+    }
+    // Copy first, as value may refer to an element that is about to be shifted
+    const value_type copy(value);
+    open_gap(index, count);
+#if CESA_HAS_EXCEPTIONS
+    try
     {
-        it = insert(it, value);
-        ++it;
+        detail::uninitialized_fill_n(ptr_at(index), count, copy);
     }
-    return it;
+    catch (...)
+    {
+        close_gap(index, count);
+        throw;
+    }
+#else
+    detail::uninitialized_fill_n(ptr_at(index), count, copy);
+#endif
+    instrumentation::on_insert(count, size_ - index, size_ + count);
+    size_ = static_cast<size_counter_type>(size_ + count);
+    invalidate_iterators();
+    return make_iterator(index);
 }
 
-template <typename T, std::size_t max_elements>
+template <typename T, std::size_t max_elements, std::size_t alignment>
 template <class InputIt, typename>
-constexpr typename cesa::vector<T, max_elements>::iterator
-cesa::vector<T, max_elements>::insert(const_iterator pos, InputIt first, InputIt last)
+constexpr typename cesa::vector<T, max_elements, alignment>::iterator
+cesa::vector<T, max_elements, alignment>::insert(const_iterator pos, InputIt first, InputIt last)
 {
-    iterator it = begin() + std::distance(cbegin(), pos);
-    while (first != last)
+    const size_type index = index_of_position(pos);
+    if constexpr (detail::is_forward_iterator_v<InputIt>)
     {
-        it = insert(it, *first);
-        ++first;
-        ++it;
+        const auto count = static_cast<size_type>(std::distance(first, last));
+        if (count > max_elements - size_)
+        {
+            instrumentation::on_overflow();
+            detail::report_error("vector capacity exceeded");
+        }
+        open_gap(index, count);
+#if CESA_HAS_EXCEPTIONS
+        try
+        {
+            detail::uninitialized_copy(first, last, ptr_at(index));
+        }
+        catch (...)
+        {
+            close_gap(index, count);
+            throw;
+        }
+#else
+        detail::uninitialized_copy(first, last, ptr_at(index));
+#endif
+        instrumentation::on_insert(count, size_ - index, size_ + count);
+        size_ = static_cast<size_counter_type>(size_ + count);
+        invalidate_iterators();
     }
-    return it;
+    else
+    {
+        // Single-pass iterators cannot be measured up front, so append and rotate into place
+        const size_type old_size = size_;
+        for (; first != last; ++first)
+        {
+            emplace_back(*first);
+        }
+        std::rotate(ptr_at(index), ptr_at(old_size), ptr_at(size_));
+        instrumentation::on_insert(0, old_size - index, size_);
+    }
+    return make_iterator(index);
 }
 
-template <typename T, std::size_t max_elements>
-constexpr typename cesa::vector<T, max_elements>::iterator
-cesa::vector<T, max_elements>::insert(const const_iterator              pos,
-                                      std::initializer_list<value_type> initializer_list)
+template <typename T, std::size_t max_elements, std::size_t alignment>
+constexpr typename cesa::vector<T, max_elements, alignment>::iterator
+cesa::vector<T, max_elements, alignment>::insert(const const_iterator              pos,
+                                                 std::initializer_list<value_type> initializer_list)
 {
     return insert(pos, initializer_list.begin(), initializer_list.end());
 }
 
-template <typename T, std::size_t maximum_size>
+template <typename T, std::size_t maximum_size, std::size_t alignment>
 template <class... Args>
-constexpr typename cesa::vector<T, maximum_size>::iterator
-cesa::vector<T, maximum_size>::emplace(const_iterator pos, Args &&... args)
+constexpr typename cesa::vector<T, maximum_size, alignment>::iterator
+cesa::vector<T, maximum_size, alignment>::emplace(const_iterator pos, Args &&... args)
 {
     if (size_ >= maximum_size)
     {
-        throw std::out_of_range("vector capacity exceeded");
+        instrumentation::on_overflow();
+        detail::report_error("vector capacity exceeded");
     }
-    const size_type index = pos == cend() ? size_ : std::distance(cbegin(), pos);
+    const size_type index = index_of_position(pos);
     if (index < size_)
     {
-        std::move_backward(begin() + index, end(), end() + 1);
+        // Construct first, as args may refer to an element that is about to be shifted
+        value_type value(std::forward<Args>(args)...);
+        open_gap(index, 1);
+        fill_gap(index, std::move(value));
+    }
+    else
+    {
+        std::construct_at(ptr_at(index), std::forward<Args>(args)...);
     }
-    new(ptr_at(index)) value_type(std::forward<Args>(args)...);
+    instrumentation::on_insert(1, size_ - index, size_ + 1U);
     size_ += 1;
-    return begin() + index;
+    invalidate_iterators();
+    return make_iterator(index);
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr typename cesa::vector<T, maximum_size>::iterator
-cesa::vector<T, maximum_size>::erase(const_iterator pos)
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::iterator
+cesa::vector<T, maximum_size, alignment>::erase(const_iterator pos)
 {
-    size_type index = std::distance(cbegin(), pos);
+    const size_type index = index_of_position(pos);
+    detail::debug_check(index < size_, "erasing the end iterator");
     if (index < size_)
     {
-        std::move(begin() + index + 1, end(), begin() + index);
-        pop_back();
+        if (std::is_trivially_copyable_v<value_type> && !std::is_constant_evaluated())
+        {
+            shift_elements<false>(index + 1, size_, 1);
+        }
+        else
+        {
+            std::move(ptr_at(index + 1), ptr_at(size_), ptr_at(index));
+        }
+        instrumentation::on_erase(1, size_ - index - 1U);
+        size_ -= 1;
+        invalidate_iterators();
+        std::destroy_at(ptr_at(size_));
+    }
+    return make_iterator(index);
+}
+
+template <typename T, std::size_t max_elements, std::size_t alignment>
+constexpr typename cesa::vector<T, max_elements, alignment>::iterator
+cesa::vector<T, max_elements, alignment>::erase(const_iterator first, const_iterator last)
+{
+    const size_type index     = index_of_position(first);
+    const size_type end_index = index_of_position(last);
+    detail::debug_check(index <= end_index, "erasing a range that ends before it begins");
+    const size_type count = end_index - index;
+    if (count > 0)
+    {
+        if (std::is_trivially_copyable_v<value_type> && !std::is_constant_evaluated())
+        {
+            shift_elements<false>(index + count, size_, count);
+        }
+        else
+        {
+            std::move(ptr_at(index + count), ptr_at(size_), ptr_at(index));
+            std::destroy(ptr_at(size_ - count), ptr_at(size_));
+        }
+        instrumentation::on_erase(count, size_ - index - count);
+        size_ = static_cast<size_counter_type>(size_ - count);
+        invalidate_iterators();
     }
-    return begin() + index;
+
+    return make_iterator(index);
 }
 
-template <typename T, std::size_t max_elements>
-constexpr typename cesa::vector<T, max_elements>::iterator
-cesa::vector<T, max_elements>::erase(const_iterator first, const_iterator last)
+template <typename T, std::size_t max_elements, std::size_t alignment>
+constexpr typename cesa::vector<T, max_elements, alignment>::iterator
+cesa::vector<T, max_elements, alignment>::erase_unordered(const_iterator pos)
 {
-    size_type index = std::distance(cbegin(), first);
-    size_type count = std::distance(first, last);
+    const size_type index = index_of_position(pos);
+    detail::debug_check(index < size_, "erasing the end iterator");
     if (index < size_)
     {
-        std::move(begin() + index + count, end(), begin() + index);
-        if constexpr (!std::is_default_constructible_v<value_type>)
+        const bool moved = index != size_ - 1U;
+        if (moved)
         {
-            for (auto it = begin() + index; it != end(); ++it)
-            {
-                it->~value_type();
-            }
+            *ptr_at(index) = std::move(*ptr_at(size_ - 1U));
         }
+        instrumentation::on_erase(1, moved ? 1 : 0);
+        size_ -= 1;
+        invalidate_iterators();
+        std::destroy_at(ptr_at(size_));
     }
-    size_ -= count;
+    return make_iterator(index);
+}
 
-    return begin() + index;
+template <typename T, std::size_t max_elements, std::size_t alignment>
+template <class UnaryPredicate>
+constexpr typename cesa::vector<T, max_elements, alignment>::size_type
+cesa::vector<T, max_elements, alignment>::erase_unordered_if(UnaryPredicate pred)
+{
+    const size_type old_size = size_;
+    size_type       index{};
+    while (index < size_)
+    {
+        if (pred(*ptr_at(index)))
+        {
+            erase_unordered(make_iterator(index));
+        }
+        else
+        {
+            ++index;
+        }
+    }
+    return old_size - size_;
+}
+
+template <typename T, std::size_t max_elements, std::size_t alignment>
+template <class UnaryPredicate>
+constexpr typename cesa::vector<T, max_elements, alignment>::size_type
+cesa::vector<T, max_elements, alignment>::erase_if(UnaryPredicate pred)
+{
+    const pointer   new_end = std::remove_if(ptr_at(0), ptr_at(size_), pred);
+    const size_type count   = std::distance(new_end, ptr_at(size_));
+    erase(make_iterator(size_ - count), make_iterator(size_));
+    return count;
 }
 
-template <typename T, std::size_t max_elements>
-constexpr typename cesa::vector<T, max_elements>::reference
-cesa::vector<T, max_elements>::push_back(const value_type &value)
+template <typename T, std::size_t max_elements, std::size_t alignment>
+template <class Compare>
+constexpr typename cesa::vector<T, max_elements, alignment>::iterator
+cesa::vector<T, max_elements, alignment>::insert_sorted(const value_type &value, Compare comp)
 {
-    return *emplace(end(), value);
+    // Copy first, as value may refer to an element that is about to be shifted
+    return insert_sorted(value_type(value), comp);
 }
 
-template <typename T, std::size_t maximum_size>
-constexpr typename cesa::vector<T, maximum_size>::reference
-cesa::vector<T, maximum_size>::push_back(value_type &&value)
+template <typename T, std::size_t max_elements, std::size_t alignment>
+template <class Compare>
+constexpr typename cesa::vector<T, max_elements, alignment>::iterator
+cesa::vector<T, max_elements, alignment>::insert_sorted(value_type &&value, Compare comp)
 {
-    return *emplace(end(), std::move(value));
+    if (size_ >= max_elements)
+    {
+        instrumentation::on_overflow();
+        detail::report_error("vector capacity exceeded");
+    }
+    const size_type index = std::distance(ptr_at(0), std::upper_bound(ptr_at(0), ptr_at(size_), value, comp));
+    open_gap(index, 1);
+    fill_gap(index, std::move(value));
+    instrumentation::on_insert(1, size_ - index, size_ + 1U);
+    size_ += 1;
+    invalidate_iterators();
+    return make_iterator(index);
 }
 
-template <typename T, std::size_t maximum_size>
+template <typename T, std::size_t max_elements, std::size_t alignment>
+template <class InputIt, class Compare, typename>
+constexpr void
+cesa::vector<T, max_elements, alignment>::merge_sorted(InputIt first, InputIt last, Compare comp)
+{
+    if constexpr (!detail::is_forward_iterator_v<InputIt>)
+    {
+        // A single-pass range cannot be counted without consuming it, so buffer it first
+        vector buffer(from_range, first, last);
+        merge_sorted(std::make_move_iterator(buffer.begin()), std::make_move_iterator(buffer.end()), comp);
+    }
+    else
+    {
+        const auto count = static_cast<size_type>(std::distance(first, last));
+        if (count > max_elements - size_)
+        {
+            instrumentation::on_overflow();
+            detail::report_error("vector capacity exceeded");
+        }
+        const size_type old_size = size_;
+        const size_type new_size = old_size + count;
+        size_type       moved{};
+        if constexpr (std::is_base_of_v<std::bidirectional_iterator_tag,
+                                        typename std::iterator_traits<InputIt>::iterator_category>)
+        {
+            moved = merge_backwards(first, last, comp, old_size, new_size);
+        }
+        else
+        {
+            moved = merge_forwards(first, last, comp, old_size, new_size);
+        }
+        instrumentation::on_insert(count, moved, new_size);
+        size_ = static_cast<size_counter_type>(new_size);
+        invalidate_iterators();
+    }
+}
+
+template <typename T, std::size_t max_elements, std::size_t alignment>
+template <class BinaryPredicate>
+constexpr typename cesa::vector<T, max_elements, alignment>::size_type
+cesa::vector<T, max_elements, alignment>::unique_sorted(BinaryPredicate pred)
+{
+    const pointer   new_end = std::unique(ptr_at(0), ptr_at(size_), pred);
+    const size_type count   = std::distance(new_end, ptr_at(size_));
+    erase(make_iterator(size_ - count), make_iterator(size_));
+    return count;
+}
+
+template <typename T, std::size_t max_elements, std::size_t alignment>
+constexpr typename cesa::vector<T, max_elements, alignment>::reference
+cesa::vector<T, max_elements, alignment>::push_back(const value_type &value)
+{
+    return emplace_back(value);
+}
+
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr typename cesa::vector<T, maximum_size, alignment>::reference
+cesa::vector<T, maximum_size, alignment>::push_back(value_type &&value)
+{
+    return emplace_back(std::move(value));
+}
+
+template <typename T, std::size_t maximum_size, std::size_t alignment>
 template <class... Args>
-constexpr typename cesa::vector<T, maximum_size>::reference
-cesa::vector<T, maximum_size>::emplace_back(Args &&... args)
+constexpr typename cesa::vector<T, maximum_size, alignment>::reference
+cesa::vector<T, maximum_size, alignment>::emplace_back(Args &&... args)
 {
-    return *emplace(end(), std::forward<Args>(args)...);
+    if (size_ >= maximum_size)
+    {
+        instrumentation::on_overflow();
+        detail::report_error("vector capacity exceeded");
+    }
+    return unchecked_emplace_back(std::forward<Args>(args)...);
 }
 
-template <typename T, std::size_t maximum_size>
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+template <class... Args>
+constexpr typename cesa::vector<T, maximum_size, alignment>::reference
+cesa::vector<T, maximum_size, alignment>::unchecked_emplace_back(Args &&... args) noexcept(
+    std::is_nothrow_constructible_v<value_type, Args &&...>)
+{
+    pointer element = std::construct_at(ptr_at(size_), std::forward<Args>(args)...);
+    size_ += 1;
+    invalidate_iterators();
+    instrumentation::on_insert(1, 0, size_);
+    return *element;
+}
+
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+template <class... Args>
+constexpr typename cesa::vector<T, maximum_size, alignment>::pointer
+cesa::vector<T, maximum_size, alignment>::try_emplace_back(Args &&... args) noexcept(
+    std::is_nothrow_constructible_v<value_type, Args &&...>)
+{
+    if (size_ >= maximum_size)
+    {
+        instrumentation::on_overflow();
+        return nullptr;
+    }
+    return &unchecked_emplace_back(std::forward<Args>(args)...);
+}
+
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr std::span<typename cesa::vector<T, maximum_size, alignment>::value_type>
+cesa::vector<T, maximum_size, alignment>::append_uninitialized(const size_type count)
+{
+    static_assert(std::is_trivial_v<value_type>, "append_uninitialized requires a trivial value_type");
+    if (count > maximum_size - size_)
+    {
+        instrumentation::on_overflow();
+        detail::report_error("vector capacity exceeded");
+    }
+    const size_type index = size_;
+    size_                 = static_cast<size_counter_type>(size_ + count);
+    invalidate_iterators();
+    instrumentation::on_insert(count, 0, size_);
+    return { ptr_at(index), count };
+}
+
+template <typename T, std::size_t maximum_size, std::size_t alignment>
+constexpr void
+cesa::vector<T, maximum_size, alignment>::resize_for_overwrite(const size_type count)
+{
+    static_assert(std::is_trivial_v<value_type>, "resize_for_overwrite requires a trivial value_type");
+    if (count > maximum_size)
+    {
+        instrumentation::on_overflow();
+        detail::report_error("vector capacity exceeded");
+    }
+    if (count < size_)
+    {
+        instrumentation::on_erase(size_ - count, 0);
+    }
+    else
+    {
+        instrumentation::on_insert(count - size_, 0, count);
+    }
+    size_ = static_cast<size_counter_type>(count);
+    invalidate_iterators();
+}
+
+template <typename T, std::size_t maximum_size, std::size_t alignment>
 constexpr void
-cesa::vector<T, maximum_size>::pop_back()
+cesa::vector<T, maximum_size, alignment>::pop_back()
 {
+    detail::debug_check(size_ > 0, "pop_back() called on an empty vector");
     if (size_ > 0)
     {
+        instrumentation::on_erase(1, 0);
         size_ -= 1;
-        if constexpr (!std::is_trivially_destructible_v<value_type>)
+        invalidate_iterators();
+        std::destroy_at(ptr_at(size_));
+    }
+}
+
+template <typename T, std::size_t max_elements, std::size_t alignment>
+constexpr typename cesa::vector<T, max_elements, alignment>::pointer
+cesa::vector<T, max_elements, alignment>::ptr_at(const size_type index) noexcept
+{
+    return storage_.elements + index;
+}
+
+template <typename T, std::size_t max_elements, std::size_t alignment>
+constexpr typename cesa::vector<T, max_elements, alignment>::const_pointer
+cesa::vector<T, max_elements, alignment>::ptr_at(const size_type index) const noexcept
+{
+    return storage_.elements + index;
+}
+
+template <typename T, std::size_t max_elements, std::size_t alignment>
+constexpr typename cesa::vector<T, max_elements, alignment>::iterator
+cesa::vector<T, max_elements, alignment>::make_iterator(const size_type index) noexcept
+{
+#if CESA_DEBUG
+    return iterator(this, static_cast<difference_type>(index));
+#else
+    return data() + index;
+#endif
+}
+
+template <typename T, std::size_t max_elements, std::size_t alignment>
+constexpr typename cesa::vector<T, max_elements, alignment>::const_iterator
+cesa::vector<T, max_elements, alignment>::make_iterator(const size_type index) const noexcept
+{
+#if CESA_DEBUG
+    return const_iterator(this, static_cast<difference_type>(index));
+#else
+    return data() + index;
+#endif
+}
+
+template <typename T, std::size_t max_elements, std::size_t alignment>
+constexpr typename cesa::vector<T, max_elements, alignment>::size_type
+cesa::vector<T, max_elements, alignment>::index_of_position(const const_iterator pos) const
+{
+#if CESA_DEBUG
+    return pos.position_in(this);
+#else
+    return static_cast<size_type>(pos - data());
+#endif
+}
+
+template <typename T, std::size_t max_elements, std::size_t alignment>
+constexpr void
+cesa::vector<T, max_elements, alignment>::invalidate_iterators() noexcept
+{
+#if CESA_DEBUG
+    ++generation_;
+#endif
+}
+
+template <typename T, std::size_t max_elements, std::size_t alignment>
+template <class BidirIt, class Compare>
+constexpr typename cesa::vector<T, max_elements, alignment>::size_type
+cesa::vector<T, max_elements, alignment>::merge_backwards(BidirIt first, BidirIt last, Compare &comp,
+                                                          const size_type old_size, const size_type new_size)
+{
+    // Fill the slots from the back with the greater of the last unmerged element and the last
+    // unmerged input, preferring the input on ties. dest - existing is the number of unmerged
+    // inputs, so once the input is exhausted, the remaining elements are already in place.
+    size_type  existing  = old_size;
+    size_type  dest      = new_size;
+    const auto fill_tail = [&]
+    {
+        // The slots past old_size are uninitialized, and elements moved from stay alive
+        while (dest > old_size)
+        {
+            --dest;
+            if (existing > 0 && comp(*std::prev(last), *ptr_at(existing - 1U)))
+            {
+                std::construct_at(ptr_at(dest), std::move(*ptr_at(--existing)));
+            }
+            else
+            {
+                std::construct_at(ptr_at(dest), *--last);
+            }
+        }
+    };
+    const auto fill_front = [&]
+    {
+        // Every slot is alive now, so the rest of the merge assigns
+        while (first != last)
         {
-            ptr_at(size_)->~value_type();
+            --dest;
+            if (existing > 0 && comp(*std::prev(last), *ptr_at(existing - 1U)))
+            {
+                *ptr_at(dest) = std::move(*ptr_at(--existing));
+            }
+            else
+            {
+                *ptr_at(dest) = *--last;
+            }
         }
+    };
+#if CESA_HAS_EXCEPTIONS
+    try
+    {
+        fill_tail();
+    }
+    catch (...)
+    {
+        std::destroy(ptr_at(dest + 1U), ptr_at(new_size));
+        throw;
     }
+    try
+    {
+        fill_front();
+    }
+    catch (...)
+    {
+        // [0, old_size) holds valid, if partly moved-from, elements, which the vector keeps
+        std::destroy(ptr_at(old_size), ptr_at(new_size));
+        throw;
+    }
+#else
+    fill_tail();
+    fill_front();
+#endif
+    return old_size - existing;
 }
 
-template <typename T, std::size_t max_elements>
-typename cesa::vector<T, max_elements>::pointer
-cesa::vector<T, max_elements>::ptr_at(const size_type index) noexcept
+template <typename T, std::size_t max_elements, std::size_t alignment>
+template <class ForwardIt, class Compare>
+constexpr typename cesa::vector<T, max_elements, alignment>::size_type
+cesa::vector<T, max_elements, alignment>::merge_forwards(ForwardIt first, ForwardIt last, Compare &comp,
+                                                         const size_type old_size, const size_type new_size)
 {
-    return reinterpret_cast<pointer>(&storage_[index * sizeof(value_type)]);
+    // Relocate the elements to [count, new_size), then fill the slots from the front with the lesser
+    // of the next unmerged input and the next unmerged element, preferring the element on ties.
+    // [0, dest) and [source, new_size) are alive and [dest, source) is uninitialized, and once the
+    // input is exhausted, dest == source and the remaining elements are already in place.
+    open_gap(0, new_size - old_size);
+    size_type  dest   = 0;
+    size_type  source = new_size - old_size;
+    const auto fill   = [&]
+    {
+        while (first != last)
+        {
+            if (source < new_size && !comp(*first, *ptr_at(source)))
+            {
+                std::construct_at(ptr_at(dest), std::move(*ptr_at(source)));
+                std::destroy_at(ptr_at(source++));
+            }
+            else
+            {
+                std::construct_at(ptr_at(dest), *first);
+                ++first;
+            }
+            ++dest;
+        }
+    };
+#if CESA_HAS_EXCEPTIONS
+    try
+    {
+        fill();
+    }
+    catch (...)
+    {
+        // Keep the merged prefix and the unmerged elements, which together are still sorted
+        size_ = static_cast<size_counter_type>(new_size - (source - dest));
+        close_gap(dest, source - dest);
+        throw;
+    }
+#else
+    fill();
+#endif
+    return old_size;
 }
 
-template <typename T, std::size_t max_elements>
-typename cesa::vector<T, max_elements>::const_pointer
-cesa::vector<T, max_elements>::ptr_at(const size_type index) const noexcept
+template <typename T, std::size_t max_elements, std::size_t alignment>
+constexpr void
+cesa::vector<T, max_elements, alignment>::open_gap(const size_type index, const size_type count)
 {
-    return reinterpret_cast<const_pointer>(&storage_[index * sizeof(value_type)]);
+    if (index >= size_ || count == 0)
+    {
+        return;
+    }
+    if (is_trivially_relocatable_v<value_type> && !std::is_constant_evaluated())
+    {
+        shift_elements<true>(index, size_, count);
+    }
+    else if (std::is_nothrow_move_constructible_v<value_type>)
+    {
+        for (size_type i = size_; i-- > index;)
+        {
+            std::construct_at(ptr_at(i + count), std::move(*ptr_at(i)));
+            std::destroy_at(ptr_at(i));
+        }
+    }
+    else
+    {
+        // Construct the slots past the end first and shift the rest by assignment, so that every
+        // element stays alive until the shift is complete and a failure only has to destroy the
+        // slots past the end. Copies are preferred to moves that may throw, as in std::vector.
+        const size_type split       = std::max<size_type>(size_, index + count);
+        size_type       constructed = split;
+        const auto      shift       = [&]
+        {
+            for (; constructed < size_ + count; ++constructed)
+            {
+                std::construct_at(ptr_at(constructed), std::move_if_noexcept(*ptr_at(constructed - count)));
+            }
+            std::move_backward(ptr_at(index), ptr_at(split - count), ptr_at(split));
+        };
+#if CESA_HAS_EXCEPTIONS
+        try
+        {
+            shift();
+        }
+        catch (...)
+        {
+            std::destroy(ptr_at(split), ptr_at(constructed));
+            throw;
+        }
+#else
+        shift();
+#endif
+        std::destroy(ptr_at(index), ptr_at(std::min<size_type>(size_, index + count)));
+    }
 }
 
-template <typename S, std::size_t SizeA, std::size_t SizeB>
-constexpr bool
-operator==(cesa::vector<S, SizeA> &lhs,
-           cesa::vector<S, SizeB> &rhs)
+template <typename T, std::size_t max_elements, std::size_t alignment>
+constexpr void
+cesa::vector<T, max_elements, alignment>::close_gap(const size_type index, const size_type count)
 {
-    return lhs.size_ == rhs.size_ && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    if (index >= size_ || count == 0)
+    {
+        return;
+    }
+    if (is_trivially_relocatable_v<value_type> && !std::is_constant_evaluated())
+    {
+        shift_elements<false>(index + count, size_ + count, count);
+    }
+    else if (std::is_nothrow_move_constructible_v<value_type>)
+    {
+        for (size_type i = index; i < size_; ++i)
+        {
+            std::construct_at(ptr_at(i), std::move(*ptr_at(i + count)));
+            std::destroy_at(ptr_at(i + count));
+        }
+    }
+    else
+    {
+        // Construct the uninitialized slots and assign the others, then destroy the elements left
+        // past the end. A failure leaves a hole that cannot be closed without another move.
+        const size_type old_end = size_ + count;
+        size_type       i       = index;
+        const auto      shift   = [&]
+        {
+            for (; i < size_; ++i)
+            {
+                if (i < index + count)
+                {
+                    std::construct_at(ptr_at(i), std::move_if_noexcept(*ptr_at(i + count)));
+                }
+                else
+                {
+                    *ptr_at(i) = std::move(*ptr_at(i + count));
+                }
+            }
+        };
+#if CESA_HAS_EXCEPTIONS
+        try
+        {
+            shift();
+        }
+        catch (...)
+        {
+            std::destroy(ptr_at(index), ptr_at(std::min<size_type>(i, index + count)));
+            std::destroy(ptr_at(index + count), ptr_at(old_end));
+            size_ = static_cast<size_counter_type>(index);
+            throw;
+        }
+#else
+        shift();
+#endif
+        std::destroy(ptr_at(std::max<size_type>(size_, index + count)), ptr_at(old_end));
+    }
+}
+
+template <typename T, std::size_t max_elements, std::size_t alignment>
+constexpr void
+cesa::vector<T, max_elements, alignment>::fill_gap(const size_type index, value_type &&value)
+{
+#if CESA_HAS_EXCEPTIONS
+    try
+    {
+        std::construct_at(ptr_at(index), std::move(value));
+    }
+    catch (...)
+    {
+        close_gap(index, 1);
+        throw;
+    }
+#else
+    std::construct_at(ptr_at(index), std::move(value));
+#endif
+}
+
+template <typename T, std::size_t max_elements, std::size_t alignment>
+void
+cesa::vector<T, max_elements, alignment>::copy_storage(const vector &other) noexcept
+{
+    if constexpr (detail::is_tiny_storage_v<value_type, max_elements>)
+    {
+        std::memcpy(static_cast<void *>(&storage_), &other.storage_, sizeof(storage_type));
+    }
+    else
+    {
+        std::memcpy(static_cast<void *>(data()), other.data(), other.size_ * sizeof(value_type));
+    }
+}
+
+template <typename T, std::size_t max_elements, std::size_t alignment>
+template <bool towards_end>
+void
+cesa::vector<T, max_elements, alignment>::shift_elements(const size_type first, const size_type last,
+                                                         const size_type count) noexcept
+{
+    if constexpr (detail::is_tiny_storage_v<value_type, max_elements>)
+    {
+        detail::unrolled_shift<max_elements, towards_end>(ptr_at(0), first, last, count);
+    }
+    else if (first < last)
+    {
+        pointer destination = towards_end ? ptr_at(first + count) : ptr_at(first - count);
+        std::memmove(static_cast<void *>(destination), ptr_at(first), (last - first) * sizeof(value_type));
+    }
 }
 
+// The packed specialization cesa::vector<bool, N> builds on the definitions above
+#include "bitvector.hpp"
+
 #endif
\ No newline at end of file
@@ -0,0 +1,132 @@
+/**
+ * algorithms_tests.cpp
+ *
+ * Runtime tests for the cesa::algorithms parallel policies: vectors above CESA_PARALLEL_THRESHOLD
+ * are split into chunks, and every algorithm must agree with its standard counterpart, including
+ * when a parallel algorithm is called from inside a chunk. The target sets CESA_PARALLEL_THREADS,
+ * so that the pool has workers on machines with a single core.
+ */
+
+#include "check.hpp"
+
+#include <cesa/algorithms.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <random>
+
+namespace
+{
+    using cesa::test::check;
+
+    constexpr std::size_t element_count = 3 * CESA_PARALLEL_THRESHOLD + 123;
+
+    using ints  = cesa::vector<int, element_count>;
+    using longs = cesa::vector<long long, element_count>;
+
+    std::unique_ptr<ints>
+    random_ints(const unsigned seed)
+    {
+        std::mt19937 engine(seed);
+        auto         v = std::make_unique<ints>();
+        for (std::size_t i{}; i < element_count; ++i)
+        {
+            v->push_back(static_cast<int>(engine() % 1000) - 500);
+        }
+        return v;
+    }
+
+    void
+    test_sort()
+    {
+        const auto v      = random_ints(1);
+        auto       sorted = std::make_unique<ints>(*v);
+        auto       model  = std::make_unique<ints>(*v);
+        cesa::algorithms::sort(cesa::algorithms::par, *sorted);
+        std::sort(model->begin(), model->end());
+        check(*sorted == *model, "par sort matches std::sort");
+
+        cesa::algorithms::sort(cesa::algorithms::par_unseq, *sorted, std::greater<>());
+        std::sort(model->begin(), model->end(), std::greater<>());
+        check(*sorted == *model, "par_unseq sort with a comparator matches std::sort");
+    }
+
+    void
+    test_reduce()
+    {
+        const auto v = random_ints(2);
+        check(cesa::algorithms::reduce(cesa::algorithms::par, *v) == std::accumulate(v->begin(), v->end(), 0),
+              "par reduce with the SIMD kernel matches std::accumulate");
+        const long long init = 1LL << 40;
+        check(cesa::algorithms::reduce(cesa::algorithms::par, *v, init) ==
+                  std::accumulate(v->begin(), v->end(), init),
+              "par reduce into a wider type matches std::accumulate");
+        const auto max = [](const int lhs, const int rhs) { return std::max(lhs, rhs); };
+        check(cesa::algorithms::reduce(cesa::algorithms::par, *v, -1000, max) ==
+                  *std::max_element(v->begin(), v->end()),
+              "par reduce with a custom operation");
+    }
+
+    void
+    test_extremes()
+    {
+        // Every value occurs many times, so the results also check that ties resolve to the first
+        auto       v    = random_ints(3);
+        const auto less = [](const int lhs, const int rhs) { return lhs < rhs; };
+        check(cesa::algorithms::min_element(cesa::algorithms::par, *v) == std::min_element(v->begin(), v->end()),
+              "par min_element with the SIMD kernel matches std::min_element");
+        check(cesa::algorithms::max_element(cesa::algorithms::par, *v) == std::max_element(v->begin(), v->end()),
+              "par max_element with the SIMD kernel matches std::max_element");
+        check(cesa::algorithms::min_element(cesa::algorithms::par, *v, less) ==
+                  std::min_element(v->begin(), v->end(), less),
+              "par min_element with a comparator matches std::min_element");
+        check(cesa::algorithms::max_element(cesa::algorithms::par, *v, less) ==
+                  std::max_element(v->begin(), v->end(), less),
+              "par max_element with a comparator matches std::max_element");
+    }
+
+    void
+    test_scans()
+    {
+        const auto v      = random_ints(4);
+        auto       result = std::make_unique<longs>();
+        auto       model  = std::make_unique<longs>(cesa::with_size, element_count);
+
+        cesa::algorithms::inclusive_scan(cesa::algorithms::par, *v, *result);
+        std::inclusive_scan(v->begin(), v->end(), model->begin(), std::plus<>(), 0LL);
+        check(*result == *model, "par inclusive_scan matches std::inclusive_scan");
+
+        cesa::algorithms::exclusive_scan(cesa::algorithms::par, *v, *result, 7LL);
+        std::exclusive_scan(v->begin(), v->end(), model->begin(), 7LL);
+        check(*result == *model, "par exclusive_scan matches std::exclusive_scan");
+    }
+
+    void
+    test_nested_runs()
+    {
+        // The pool is busy while the outer tasks run, so the inner algorithms run on their callers
+        const auto           v        = random_ints(5);
+        const int            expected = std::accumulate(v->begin(), v->end(), 0);
+        cesa::vector<int, 8> sums(cesa::with_size, 8);
+        cesa::algorithms::detail::thread_pool::instance().run(sums.size(), [&](const std::size_t task) {
+            sums[task] = cesa::algorithms::reduce(cesa::algorithms::par, *v);
+        });
+        check(std::all_of(sums.begin(), sums.end(), [&](const int sum) { return sum == expected; }),
+              "parallel algorithms called from inside a chunk");
+    }
+}
+
+int
+main()
+{
+    check(cesa::algorithms::detail::thread_pool::instance().concurrency() > 1, "the pool has workers");
+    test_sort();
+    test_reduce();
+    test_extremes();
+    test_scans();
+    test_nested_runs();
+    return cesa::test::exit_code();
+}
@@ -0,0 +1,195 @@
+/**
+ * arena_tests.cpp
+ *
+ * Runtime tests for cesa::arena and cesa::pool: the alignment and disjointness of successive
+ * allocations, exhaustion through both allocate() and try_allocate(), rewinding, and the reuse of
+ * freed pool blocks. std::pmr containers on a cesa::resource_adapter check that allocations are
+ * served from the source and forwarded to the upstream resource once it is exhausted.
+ */
+
+#include "check.hpp"
+
+#include <cesa/arena.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    using cesa::test::check;
+
+    bool
+    aligned(const void *p, const std::size_t align)
+    {
+        return reinterpret_cast<std::uintptr_t>(p) % align == 0;
+    }
+
+    const std::byte *
+    bytes(const void *p)
+    {
+        return static_cast<const std::byte *>(p);
+    }
+
+    void
+    test_arena_alignment()
+    {
+        cesa::arena<256, 16> arena;
+        void                *a = arena.allocate(1, 1);
+        void                *b = arena.allocate(8, 8);
+        void                *c = arena.allocate(3, 2);
+        void                *d = arena.allocate(16, 64);
+        check(aligned(b, 8) && aligned(c, 2) && aligned(d, 64), "successive allocations are aligned");
+        check(bytes(a) + 1 <= bytes(b) && bytes(b) + 8 <= bytes(c) && bytes(c) + 3 <= bytes(d),
+              "successive allocations do not overlap");
+        check(arena.owns(a) && arena.owns(d) && arena.used() == static_cast<std::size_t>(bytes(d) + 16 - bytes(a)),
+              "used() covers the allocations and their padding");
+        const int outside{};
+        check(!arena.owns(&outside) && !arena.owns(bytes(a) + arena.capacity()), "owns() rejects outside pointers");
+    }
+
+    void
+    test_arena_exhaustion()
+    {
+        cesa::arena<64> arena;
+        void           *first = arena.allocate(40);
+        check(arena.try_allocate(32) == nullptr && arena.used() == 40, "a failed try_allocate changes nothing");
+        try
+        {
+            (void)arena.allocate(32);
+            check(false, "allocate reports an exhausted arena");
+        }
+        catch (const std::out_of_range &)
+        {
+        }
+        check(arena.used() == 40 && arena.remaining() == 24, "a failed allocate changes nothing");
+        check(arena.try_allocate(24, 1) != nullptr && arena.remaining() == 0, "the last byte can be allocated");
+        check(arena.try_allocate(1, 1) == nullptr, "try_allocate on a full arena");
+
+        arena.reset();
+        check(arena.used() == 0 && arena.allocate(64) == first, "reset() releases everything");
+    }
+
+    void
+    test_arena_rewind()
+    {
+        cesa::arena<128> arena;
+        (void)arena.allocate(16);
+        const auto mark  = arena.mark();
+        void      *inner = arena.allocate(32);
+        {
+            cesa::arena_scope scope(arena);
+            (void)arena.allocate(48);
+            check(arena.used() == 96, "allocations inside a scope");
+        }
+        check(arena.used() == 48, "arena_scope rewinds to where it was entered");
+        arena.rewind(mark);
+        check(arena.used() == 16 && arena.allocate(32) == inner, "rewind() releases everything since mark()");
+        arena.rewind(arena.capacity());
+        check(arena.used() == 48, "rewinding forward changes nothing");
+    }
+
+    void
+    test_pool()
+    {
+        cesa::pool<24, 4>   pool;
+        std::vector<void *> blocks;
+        for (std::size_t i{}; i < pool.capacity(); ++i)
+        {
+            blocks.push_back(pool.allocate());
+        }
+        bool disjoint = true;
+        for (std::size_t i{}; i + 1 < blocks.size(); ++i)
+        {
+            disjoint = disjoint && bytes(blocks[i]) + 24 <= bytes(blocks[i + 1]);
+        }
+        check(disjoint && aligned(blocks.back(), alignof(std::max_align_t)) && pool.used() == 4,
+              "blocks are disjoint and aligned");
+        check(pool.try_allocate() == nullptr, "try_allocate on a full pool");
+        try
+        {
+            (void)pool.allocate();
+            check(false, "allocate reports a full pool");
+        }
+        catch (const std::out_of_range &)
+        {
+        }
+
+        pool.deallocate(blocks[1]);
+        pool.deallocate(blocks[3]);
+        check(pool.used() == 2, "deallocate returns blocks");
+        check(pool.allocate() == blocks[3] && pool.allocate() == blocks[1] && pool.try_allocate() == nullptr,
+              "freed blocks are reused most recently freed first, and only they are");
+
+        pool.reset();
+        try
+        {
+            (void)pool.allocate(25);
+            check(false, "allocate reports a request above the block size");
+        }
+        catch (const std::out_of_range &)
+        {
+        }
+        check(pool.try_allocate(8, 2 * alignof(std::max_align_t)) == nullptr, "try_allocate rejects over-alignment");
+        check(pool.used() == 0 && pool.allocate() == blocks[0], "reset() releases every block");
+    }
+
+    void
+    test_resource_adapter()
+    {
+        cesa::arena<1024>              arena;
+        cesa::resource_adapter         resource(arena);
+        std::pmr::vector<std::int64_t> values(&resource);
+        values.reserve(16);
+        for (std::int64_t i{}; i < 16; ++i)
+        {
+            values.push_back(i);
+        }
+        check(arena.owns(values.data()) && arena.used() >= 16 * sizeof(std::int64_t) && values.back() == 15,
+              "std::pmr::vector allocates from the arena");
+        try
+        {
+            values.reserve(1024);
+            check(false, "an exhausted arena fails with the null upstream resource");
+        }
+        catch (const std::bad_alloc &)
+        {
+        }
+        check(values.size() == 16 && arena.owns(values.data()), "a failed reserve keeps the arena buffer");
+
+        cesa::resource_adapter spilling(arena, std::pmr::new_delete_resource());
+        std::pmr::vector<int>  large(&spilling);
+        large.resize(1024, 7);
+        check(!arena.owns(large.data()) && large[1023] == 7, "an exhausted arena falls back to the upstream resource");
+
+        cesa::pool<64, 8>      pool;
+        cesa::resource_adapter nodes(pool);
+        {
+            std::pmr::list<int> list(&nodes);
+            for (int i{}; i < 8; ++i)
+            {
+                list.push_back(i);
+            }
+            check(pool.used() == 8, "std::pmr::list allocates one block per node");
+            list.pop_front();
+            list.push_back(8);
+            check(pool.used() == 8 && list.front() == 1 && list.back() == 8, "a freed node block is reused");
+        }
+        check(pool.used() == 0, "destroying the list returns every block");
+    }
+}
+
+int
+main()
+{
+    test_arena_alignment();
+    test_arena_exhaustion();
+    test_arena_rewind();
+    test_pool();
+    test_resource_adapter();
+    return cesa::test::exit_code();
+}
@@ -0,0 +1,252 @@
+/**
+ * bitvector_tests.cpp
+ *
+ * Runtime tests for cesa::bitvector and cesa::vector<bool, N>: the word-level bit operations at
+ * word boundaries, and the sequence interface against a std::vector<bool> model.
+ */
+
+#include "check.hpp"
+
+#include <cesa/vector.hpp>
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    using cesa::test::check;
+
+    template <class Bits>
+    bool
+    same(const Bits &bits, const std::vector<bool> &model)
+    {
+        return bits.size() == model.size() && std::equal(bits.begin(), bits.end(), model.begin());
+    }
+
+    void
+    test_ranges()
+    {
+        cesa::bitvector<200> bits(cesa::with_size, 200);
+        bits.set_range(60, 130);
+        check(bits.count() == 70, "set_range across two word boundaries");
+        check(!bits.test(59) && bits.test(60) && bits.test(63) && bits.test(64) && bits.test(128) &&
+                  bits.test(129) && !bits.test(130),
+              "set_range sets exactly [first, last)");
+        bits.reset_range(63, 65);
+        check(bits.count() == 68 && bits.test(62) && !bits.test(63) && !bits.test(64) && bits.test(65),
+              "reset_range across a word boundary");
+        bits.reset_range(0, 200);
+        check(bits.none(), "reset_range over every word");
+        bits.set_range(0, 200);
+        check(bits.all() && bits.count() == 200, "set_range over every word");
+        bits.set_range(10, 10);
+        bits.reset_range(10, 10);
+        check(bits.all(), "empty ranges change nothing");
+    }
+
+    void
+    test_find()
+    {
+        cesa::bitvector<128> bits(cesa::with_size, 128);
+        check(bits.find_first() == bits.npos, "find_first on clear bits");
+        bits.set(127);
+        check(bits.find_first() == 127, "find_first finds the last bit");
+        check(bits.find_next(126) == 127, "find_next finds the last bit");
+        check(bits.find_next(127) == bits.npos, "find_next after the last bit");
+        bits.set(63);
+        bits.set(64);
+        check(bits.find_next(62) == 63 && bits.find_next(63) == 64 && bits.find_next(64) == 127,
+              "find_next across word boundaries");
+
+        std::vector<std::size_t> found;
+        bits.for_each_set([&](const std::size_t i) { found.push_back(i); });
+        check(found == std::vector<std::size_t>{ 63, 64, 127 }, "for_each_set visits the set bits in order");
+    }
+
+    void
+    test_resize()
+    {
+        cesa::bitvector<150> bits(cesa::with_size, 150, true);
+        bits.resize(70);
+        check(bits.count() == 70, "count after shrinking");
+        bits.resize(150);
+        check(bits.count() == 70 && !bits.test(70) && !bits.test(149), "regrowing after shrinking adds clear bits");
+        bits.resize(100, true);
+        bits.resize(140, true);
+        check(bits.count() == 110, "count after shrinking and regrowing with set bits");
+        check(bits.words().size() == 3 && (bits.words()[2] >> (140 - 128)) == 0, "bits past size() stay clear");
+    }
+
+    void
+    test_comparison()
+    {
+        cesa::bitvector<100> a(cesa::with_size, 90, true);
+        cesa::bitvector<100> b(cesa::with_size, 90, true);
+        check(a == b, "equal bitvectors");
+        b.reset(80);
+        check(a != b && b < a && a > b, "a clear bit orders first");
+        b.set(80);
+        b.push_back(false);
+        check(a != b && a < b, "a prefix orders first");
+        a.resize(50);
+        b.resize(50);
+        b.resize(90);
+        a.resize(90);
+        check(a == b, "equality ignores the bits dropped by resize");
+        check((a <=> b) == std::strong_ordering::equal, "three-way comparison");
+    }
+
+    void
+    test_sequence_model()
+    {
+        std::mt19937                  engine(42);
+        cesa::bitvector<150>          bits;
+        std::vector<bool>             model;
+        const auto                    random = [&](const std::size_t bound) { return engine() % (bound + 1); };
+        for (int step{}; step < 20000; ++step)
+        {
+            const std::size_t pos  = random(model.size());
+            const bool        flag = engine() % 2 == 0;
+            switch (engine() % 7)
+            {
+            case 0:
+            {
+                const std::size_t count = std::min(random(70), bits.max_size() - bits.size());
+                bits.insert(bits.begin() + static_cast<std::ptrdiff_t>(pos), count, flag);
+                model.insert(model.begin() + static_cast<std::ptrdiff_t>(pos), count, flag);
+                break;
+            }
+            case 1:
+                if (model.size() < bits.max_size())
+                {
+                    bits.emplace(bits.begin() + static_cast<std::ptrdiff_t>(pos), flag);
+                    model.insert(model.begin() + static_cast<std::ptrdiff_t>(pos), flag);
+                }
+                break;
+            case 2:
+            {
+                std::vector<bool> values(std::min(random(70), bits.max_size() - bits.size()));
+                std::generate(values.begin(), values.end(), [&] { return engine() % 3 == 0; });
+                bits.insert(bits.begin() + static_cast<std::ptrdiff_t>(pos), values.begin(), values.end());
+                model.insert(model.begin() + static_cast<std::ptrdiff_t>(pos), values.begin(), values.end());
+                break;
+            }
+            case 3:
+            case 4:
+            {
+                const std::size_t last = pos + random(model.size() - pos);
+                bits.erase(bits.begin() + static_cast<std::ptrdiff_t>(pos),
+                           bits.begin() + static_cast<std::ptrdiff_t>(last));
+                model.erase(model.begin() + static_cast<std::ptrdiff_t>(pos),
+                            model.begin() + static_cast<std::ptrdiff_t>(last));
+                break;
+            }
+            case 5:
+                if (pos < model.size())
+                {
+                    bits.erase(bits.begin() + static_cast<std::ptrdiff_t>(pos));
+                    model.erase(model.begin() + static_cast<std::ptrdiff_t>(pos));
+                }
+                break;
+            default:
+                if (model.size() < bits.max_size())
+                {
+                    bits.emplace_back(flag);
+                    model.push_back(flag);
+                }
+                break;
+            }
+            const auto set_bits = static_cast<std::size_t>(std::count(model.begin(), model.end(), true));
+            if (!same(bits, model) || bits.count() != set_bits)
+            {
+                check(false, "insert and erase match std::vector<bool>");
+                return;
+            }
+        }
+    }
+
+    void
+    test_assign_and_overflow()
+    {
+        cesa::bitvector<70> bits{ true, false, true };
+        bits.assign(65, true);
+        check(bits.size() == 65 && bits.all(), "assign(count, value)");
+        std::istringstream stream("1 0 0 1");
+        bits.assign(std::istream_iterator<int>(stream), std::istream_iterator<int>());
+        check(same(bits, { true, false, false, true }), "assign from a single-pass range");
+        std::istringstream more("1 1");
+        bits.insert(bits.begin() + 1, std::istream_iterator<int>(more), std::istream_iterator<int>());
+        check(same(bits, { true, true, true, false, false, true }), "insert from a single-pass range");
+        bits.assign({ false, true });
+        check(same(bits, { false, true }), "assign(initializer_list)");
+
+        try
+        {
+            bits.insert(bits.begin(), 69, true);
+            check(false, "insert reports a full bitvector");
+        }
+        catch (const std::out_of_range &)
+        {
+        }
+        try
+        {
+            bits.assign(71, true);
+            check(false, "assign reports a count above the capacity");
+        }
+        catch (const std::out_of_range &)
+        {
+        }
+        check(same(bits, { false, true }), "a failed insertion or assignment leaves the bits unchanged");
+    }
+
+    void
+    test_vector_of_bool()
+    {
+        cesa::vector<bool, 16> v(true, false);
+        v.emplace_back(true);
+        v.insert(v.begin(), false);
+        v.erase(v.begin() + 1);
+        v.assign(3, true);
+        v.push_back(false);
+        const cesa::vector<bool, 16> w{ true, true, true, true };
+        check(v.size() == 4 && v != w && v < w && !(w < v), "vector<bool, N> keeps the sequence interface");
+    }
+
+    void
+    test_pop_back()
+    {
+        cesa::bitvector<128> bits(cesa::with_size, 65, true);
+        bits.pop_back();
+        check(bits.size() == 64 && bits.count() == 64, "pop_back removes the last bit");
+        bits.resize(65);
+        check(!bits.test(64), "pop_back clears the removed bit");
+
+        cesa::bitvector<128> empty;
+        empty.pop_back();
+        check(empty.empty() && empty.none(), "pop_back on an empty bitvector does nothing");
+        cesa::vector<bool, 16> v;
+        v.pop_back();
+        v.push_back(true);
+        check(v.size() == 1 && v.front(), "pop_back on an empty vector<bool, N> does nothing");
+    }
+}
+
+int
+main()
+{
+    test_ranges();
+    test_find();
+    test_resize();
+    test_comparison();
+    test_sequence_model();
+    test_assign_and_overflow();
+    test_vector_of_bool();
+    test_pop_back();
+    return cesa::test::exit_code();
+}
@@ -0,0 +1,34 @@
+#ifndef CESA_TESTS_CHECK_HPP
+#define CESA_TESTS_CHECK_HPP
+
+/**
+ * check.hpp
+ *
+ * The minimal harness shared by the runtime tests: check() reports a failed condition and counts
+ * it, and each test program returns exit_code() from main, so that ctest sees the failure.
+ */
+
+#include <cstdio>
+
+namespace cesa::test
+{
+    inline int failures{};
+
+    inline void
+    check(const bool condition, const char *what)
+    {
+        if (!condition)
+        {
+            std::fprintf(stderr, "check failed: %s\n", what);
+            ++failures;
+        }
+    }
+
+    [[nodiscard]] inline int
+    exit_code() noexcept
+    {
+        return failures == 0 ? 0 : 1;
+    }
+}
+
+#endif
@@ -0,0 +1,153 @@
+/**
+ * concurrent_vector_tests.cpp
+ *
+ * Runtime tests for cesa::concurrent_vector with several producer threads: more appends than fit,
+ * which must fill every slot exactly once and report the overflow, and a seal() racing with the
+ * producers, after which the span must be final. A counted element type checks that reset()
+ * destroys exactly the published elements.
+ */
+
+#include "check.hpp"
+
+#include <cesa/concurrent_vector.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using cesa::test::check;
+
+    constexpr int producer_count     = 4;
+    constexpr int appends_per_thread = 3000;
+
+    struct counted
+    {
+        inline static std::atomic<long> live{};
+
+        int producer;
+        int sequence;
+
+        counted(const int p, const int s) noexcept
+            : producer(p)
+            , sequence(s)
+        {
+            live.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        counted(const counted &other) noexcept
+            : counted(other.producer, other.sequence)
+        {
+        }
+
+        ~counted()
+        {
+            live.fetch_sub(1, std::memory_order_relaxed);
+        }
+    };
+
+    using batch = cesa::concurrent_vector<counted, 8192>;
+
+    /**
+     * Runs the producers, each appending appends_per_thread elements, and calls during() on this
+     * thread while they run. Returns the number of successful appends.
+     */
+    template <class F>
+    long
+    produce(batch &elements, F &&during)
+    {
+        std::atomic<long>        appended{};
+        std::vector<std::thread> producers;
+        for (int p{}; p < producer_count; ++p)
+        {
+            producers.emplace_back([&, p] {
+                long local{};
+                for (int s{}; s < appends_per_thread; ++s)
+                {
+                    if (elements.try_emplace_back(p, s) != nullptr)
+                    {
+                        ++local;
+                    }
+                }
+                appended.fetch_add(local, std::memory_order_relaxed);
+            });
+        }
+        during();
+        for (std::thread &producer : producers)
+        {
+            producer.join();
+        }
+        return appended.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Whether the elements of every producer are the first appends it made, in order. Once an
+     * append fails, all later ones fail too, so the accepted appends of a producer are a prefix.
+     */
+    bool
+    producer_prefixes(const std::span<const counted> elements)
+    {
+        int next[producer_count]{};
+        for (const counted &element : elements)
+        {
+            if (element.sequence != next[element.producer])
+            {
+                return false;
+            }
+            ++next[element.producer];
+        }
+        return true;
+    }
+
+    void
+    test_overflow()
+    {
+        static batch elements;
+        const long   appended = produce(elements, [] {});
+        const auto   span     = elements.seal();
+        check(appended == static_cast<long>(batch::max_size()), "exactly max_size() appends succeed");
+        check(span.size() == batch::max_size(), "seal() returns a full span");
+        check(elements.overflowed(), "overflowed() reports the rejected appends");
+        check(producer_prefixes(span), "every slot holds one append, in the order of its producer");
+        check(counted::live.load() == static_cast<long>(batch::max_size()), "failed appends construct nothing");
+        check(elements.try_emplace_back(0, 0) == nullptr, "a sealed vector rejects appends");
+
+        elements.reset();
+        check(counted::live.load() == 0, "reset() destroys every element");
+        check(!elements.sealed() && !elements.overflowed() && elements.size_approx() == 0,
+              "reset() reopens the vector");
+    }
+
+    void
+    test_racing_seal()
+    {
+        static batch       elements;
+        std::span<counted> span;
+        const long         appended = produce(elements, [&] {
+            std::this_thread::yield();
+            span = elements.seal();
+        });
+        bool published = true;
+        for (std::size_t i{}; i < span.size(); ++i)
+        {
+            published = published && elements.is_published(i);
+        }
+        check(static_cast<long>(span.size()) == appended, "the sealed span holds every accepted append");
+        check(published, "every element in the sealed span is published");
+        check(producer_prefixes(span), "the sealed span keeps the order of every producer");
+        check(counted::live.load() == appended, "appends rejected by seal() construct nothing");
+        elements.reset();
+        check(counted::live.load() == 0, "reset() after a racing seal destroys every element");
+    }
+}
+
+int
+main()
+{
+    test_overflow();
+    test_racing_seal();
+    return cesa::test::exit_code();
+}
@@ -0,0 +1,202 @@
+/**
+ * constexpr_tests.cpp
+ *
+ * Compile-time tests: every check in this file is a static_assert, so the file only builds if
+ * cesa::vector works during constant evaluation. It is linked into cesa_tests together with the
+ * runtime tests in lifetime_tests.cpp.
+ */
+
+#include <cesa/vector.hpp>
+
+#include <cstdint>
+#include <utility>
+
+namespace
+{
+    /**
+     * A literal type that owns heap memory, so that a missing or duplicate construction or
+     * destruction is rejected by the constant evaluator as a leak, double delete or use of
+     * an object outside its lifetime.
+     */
+    class boxed
+    {
+    public:
+        constexpr boxed(const int value)
+            : value_(new int(value))
+        {
+        }
+
+        constexpr boxed(const boxed &other)
+            : value_(new int(*other.value_))
+        {
+        }
+
+        constexpr boxed(boxed &&other) noexcept
+            : value_(std::exchange(other.value_, nullptr))
+        {
+        }
+
+        constexpr boxed &
+        operator=(const boxed &other)
+        {
+            *value_ = *other.value_;
+            return *this;
+        }
+
+        constexpr boxed &
+        operator=(boxed &&other) noexcept
+        {
+            delete value_;
+            value_ = std::exchange(other.value_, nullptr);
+            return *this;
+        }
+
+        constexpr ~boxed()
+        {
+            delete value_;
+        }
+
+        [[nodiscard]] constexpr int
+        value() const
+        {
+            return *value_;
+        }
+
+        [[nodiscard]] friend constexpr bool
+        operator==(const boxed &lhs, const boxed &rhs)
+        {
+            return lhs.value() == rhs.value();
+        }
+
+    private:
+        int *value_;
+    };
+
+    constexpr int
+    value_of(const int value)
+    {
+        return value;
+    }
+
+    constexpr int
+    value_of(const boxed &value)
+    {
+        return value.value();
+    }
+
+    template <typename T, std::size_t max_elements>
+    constexpr int
+    sum(const cesa::vector<T, max_elements> &v)
+    {
+        int result{};
+        for (const T &element : v)
+        {
+            result = result * 10 + value_of(element);
+        }
+        return result;
+    }
+
+    template <typename T>
+    constexpr bool
+    test_push_and_pop()
+    {
+        cesa::vector<T, 8> v;
+        v.push_back(T(1));
+        v.emplace_back(2);
+        T three(3);
+        v.push_back(three);
+        v.pop_back();
+        return v.size() == 2 && sum(v) == 12 && value_of(v.front()) == 1 && value_of(v.back()) == 2;
+    }
+
+    static_assert(test_push_and_pop<int>());
+    static_assert(test_push_and_pop<boxed>());
+
+    template <typename T>
+    constexpr bool
+    test_insert()
+    {
+        cesa::vector<T, 16> v(T(1), T(2), T(3));
+        v.insert(v.begin() + 1, T(4));
+        v.insert(v.begin(), 2, T(5));
+        v.emplace(v.end(), 6);
+        const T values[] = { T(7), T(8) };
+        v.insert(v.begin() + 3, values, values + 2);
+        return sum(v) == 551784236;
+    }
+
+    static_assert(test_insert<int>());
+    static_assert(test_insert<boxed>());
+
+    template <typename T>
+    constexpr bool
+    test_erase()
+    {
+        cesa::vector<T, 16> v(T(1), T(2), T(3), T(4), T(5), T(6), T(7));
+        v.erase(v.begin());
+        v.erase(v.begin() + 1, v.begin() + 3);
+        v.erase_unordered(v.begin());
+        v.erase_if([](const T &element) { return value_of(element) == 6; });
+        return sum(v) == 75 && v.index_of(T(5)) == 1 && !v.contains(T(2));
+    }
+
+    static_assert(test_erase<int>());
+    static_assert(test_erase<boxed>());
+
+    template <typename T>
+    constexpr bool
+    test_copy_and_move()
+    {
+        cesa::vector<T, 8> v(T(1), T(2), T(3));
+        cesa::vector<T, 8> copy(v);
+        cesa::vector<T, 8> moved(std::move(copy));
+        cesa::vector<T, 8> assigned;
+        assigned = moved;
+        cesa::vector<T, 8> other(T(9));
+        other.swap(assigned);
+        return copy.empty() && sum(moved) == 123 && sum(other) == 123 && sum(assigned) == 9 && other == v;
+    }
+
+    static_assert(test_copy_and_move<int>());
+    static_assert(test_copy_and_move<boxed>());
+
+    template <typename T>
+    constexpr bool
+    test_resize_and_assign()
+    {
+        cesa::vector<T, 8> v(cesa::with_size, 3, T(4));
+        v.resize(5, T(2));
+        v.resize(4, T(0));
+        cesa::vector<T, 8> w;
+        w.assign(v.begin() + 1, v.end());
+        return sum(v) == 4442 && sum(w) == 442 && v.count(T(4)) == 3;
+    }
+
+    static_assert(test_resize_and_assign<int>());
+    static_assert(test_resize_and_assign<boxed>());
+
+    /**
+     * The motivating use: a lookup table computed by the compiler and stored in a constexpr object.
+     */
+    constexpr cesa::vector<std::uint32_t, 256>
+    make_crc32_table()
+    {
+        cesa::vector<std::uint32_t, 256> table;
+        for (std::uint32_t i{}; i < 256; ++i)
+        {
+            std::uint32_t crc = i;
+            for (int bit{}; bit < 8; ++bit)
+            {
+                crc = (crc & 1U) != 0 ? 0xEDB88320U ^ (crc >> 1U) : crc >> 1U;
+            }
+            table.push_back(crc);
+        }
+        return table;
+    }
+
+    constexpr cesa::vector<std::uint32_t, 256> crc32_table = make_crc32_table();
+
+    static_assert(crc32_table.size() == 256);
+    static_assert(crc32_table[1] == 0x77073096U);
+    static_assert(crc32_table[255] == 0x2D02EF8DU);
+}
@@ -0,0 +1,241 @@
+/**
+ * flat_map_tests.cpp
+ *
+ * Runtime tests for cesa::flat_map: lookup, insertion, erasure and the bulk insert_sorted merge
+ * against a std::map model, and the state left by throwing keys and values, which must keep the
+ * key and value arrays the same length.
+ */
+
+#include "check.hpp"
+#include "lifetime.hpp"
+
+#include <cesa/flat_map.hpp>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using cesa::test::check;
+
+    template <class Map>
+    bool
+    same(const Map &map, const std::map<int, int> &model)
+    {
+        if (map.size() != model.size() || map.keys().size() != map.values().size())
+        {
+            return false;
+        }
+        std::size_t index{};
+        for (const auto &[key, value] : model)
+        {
+            if (map.key_at(index) != key || map.value_at(index) != value)
+            {
+                return false;
+            }
+            ++index;
+        }
+        return true;
+    }
+
+    void
+    test_against_model()
+    {
+        std::mt19937                 engine(11);
+        cesa::flat_map<int, int, 48> map;
+        std::map<int, int>           model;
+        for (int step{}; step < 5000; ++step)
+        {
+            const int key   = static_cast<int>(engine() % 96);
+            const int value = static_cast<int>(engine() % 1000);
+            switch (engine() % 5)
+            {
+            case 0:
+                if (map.size() < map.max_size())
+                {
+                    check(map.try_emplace(key, value).second == model.try_emplace(key, value).second,
+                          "try_emplace reports new keys");
+                }
+                break;
+            case 1:
+                if (map.size() < map.max_size())
+                {
+                    map.insert_or_assign(key, value);
+                    model.insert_or_assign(key, value);
+                }
+                break;
+            case 2:
+                check(map.erase(key) == model.erase(key), "erase by key");
+                break;
+            case 3:
+                if (map.size() < map.max_size())
+                {
+                    map[key] += value;
+                    model[key] += value;
+                }
+                break;
+            default:
+            {
+                std::vector<std::pair<int, int> > pairs(engine() % 6);
+                std::generate(pairs.begin(), pairs.end(), [&] {
+                    return std::pair(static_cast<int>(engine() % 96), static_cast<int>(engine() % 9));
+                });
+                std::sort(pairs.begin(), pairs.end(),
+                          [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+                std::map<int, int> merged = model;
+                for (const auto &[k, v] : pairs)
+                {
+                    merged.try_emplace(k, v);
+                }
+                if (merged.size() <= map.max_size())
+                {
+                    map.insert_sorted(pairs.begin(), pairs.end());
+                    model = std::move(merged);
+                }
+                break;
+            }
+            }
+            const int *found = map.find(key);
+            check((found != nullptr) == (model.count(key) == 1) && (found == nullptr || *found == model[key]),
+                  "find");
+            const auto index = found == nullptr ? map.npos : static_cast<std::size_t>(found - map.values().data());
+            check(map.index_of(key) == index, "index_of");
+            if (!same(map, model))
+            {
+                check(false, "contents match std::map");
+                return;
+            }
+        }
+    }
+
+    void
+    test_lookup_errors()
+    {
+        cesa::flat_map<int, int, 2> map;
+        map[1] = 10;
+        map[2] = 20;
+        check(map.at(2) == 20 && map.count(1) == 1 && map.count(3) == 0, "at and count");
+        try
+        {
+            (void)map.at(3);
+            check(false, "at reports a missing key");
+        }
+        catch (const std::out_of_range &)
+        {
+        }
+        try
+        {
+            map[3] = 30;
+            check(false, "operator[] reports a full map");
+        }
+        catch (const std::out_of_range &)
+        {
+        }
+        check(map.size() == 2 && map.keys().size() == map.values().size(), "a failed insertion changes nothing");
+    }
+
+    void
+    test_throwing_elements()
+    {
+        using cesa::test::tracked;
+        {
+            cesa::flat_map<tracked, tracked, 16> map;
+            map.try_emplace(tracked(2), tracked(20));
+            map.try_emplace(tracked(4), tracked(40));
+
+            const tracked key(3);
+            const tracked value(30);
+            for (long budget{}; budget < 2; ++budget)
+            {
+                // The first budget fails the copy of the key, the second that of the value
+                tracked::fail_copies_after(budget);
+                try
+                {
+                    map.try_emplace(key, value);
+                    check(false, "try_emplace reports the failed copy");
+                }
+                catch (const cesa::test::copy_failure &)
+                {
+                }
+                tracked::fail_copies_after(-1);
+                check(map.size() == 2 && map.keys().size() == 2 && map.values().size() == 2,
+                      "a failed try_emplace leaves keys and values in step");
+                check(map.value_at(1).value() == 40, "a failed try_emplace leaves the values in place");
+            }
+
+            const std::vector<std::pair<tracked, tracked> > pairs{ { tracked(1), tracked(10) },
+                                                                   { tracked(3), tracked(30) },
+                                                                   { tracked(5), tracked(50) } };
+            for (long budget{}; budget < 10; ++budget)
+            {
+                tracked::fail_copies_after(budget);
+                try
+                {
+                    map.insert_sorted(pairs.begin(), pairs.end());
+                }
+                catch (const cesa::test::copy_failure &)
+                {
+                }
+                tracked::fail_copies_after(-1);
+                check(map.keys().size() == map.values().size(),
+                      "a failed insert_sorted leaves keys and values in step");
+                check(std::is_sorted(map.keys().begin(), map.keys().end()) &&
+                          std::adjacent_find(map.keys().begin(), map.keys().end()) == map.keys().end(),
+                      "a failed insert_sorted leaves the keys sorted and unique");
+                check(tracked::live() == static_cast<long>(2 * (map.size() + pairs.size()) + 2),
+                      "a failed insert_sorted leaks no elements");
+                map.clear();
+                map.try_emplace(tracked(2), tracked(20));
+                map.try_emplace(tracked(4), tracked(40));
+            }
+        }
+        check(tracked::live() == 0, "flat_map leaks no elements");
+    }
+
+    void
+    test_bool_values()
+    {
+        cesa::flat_map<int, bool, 8> map;
+        map.try_emplace(3, true);
+        map.try_emplace(1);
+        map[5] = true;
+        map.insert_or_assign(1, true);
+        bool *found = map.find(3);
+        check(found != nullptr && *found && map.values().data() + 1 == found, "bool values are stored unpacked");
+        *found = false;
+
+        const std::vector<std::pair<int, bool> > pairs{ { 0, true }, { 4, false }, { 5, false } };
+        map.insert_sorted(pairs.begin(), pairs.end());
+        map.erase(0);
+        const std::vector<bool> expected{ true, false, false, true };
+        check(map.size() == 4 && std::equal(map.values().begin(), map.values().end(), expected.begin()) &&
+                  map.key_at(2) == 4,
+              "insertion and erasure with bool values");
+    }
+
+    constexpr bool
+    test_constexpr_bool_values()
+    {
+        cesa::flat_map<int, bool, 4> map;
+        map[2] = true;
+        map[1] = false;
+        map.erase(1);
+        return map.size() == 1 && map.at(2) && *map.find(2);
+    }
+
+    static_assert(test_constexpr_bool_values());
+}
+
+int
+main()
+{
+    test_against_model();
+    test_lookup_errors();
+    test_throwing_elements();
+    test_bool_values();
+    return cesa::test::exit_code();
+}
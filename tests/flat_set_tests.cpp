@@ -0,0 +1,173 @@
+/**
+ * flat_set_tests.cpp
+ *
+ * Runtime tests for cesa::flat_set: lookup on both search strategies, insertion, erasure and the
+ * bulk insert_sorted merge against a std::set model, and the state left by throwing keys.
+ */
+
+#include "check.hpp"
+#include "lifetime.hpp"
+
+#include <cesa/flat_set.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using cesa::test::check;
+
+    template <class Set, class Model>
+    bool
+    same(const Set &set, const Model &model)
+    {
+        return set.size() == model.size() && std::equal(set.begin(), set.end(), model.begin());
+    }
+
+    /**
+     * Runs on a small arithmetic set, which takes the linear search, and on larger or non-arithmetic
+     * sets, which take the binary search.
+     */
+    template <typename Key, std::size_t capacity, class MakeKey>
+    void
+    test_against_model(MakeKey make_key)
+    {
+        std::mt19937                      engine(7);
+        cesa::flat_set<Key, capacity>     set;
+        std::set<Key>                     model;
+        for (int step{}; step < 5000; ++step)
+        {
+            const Key key = make_key(static_cast<int>(engine() % (capacity * 2)));
+            switch (engine() % 4)
+            {
+            case 0:
+            case 1:
+                if (set.size() < capacity)
+                {
+                    const auto [it, inserted] = set.insert(key);
+                    check(inserted == model.insert(key).second && *it == key, "insert reports new keys");
+                }
+                break;
+            case 2:
+                check(set.erase(key) == model.erase(key), "erase by key");
+                break;
+            default:
+            {
+                std::vector<Key> keys(engine() % 6);
+                std::generate(keys.begin(), keys.end(),
+                              [&] { return make_key(static_cast<int>(engine() % (capacity * 2))); });
+                std::sort(keys.begin(), keys.end());
+                std::set<Key> merged = model;
+                merged.insert(keys.begin(), keys.end());
+                if (merged.size() <= capacity)
+                {
+                    set.insert_sorted(keys.begin(), keys.end());
+                    model = std::move(merged);
+                }
+                break;
+            }
+            }
+            check(set.contains(key) == (model.count(key) == 1), "contains");
+            const auto lower = set.lower_bound(key);
+            check(lower - set.begin() == std::distance(model.begin(), model.lower_bound(key)), "lower_bound");
+            check(set.upper_bound(key) - set.begin() == std::distance(model.begin(), model.upper_bound(key)),
+                  "upper_bound");
+            if (!same(set, model))
+            {
+                check(false, "contents match std::set");
+                return;
+            }
+        }
+    }
+
+    void
+    test_insert_sorted()
+    {
+        cesa::flat_set<int, 16> set;
+        set.insert(5);
+        set.insert(1);
+        const int keys[] = { 0, 1, 1, 3, 5, 9 };
+        set.insert_sorted(std::begin(keys), std::end(keys));
+        check(same(set, std::vector<int>{ 0, 1, 3, 5, 9 }), "insert_sorted skips present and repeated keys");
+
+        std::istringstream stream("2 4 4 10");
+        set.insert_sorted(std::istream_iterator<int>(stream), std::istream_iterator<int>());
+        check(same(set, std::vector<int>{ 0, 1, 2, 3, 4, 5, 9, 10 }), "insert_sorted from a single-pass range");
+
+        check(set.erase(set.find(3)) == set.find(4), "erase returns the following key");
+        try
+        {
+            const std::vector<int> many{ 20, 21, 22, 23, 24, 25, 26, 27, 28, 29 };
+            set.insert_sorted(many.begin(), many.end());
+            check(false, "insert_sorted reports a full set");
+        }
+        catch (const std::out_of_range &)
+        {
+        }
+        check(set.size() == 7, "a failed insert_sorted leaves the set unchanged");
+    }
+
+    void
+    test_throwing_keys()
+    {
+        using cesa::test::tracked;
+        {
+            cesa::flat_set<tracked, 16> set;
+            set.insert(tracked(2));
+            set.insert(tracked(4));
+            const tracked key(3);
+            tracked::fail_copies_after(0);
+            try
+            {
+                set.insert(key);
+                check(false, "insert reports the failed copy");
+            }
+            catch (const cesa::test::copy_failure &)
+            {
+            }
+            tracked::fail_copies_after(-1);
+            check(same(set, std::vector<int>{ 2, 4 }), "a failed insert leaves the set unchanged");
+
+            const std::vector<tracked> keys{ tracked(1), tracked(3), tracked(5) };
+            for (long budget{}; budget < 6; ++budget)
+            {
+                tracked::fail_copies_after(budget);
+                try
+                {
+                    set.insert_sorted(keys.begin(), keys.end());
+                }
+                catch (const cesa::test::copy_failure &)
+                {
+                }
+                tracked::fail_copies_after(-1);
+                check(std::is_sorted(set.begin(), set.end()) &&
+                          std::adjacent_find(set.begin(), set.end()) == set.end(),
+                      "a failed insert_sorted leaves the keys sorted and unique");
+                check(tracked::live() == static_cast<long>(set.size() + keys.size() + 1),
+                      "a failed insert_sorted leaks no keys");
+                set.clear();
+                set.insert(tracked(2));
+                set.insert(tracked(4));
+            }
+        }
+        check(tracked::live() == 0, "flat_set leaks no keys");
+    }
+}
+
+int
+main()
+{
+    test_against_model<int, 32>([](const int i) { return i; });
+    test_against_model<int, 200>([](const int i) { return i; });
+    test_against_model<std::string, 40>([](const int i) { return std::to_string(i); });
+    test_insert_sorted();
+    test_throwing_keys();
+    return cesa::test::exit_code();
+}
@@ -0,0 +1,53 @@
+/**
+ * fuzz_main.cpp
+ *
+ * A stand-in for the libFuzzer driver, so that the fuzzer also builds and runs with compilers
+ * without -fsanitize=fuzzer. Without arguments, it runs a fixed set of pseudo-random inputs; with
+ * arguments, it replays each given file, e.g. a crash reproducer or a corpus entry.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t *data, std::size_t size);
+
+int
+main(const int argc, char **argv)
+{
+    if (argc > 1)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::ifstream file(argv[i], std::ios::binary);
+            if (!file)
+            {
+                std::fprintf(stderr, "cannot open %s\n", argv[i]);
+                return 1;
+            }
+            const std::vector<std::uint8_t> data((std::istreambuf_iterator<char>(file)),
+                                                 std::istreambuf_iterator<char>());
+            LLVMFuzzerTestOneInput(data.data(), data.size());
+        }
+        return 0;
+    }
+
+    std::mt19937                            engine(20240229);
+    std::uniform_int_distribution<unsigned> byte(0, 255);
+    std::uniform_int_distribution<unsigned> length(0, 512);
+    std::vector<std::uint8_t>               data;
+    for (int run{}; run < 2000; ++run)
+    {
+        data.resize(length(engine));
+        for (std::uint8_t &value : data)
+        {
+            value = static_cast<std::uint8_t>(byte(engine));
+        }
+        LLVMFuzzerTestOneInput(data.data(), data.size());
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+/**
+ * instrumentation_tests.cpp
+ *
+ * Runtime tests for the CESA_INSTRUMENTATION statistics, which the target enables: the counters
+ * of a vector instantiation after a known sequence of modifications, and the order in which the
+ * registry visits the instantiations.
+ */
+
+#include "check.hpp"
+
+#include <cesa/vector.hpp>
+
+#include <cstddef>
+#include <cstdio>
+#include <stdexcept>
+
+static_assert(CESA_INSTRUMENTATION, "instrumentation_tests must be built with CESA_INSTRUMENTATION=1");
+
+namespace
+{
+    using cesa::test::check;
+
+    const cesa::vector_stats *
+    find_stats(const std::size_t capacity)
+    {
+        const cesa::vector_stats *found = nullptr;
+        cesa::instrumentation_registry::instance().for_each([&](const cesa::vector_stats &stats) {
+            if (stats.capacity() == capacity)
+            {
+                found = &stats;
+            }
+        });
+        return found;
+    }
+
+    void
+    test_counters()
+    {
+        cesa::vector<int, 4> v;
+        v.push_back(1);
+        v.push_back(2);
+        v.push_back(3);
+        v.insert(v.begin(), 0);
+        try
+        {
+            v.push_back(4);
+            check(false, "push_back reports a full vector");
+        }
+        catch (const std::out_of_range &)
+        {
+        }
+        v.erase(v.begin() + 1);
+        v.pop_back();
+
+        const cesa::vector_stats *stats = find_stats(4);
+        check(stats != nullptr, "the first modification registers the statistics");
+        if (stats == nullptr)
+        {
+            return;
+        }
+        check(stats->type_name() == "int", "type_name spells the element type");
+        check(stats->high_water_mark() == 4, "the high-water mark is the largest size reached");
+        check(stats->inserted() == 4, "inserted counts every inserted element");
+        check(stats->erased() == 2, "erased counts every erased element, pop_back included");
+        check(stats->shifted() == 5, "shifted counts the elements moved to open and close gaps");
+        check(stats->overflows() == 1, "overflows counts the rejected insertion");
+    }
+
+    void
+    test_registration_order()
+    {
+        cesa::vector<long, 7> first;
+        first.push_back(1);
+        cesa::vector<long, 9> second;
+        second.push_back(2);
+
+        std::size_t capacities[2]{};
+        std::size_t visited{};
+        cesa::instrumentation_registry::instance().for_each([&](const cesa::vector_stats &stats) {
+            if ((stats.capacity() == 7 || stats.capacity() == 9) && visited < 2)
+            {
+                capacities[visited++] = stats.capacity();
+            }
+        });
+        check(visited == 2 && capacities[0] == 9 && capacities[1] == 7,
+              "the registry visits the most recently registered statistics first");
+        cesa::instrumentation_registry::instance().dump(stdout);
+    }
+}
+
+int
+main()
+{
+    test_counters();
+    test_registration_order();
+    return cesa::test::exit_code();
+}
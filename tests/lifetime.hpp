@@ -0,0 +1,194 @@
+#ifndef CESA_TESTS_LIFETIME_HPP
+#define CESA_TESTS_LIFETIME_HPP
+
+/**
+ * lifetime.hpp
+ *
+ * Element types that check their own lifetime, for the runtime tests and the fuzzer.
+ *
+ * Every cesa::test::tracked object carries a state word that is only valid between its
+ * construction and its destruction. Constructing from, assigning from or to, reading or destroying
+ * an object whose state is not valid, e.g. a slot that was never constructed or was already
+ * destroyed, aborts with a message, and the number of live objects is counted so that a test can
+ * check that a container destroyed exactly what it constructed. Copies can be made to throw after a
+ * given number of copies, to test the exception paths.
+ *
+ * tracked is not trivially copyable, so cesa::vector takes its element-wise paths for it.
+ * relocatable_tracked opts in to cesa::is_trivially_relocatable and so takes the memcpy/memmove
+ * paths, which are only correct if they neither construct nor destroy the relocated objects.
+ * copy_only_tracked has no move constructor, so that shifting elements may throw.
+ */
+
+#include <cesa/vector.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace cesa::test
+{
+    /**
+     * Thrown by the copy constructor of a tracked object once the copy budget is used up.
+     */
+    struct copy_failure : std::runtime_error
+    {
+        copy_failure()
+            : std::runtime_error("tracked copy failed")
+        {
+        }
+    };
+
+    template <int tag>
+    class basic_tracked
+    {
+    public:
+        basic_tracked()
+            : basic_tracked(0)
+        {
+        }
+
+        basic_tracked(const int value)
+            : value_(value)
+            , state_(alive)
+        {
+            ++live_;
+        }
+
+        basic_tracked(const basic_tracked &other)
+            : value_(other.checked().value_)
+        {
+            if (copy_budget_ == 0)
+            {
+                throw copy_failure();
+            }
+            if (copy_budget_ > 0)
+            {
+                --copy_budget_;
+            }
+            state_ = alive;
+            ++live_;
+        }
+
+        basic_tracked(basic_tracked &&other) noexcept
+            : value_(other.checked().value_)
+            , state_(alive)
+        {
+            other.value_ = moved_from;
+            ++live_;
+        }
+
+        basic_tracked &
+        operator=(const basic_tracked &other)
+        {
+            checked().value_ = other.checked().value_;
+            return *this;
+        }
+
+        basic_tracked &
+        operator=(basic_tracked &&other) noexcept
+        {
+            checked().value_ = other.checked().value_;
+            other.value_     = moved_from;
+            return *this;
+        }
+
+        ~basic_tracked()
+        {
+            checked().state_ = dead;
+            --live_;
+        }
+
+        [[nodiscard]] int
+        value() const
+        {
+            return checked().value_;
+        }
+
+        friend bool
+        operator==(const basic_tracked &lhs, const basic_tracked &rhs)
+        {
+            return lhs.value() == rhs.value();
+        }
+
+        friend bool
+        operator<(const basic_tracked &lhs, const basic_tracked &rhs)
+        {
+            return lhs.value() < rhs.value();
+        }
+
+        /**
+         * The number of objects currently alive.
+         */
+        [[nodiscard]] static long
+        live() noexcept
+        {
+            return live_;
+        }
+
+        /**
+         * Makes the copy constructor throw after count more copies. A negative count, the default,
+         * never throws.
+         */
+        static void
+        fail_copies_after(const long count) noexcept
+        {
+            copy_budget_ = count;
+        }
+
+        /**
+         * The value left behind in a moved-from object.
+         */
+        static constexpr int moved_from = -1;
+
+    private:
+        static constexpr std::uint32_t alive = 0xA11CE5ED;
+        static constexpr std::uint32_t dead  = 0xDEADDEAD;
+
+        [[nodiscard]] const basic_tracked &
+        checked() const
+        {
+            if (state_ != alive)
+            {
+                std::fprintf(stderr, "tracked object %p used outside its lifetime\n", static_cast<const void *>(this));
+                std::abort();
+            }
+            return *this;
+        }
+
+        [[nodiscard]] basic_tracked &
+        checked()
+        {
+            (void)static_cast<const basic_tracked &>(*this).checked();
+            return *this;
+        }
+
+        inline static long live_{};
+        inline static long copy_budget_ = -1;
+
+        int           value_;
+        std::uint32_t state_{};
+    };
+
+    using tracked             = basic_tracked<0>;
+    using relocatable_tracked = basic_tracked<1>;
+
+    /**
+     * A tracked object without a move constructor, so that every move is a copy that may throw.
+     */
+    struct copy_only_tracked : basic_tracked<2>
+    {
+        using basic_tracked<2>::basic_tracked;
+
+        copy_only_tracked(const copy_only_tracked &) = default;
+
+        copy_only_tracked &operator=(const copy_only_tracked &) = default;
+    };
+}
+
+template <>
+struct cesa::is_trivially_relocatable<cesa::test::relocatable_tracked> : std::true_type
+{
+};
+
+#endif
@@ -0,0 +1,288 @@
+/**
+ * lifetime_tests.cpp
+ *
+ * Runtime tests: every member of cesa::vector that constructs, destroys or relocates elements is
+ * run on the lifetime-tracking element types from lifetime.hpp, which abort on any use of an
+ * object outside its lifetime, and must then leave exactly size() objects alive. Elements whose
+ * moves throw check that a failed shift leaves no destroyed slots inside the vector.
+ */
+
+#include "check.hpp"
+#include "lifetime.hpp"
+
+#include <cesa/vector.hpp>
+
+#include <algorithm>
+#include <forward_list>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+    using cesa::test::check;
+
+    template <typename T, std::size_t max_elements>
+    bool
+    holds(const cesa::vector<T, max_elements> &v, std::initializer_list<int> values)
+    {
+        return v.size() == values.size() &&
+               std::equal(v.begin(), v.end(), values.begin(),
+                          [](const T &element, const int value) { return element.value() == value; });
+    }
+
+    template <typename T>
+    void
+    test_modifiers()
+    {
+        {
+            cesa::vector<T, 16> v(T(1), T(2), T(3));
+            v.insert(v.begin() + 1, T(4));
+            v.emplace(v.begin(), 5);
+            v.insert(v.begin() + 2, 2, T(6));
+            check(holds(v, { 5, 1, 6, 6, 4, 2, 3 }), "insert and emplace");
+            check(T::live() == 7, "insert and emplace leave size() objects alive");
+
+            v.erase(v.begin() + 1);
+            v.erase(v.begin() + 1, v.begin() + 3);
+            v.erase_unordered(v.begin());
+            check(holds(v, { 3, 4, 2 }), "erase");
+            check(T::live() == 3, "erase destroys the erased objects");
+
+            v.resize(6);
+            v.resize(2);
+            v.resize(4, T(7));
+            check(holds(v, { 3, 4, 7, 7 }), "resize");
+            check(T::live() == 4, "resize constructs and destroys the difference");
+
+            const T values[] = { T(2), T(8), T(9) };
+            v.merge_sorted(std::begin(values), std::end(values));
+            v.insert_sorted(T(8));
+            check(v.unique_sorted() == 2, "unique_sorted erases the duplicates");
+            check(holds(v, { 2, 3, 4, 7, 8, 9 }), "merge_sorted and insert_sorted");
+            check(T::live() == 3 + static_cast<long>(v.size()), "sorted operations leave size() objects alive");
+
+            v.assign(3, T(1));
+            check(holds(v, { 1, 1, 1 }), "assign");
+            v.clear();
+            check(v.empty(), "clear");
+        }
+        check(T::live() == 0, "modifiers leak no objects");
+    }
+
+    template <typename T>
+    void
+    test_copy_move_and_swap()
+    {
+        {
+            cesa::vector<T, 8> v(T(1), T(2), T(3));
+            cesa::vector<T, 8> copy(v);
+            cesa::vector<T, 8> moved(std::move(copy));
+            cesa::vector<T, 8> other(T(4));
+            other.swap(v);
+            check(holds(other, { 1, 2, 3 }) && holds(v, { 4 }), "swap");
+            v = moved;
+            moved = std::move(other);
+            check(holds(v, { 1, 2, 3 }) && holds(moved, { 1, 2, 3 }), "copy and move assignment");
+            check(T::live() == static_cast<long>(v.size() + copy.size() + moved.size() + other.size()),
+                  "copies and moves leave size() objects alive in every vector");
+        }
+        check(T::live() == 0, "copies and moves leak no objects");
+    }
+
+    template <typename T>
+    void
+    test_failed_copies()
+    {
+        {
+            cesa::vector<T, 16> v(T(1), T(2), T(3));
+            const T             values[] = { T(4), T(5), T(6) };
+            for (long budget{}; budget < 3; ++budget)
+            {
+                T::fail_copies_after(budget);
+                try
+                {
+                    v.insert(v.begin() + 1, values, values + 3);
+                    check(false, "insert(pos, first, last) reports the failed copy");
+                }
+                catch (const cesa::test::copy_failure &)
+                {
+                }
+                T::fail_copies_after(budget + 1);
+                try
+                {
+                    v.insert(v.begin() + 1, 3, values[0]);
+                    check(false, "insert(pos, count, value) reports the failed copy");
+                }
+                catch (const cesa::test::copy_failure &)
+                {
+                }
+                T::fail_copies_after(-1);
+                check(holds(v, { 1, 2, 3 }), "a failed insertion leaves the elements in place");
+            }
+
+            T::fail_copies_after(1);
+            try
+            {
+                const cesa::vector<T, 16> copy(v);
+                check(false, "the copy constructor reports the failed copy");
+            }
+            catch (const cesa::test::copy_failure &)
+            {
+            }
+            T::fail_copies_after(-1);
+            check(T::live() == 6, "failed copies leave no partial copies alive");
+        }
+        check(T::live() == 0, "failed copies leak no objects");
+    }
+
+    template <typename T>
+    void
+    test_failed_merges()
+    {
+        {
+            const std::forward_list<T> list{ T(2), T(4), T(6) };
+            cesa::vector<T, 16>        v(T(1), T(4), T(5));
+            v.merge_sorted(list.begin(), list.end());
+            check(holds(v, { 1, 2, 4, 4, 5, 6 }), "merge_sorted from a forward range");
+
+            // The merge compares three times filling the slots past the old size, then assigns
+            long       budget = 0;
+            const auto comp   = [&](const T &lhs, const T &rhs)
+            {
+                if (budget-- == 0)
+                {
+                    throw std::runtime_error("comparison failed");
+                }
+                return lhs < rhs;
+            };
+            const T values[] = { T(0), T(3), T(7) };
+            for (long limit{ 1 }; limit < 8; ++limit)
+            {
+                v      = cesa::vector<T, 16>(T(1), T(2), T(4), T(4), T(5), T(6));
+                budget = limit;
+                try
+                {
+                    v.merge_sorted(std::begin(values), std::end(values), comp);
+                    check(false, "merge_sorted reports the failed comparison");
+                }
+                catch (const std::runtime_error &)
+                {
+                }
+                check(v.size() == 6, "a failed merge keeps the old elements");
+                check(T::live() == 12, "a failed backward merge destroys the merged tail");
+            }
+            v = cesa::vector<T, 16>(T(1), T(3), T(5));
+
+            T::fail_copies_after(1);
+            try
+            {
+                v.merge_sorted(list.begin(), list.end());
+                check(false, "merge_sorted reports the failed copy");
+            }
+            catch (const cesa::test::copy_failure &)
+            {
+            }
+            T::fail_copies_after(-1);
+            check(holds(v, { 1, 2, 3, 5 }), "a failed forward merge keeps a sorted prefix and the unmerged elements");
+            check(T::live() == 10, "a failed forward merge leaks no objects");
+        }
+        check(T::live() == 0, "failed merges leak no objects");
+    }
+
+    /**
+     * Checks that every element of v is alive and that no other objects are, apart from extra.
+     */
+    template <std::size_t max_elements>
+    bool
+    consistent(const cesa::vector<cesa::test::copy_only_tracked, max_elements> &v, const long extra)
+    {
+        return std::all_of(v.begin(), v.end(), [](const auto &element) { return element.value() > 0; }) &&
+               cesa::test::copy_only_tracked::live() == static_cast<long>(v.size()) + extra;
+    }
+
+    void
+    test_throwing_shifts()
+    {
+        using T = cesa::test::copy_only_tracked;
+        {
+            const T values[] = { T(7), T(8) };
+            for (long budget{}; budget < 8; ++budget)
+            {
+                cesa::vector<T, 16> v(T(1), T(2), T(3), T(4), T(5));
+                T::fail_copies_after(budget);
+                try
+                {
+                    v.emplace(v.begin() + 1, 9);
+                    check(holds(v, { 1, 9, 2, 3, 4, 5 }), "emplace shifts by copying");
+                }
+                catch (const cesa::test::copy_failure &)
+                {
+                    check(budget > 0 || holds(v, { 1, 2, 3, 4, 5 }), "a failed shift keeps the elements in place");
+                }
+                T::fail_copies_after(-1);
+                check(consistent(v, 2), "a failed emplace leaves only live elements");
+
+                v = cesa::vector<T, 16>(T(1), T(2), T(3), T(4), T(5));
+                T::fail_copies_after(budget);
+                try
+                {
+                    v.insert(v.begin() + 2, 3, values[0]);
+                    check(holds(v, { 1, 2, 7, 7, 7, 3, 4, 5 }), "insert(pos, count, value) shifts by copying");
+                }
+                catch (const cesa::test::copy_failure &)
+                {
+                }
+                T::fail_copies_after(-1);
+                check(consistent(v, 2), "a failed insert(pos, count, value) leaves only live elements");
+
+                v = cesa::vector<T, 16>(T(1), T(2), T(3), T(4), T(5));
+                T::fail_copies_after(budget);
+                try
+                {
+                    v.insert(v.begin(), std::begin(values), std::end(values));
+                    check(holds(v, { 7, 8, 1, 2, 3, 4, 5 }), "insert(pos, first, last) shifts by copying");
+                }
+                catch (const cesa::test::copy_failure &)
+                {
+                }
+                T::fail_copies_after(-1);
+                check(consistent(v, 2), "a failed insert(pos, first, last) leaves only live elements");
+
+                v = cesa::vector<T, 16>(T(1), T(2), T(3), T(4), T(5));
+                T::fail_copies_after(budget);
+                try
+                {
+                    v.insert_sorted(T(3));
+                    check(holds(v, { 1, 2, 3, 3, 4, 5 }), "insert_sorted shifts by copying");
+                }
+                catch (const cesa::test::copy_failure &)
+                {
+                }
+                T::fail_copies_after(-1);
+                check(consistent(v, 2), "a failed insert_sorted leaves only live elements");
+            }
+        }
+        check(T::live() == 0, "failed shifts leak no objects");
+    }
+
+    template <typename T>
+    void
+    test_all()
+    {
+        test_modifiers<T>();
+        test_copy_move_and_swap<T>();
+        test_failed_copies<T>();
+        test_failed_merges<T>();
+    }
+}
+
+int
+main()
+{
+    test_all<cesa::test::tracked>();
+    test_all<cesa::test::relocatable_tracked>();
+    test_throwing_shifts();
+    return cesa::test::exit_code();
+}
@@ -0,0 +1,192 @@
+/**
+ * serialization_tests.cpp
+ *
+ * Runtime tests for serialize(), deserialize() and cesa::vector_view: a round trip through the
+ * header and payload buffers, a misaligned buffer, which deserialize() must read element by
+ * element and vector_view must reject, and damaged headers and payloads, which must be rejected
+ * without touching the destination vector.
+ */
+
+#include "check.hpp"
+
+#include <cesa/serialization.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+
+namespace
+{
+    using cesa::test::check;
+
+    struct sample
+    {
+        std::uint64_t id;
+        double        weight;
+
+        bool operator==(const sample &) const = default;
+    };
+
+    using samples = cesa::vector<sample, 32>;
+
+    /**
+     * A 16-byte aligned buffer holding a serialized vector at a chosen offset, so that the elements
+     * can be placed at a misaligned address.
+     */
+    struct image
+    {
+        alignas(16) std::array<std::byte, 1024> storage{};
+        std::size_t offset{};
+        std::size_t length{};
+
+        image(const cesa::serialized &bytes, const std::size_t at)
+            : offset(at)
+        {
+            for (const auto buffer : bytes.buffers())
+            {
+                std::memcpy(storage.data() + offset + length, buffer.data(), buffer.size());
+                length += buffer.size();
+            }
+        }
+
+        [[nodiscard]] std::span<const std::byte>
+        bytes() const noexcept
+        {
+            return std::span<const std::byte>(storage.data() + offset, length);
+        }
+
+        template <typename Field>
+        void
+        patch(const std::size_t field_offset, const Field value) noexcept
+        {
+            std::memcpy(storage.data() + offset + field_offset, &value, sizeof(value));
+        }
+    };
+
+    samples
+    make_samples(const std::size_t count)
+    {
+        samples v;
+        for (std::size_t i{}; i < count; ++i)
+        {
+            v.push_back(sample{ 1000 + i, 0.5 * static_cast<double>(i) });
+        }
+        return v;
+    }
+
+    void
+    test_round_trip()
+    {
+        const samples          v     = make_samples(20);
+        const cesa::serialized bytes = cesa::serialize(v);
+        check(bytes.size_bytes() == cesa::serialized_size(v) && bytes.size_bytes() == 16 + 20 * sizeof(sample),
+              "serialized_size() matches the buffers");
+        check(bytes.payload.data() == static_cast<const void *>(v.data()), "serialize() does not copy the elements");
+
+        const image buffer(bytes, 0);
+        samples     out = make_samples(3);
+        cesa::deserialize(buffer.bytes(), out);
+        check(out == v, "deserialize() restores the elements");
+
+        check(cesa::vector_view<sample>::validate(buffer.bytes()), "validate() accepts an aligned buffer");
+        const cesa::vector_view<sample> view(buffer.bytes());
+        check(view.size() == 20 && view.size_bytes() == buffer.length && view.front() == v.front() &&
+                  view.back() == v.back() && view[7] == v[7],
+              "vector_view overlays the elements");
+        try
+        {
+            (void)view.at(20);
+            check(false, "vector_view::at() reports an index out of range");
+        }
+        catch (const std::out_of_range &)
+        {
+        }
+
+        const image empty(cesa::serialize(samples()), 0);
+        check(cesa::try_deserialize(empty.bytes(), out) && out.empty(), "an empty vector round-trips");
+        check(cesa::vector_view<sample>(empty.bytes()).empty(), "an empty view");
+    }
+
+    void
+    test_misaligned()
+    {
+        const samples v = make_samples(9);
+        const image   buffer(cesa::serialize(v), 4);
+        samples       out;
+        check(cesa::try_deserialize(buffer.bytes(), out) && out == v, "a misaligned buffer is read element by element");
+
+        check(!cesa::vector_view<sample>::validate(buffer.bytes()), "validate() rejects a misaligned buffer");
+        try
+        {
+            const cesa::vector_view<sample> view(buffer.bytes());
+            check(false, "vector_view reports a misaligned buffer");
+        }
+        catch (const std::out_of_range &)
+        {
+        }
+    }
+
+    /**
+     * Checks that bytes is rejected by both try_deserialize() and deserialize(), and that the
+     * destination is left as it was.
+     */
+    template <class Vector>
+    void
+    check_rejected(const std::span<const std::byte> bytes, Vector out, const char *what)
+    {
+        const Vector before   = out;
+        bool         rejected = !cesa::try_deserialize(bytes, out) && out == before;
+        try
+        {
+            cesa::deserialize(bytes, out);
+            rejected = false;
+        }
+        catch (const std::out_of_range &)
+        {
+        }
+        check(rejected && out == before, what);
+    }
+
+    void
+    test_rejection()
+    {
+        const samples v           = make_samples(16);
+        const samples destination = make_samples(2);
+
+        image magic(cesa::serialize(v), 0);
+        magic.patch(0, std::uint32_t{ 0x43535631 });
+        check_rejected(magic.bytes(), destination, "a foreign or byte-swapped magic is rejected");
+        check(!cesa::vector_view<sample>::validate(magic.bytes()), "validate() rejects a bad magic");
+
+        image element_size(cesa::serialize(v), 0);
+        element_size.patch(4, std::uint32_t{ sizeof(sample) / 2 });
+        check_rejected(element_size.bytes(), destination, "a different element_size is rejected");
+
+        const image buffer(cesa::serialize(v), 0);
+        check_rejected(buffer.bytes().first(buffer.length - 1), destination, "a truncated payload is rejected");
+        check_rejected(buffer.bytes().first(15), destination, "a truncated header is rejected");
+        check_rejected(std::span<const std::byte>(), destination, "an empty buffer is rejected");
+        check(!cesa::vector_view<sample>::validate(buffer.bytes().first(buffer.length - 1)),
+              "validate() rejects a truncated payload");
+
+        image huge(cesa::serialize(v), 0);
+        huge.patch(8, std::uint64_t{ 1 } << 61);
+        check_rejected(huge.bytes(), destination, "a size whose payload would overflow is rejected");
+
+        cesa::vector<sample, 8> small{ sample{ 1, 1.0 } };
+        check_rejected(buffer.bytes(), small, "a size above the capacity of the destination is rejected");
+        check(cesa::vector_view<sample>::validate(buffer.bytes()), "a view has no capacity limit");
+    }
+}
+
+int
+main()
+{
+    test_round_trip();
+    test_misaligned();
+    test_rejection();
+    return cesa::test::exit_code();
+}
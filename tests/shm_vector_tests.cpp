@@ -0,0 +1,119 @@
+/**
+ * shm_vector_tests.cpp
+ *
+ * Runtime tests for cesa::shm_vector: the writer members against their error cases, and a writer
+ * thread racing with a reader thread, where every snapshot the reader obtains must be a state the
+ * writer published. The seqlock copies race by design, so this test is not meant for ThreadSanitizer.
+ */
+
+#include "check.hpp"
+
+#include <cesa/shm_vector.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+    using cesa::test::check;
+
+    /**
+     * Element i of a published state is { i, round } for one round shared by all elements.
+     */
+    struct entry
+    {
+        std::uint32_t index;
+        std::uint32_t round;
+    };
+
+    using feed = cesa::shm_vector<entry, 512>;
+
+    void
+    test_writer_errors()
+    {
+        static feed v;
+        try
+        {
+            v.pop_back();
+            check(false, "pop_back reports an empty vector");
+        }
+        catch (const std::out_of_range &)
+        {
+        }
+        check(v.empty() && v.version() == 0, "a failed pop_back changes nothing");
+
+        v.push_back({ 0, 0 });
+        v.pop_back();
+        check(v.empty() && v.version() == 4, "push_back and pop_back each publish one change");
+        try
+        {
+            v.set(0, { 0, 0 });
+            check(false, "set reports an index out of range");
+        }
+        catch (const std::out_of_range &)
+        {
+        }
+    }
+
+    void
+    test_snapshots()
+    {
+        static feed              v;
+        std::atomic<bool>        done{};
+        std::atomic<std::size_t> snapshots{};
+        std::atomic<std::size_t> torn{};
+        std::thread              reader([&] {
+            static cesa::vector<entry, 512> copy;
+            std::uint64_t                   last_version{};
+            while (!done.load(std::memory_order_acquire))
+            {
+                v.read(copy);
+                const std::uint64_t version    = v.version();
+                bool                consistent = version >= last_version;
+                for (std::size_t i{}; i < copy.size(); ++i)
+                {
+                    consistent = consistent && copy[i].index == i && copy[i].round == copy[0].round;
+                }
+                last_version = version;
+                torn.fetch_add(consistent ? 0 : 1, std::memory_order_relaxed);
+                snapshots.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+
+        for (std::uint32_t round{}; round < 20000 || snapshots.load(std::memory_order_relaxed) < 1000; ++round)
+        {
+            v.clear();
+            for (std::uint32_t i{}; i < feed::max_size(); ++i)
+            {
+                v.push_back({ i, round });
+                if (i % 64 == 63)
+                {
+                    v.pop_back();
+                    v.push_back({ i, round });
+                }
+            }
+            // Moving every element to the next round is one change, so no snapshot mixes rounds
+            v.begin_write();
+            for (std::uint32_t i{}; i < feed::max_size(); ++i)
+            {
+                v.set(i, { i, round + 1 });
+            }
+            v.end_write();
+        }
+        done.store(true, std::memory_order_release);
+        reader.join();
+        check(snapshots.load() >= 1000, "the reader obtains snapshots while the writer runs");
+        check(torn.load() == 0, "every snapshot is a consistent prefix of a published state");
+    }
+}
+
+int
+main()
+{
+    test_writer_errors();
+    test_snapshots();
+    return cesa::test::exit_code();
+}
@@ -0,0 +1,231 @@
+/**
+ * small_vector_tests.cpp
+ *
+ * Runtime tests for cesa::small_vector on the lifetime-tracking element types: spilling to the heap,
+ * shrinking back to the inline storage, moves between the inline and heap states, and relocation of
+ * elements whose copies throw, which must leave the elements in place and release the new buffer.
+ * Shifting such elements for an insertion must leave no destroyed slots inside the vector.
+ */
+
+#include "check.hpp"
+#include "lifetime.hpp"
+
+#include <cesa/small_vector.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace
+{
+    using cesa::test::check;
+    using cesa::test::copy_failure;
+    using cesa::test::tracked;
+
+    /**
+     * A std::allocator that counts the live allocations.
+     */
+    template <typename T>
+    struct counting_allocator
+    {
+        using value_type = T;
+
+        inline static long allocations{};
+
+        counting_allocator() = default;
+
+        template <typename U>
+        constexpr counting_allocator(const counting_allocator<U> &) noexcept
+        {
+        }
+
+        T *
+        allocate(const std::size_t count)
+        {
+            ++allocations;
+            return std::allocator<T>().allocate(count);
+        }
+
+        void
+        deallocate(T *pointer, const std::size_t count) noexcept
+        {
+            --allocations;
+            std::allocator<T>().deallocate(pointer, count);
+        }
+
+        friend bool
+        operator==(const counting_allocator &, const counting_allocator &) = default;
+    };
+
+    /**
+     * An element with only a copy constructor, which small_vector must copy when relocating.
+     */
+    struct copy_only
+    {
+        tracked value;
+
+        copy_only(const int i)
+            : value(i)
+        {
+        }
+
+        copy_only(const copy_only &) = default;
+
+        copy_only &operator=(const copy_only &) = default;
+    };
+
+    template <typename T>
+    using small = cesa::small_vector<T, 4, counting_allocator<T> >;
+
+    template <typename T>
+    bool
+    holds(const small<T> &v, std::initializer_list<int> values)
+    {
+        const auto value = [](const T &element) {
+            if constexpr (std::is_same_v<T, copy_only>)
+            {
+                return element.value.value();
+            }
+            else
+            {
+                return element.value();
+            }
+        };
+        return v.size() == values.size() &&
+               std::equal(v.begin(), v.end(), values.begin(),
+                          [&](const T &element, const int i) { return value(element) == i; });
+    }
+
+    void
+    test_spill_and_shrink()
+    {
+        {
+            small<tracked> v{ 1, 2, 3, 4 };
+            check(v.is_inline() && counting_allocator<tracked>::allocations == 0, "four elements fit inline");
+            v.push_back(5);
+            check(!v.is_inline() && v.capacity() >= 5 && counting_allocator<tracked>::allocations == 1,
+                  "the fifth element spills to the heap");
+            check(holds(v, { 1, 2, 3, 4, 5 }) && tracked::live() == 5, "spilling relocates the elements");
+            v.pop_back();
+            v.erase(v.begin());
+            v.shrink_to_fit();
+            check(v.is_inline() && v.capacity() == 4 && counting_allocator<tracked>::allocations == 0,
+                  "shrink_to_fit moves back to the inline storage");
+            check(holds(v, { 2, 3, 4 }) && tracked::live() == 3, "shrinking relocates the elements");
+        }
+        check(tracked::live() == 0 && counting_allocator<tracked>::allocations == 0, "spilling leaks nothing");
+    }
+
+    void
+    test_moves()
+    {
+        {
+            small<tracked> inline_source{ 1, 2 };
+            small<tracked> heap_source{ 1, 2, 3, 4, 5, 6 };
+
+            small<tracked> from_inline(std::move(inline_source));
+            check(from_inline.is_inline() && inline_source.empty() && holds(from_inline, { 1, 2 }),
+                  "moving an inline vector relocates its elements");
+            small<tracked> from_heap(std::move(heap_source));
+            check(!from_heap.is_inline() && heap_source.is_inline() && heap_source.empty() &&
+                      counting_allocator<tracked>::allocations == 1,
+                  "moving a heap vector steals the allocation");
+
+            from_heap = std::move(from_inline);
+            check(from_heap.is_inline() && holds(from_heap, { 1, 2 }) && counting_allocator<tracked>::allocations == 0,
+                  "moving an inline vector into a heap vector releases the allocation");
+            small<tracked> big{ 7, 8, 9, 10, 11 };
+            from_heap = std::move(big);
+            check(!from_heap.is_inline() && holds(from_heap, { 7, 8, 9, 10, 11 }) && big.empty(),
+                  "moving a heap vector into an inline vector");
+            check(tracked::live() == 5, "moves leave size() objects alive");
+        }
+        check(tracked::live() == 0 && counting_allocator<tracked>::allocations == 0, "moves leak nothing");
+        static_assert(std::is_nothrow_move_constructible_v<small<tracked> >);
+        static_assert(!std::is_nothrow_move_constructible_v<small<copy_only> >);
+    }
+
+    void
+    test_copy_only_relocation()
+    {
+        using allocator = counting_allocator<copy_only>;
+        {
+            small<copy_only> v{ 1, 2, 3, 4 };
+            const copy_only  value(5);
+            for (long budget{}; budget < 4; ++budget)
+            {
+                // One copy for the new element, then one per relocated element
+                tracked::fail_copies_after(budget);
+                try
+                {
+                    v.push_back(value);
+                    check(false, "push_back reports the failed copy");
+                }
+                catch (const copy_failure &)
+                {
+                }
+                tracked::fail_copies_after(-1);
+                check(v.is_inline() && holds(v, { 1, 2, 3, 4 }) && allocator::allocations == 0,
+                      "a failed spill leaves the elements inline and releases the new buffer");
+                check(tracked::live() == 5, "a failed spill destroys the copies it made");
+            }
+            v.push_back(value);
+            v.pop_back();
+            tracked::fail_copies_after(1);
+            try
+            {
+                v.shrink_to_fit();
+                check(false, "shrink_to_fit reports the failed copy");
+            }
+            catch (const copy_failure &)
+            {
+            }
+            tracked::fail_copies_after(-1);
+            check(!v.is_inline() && holds(v, { 1, 2, 3, 4 }) && allocator::allocations == 1,
+                  "a failed shrink_to_fit keeps the allocation");
+            v.shrink_to_fit();
+            small<copy_only> moved(std::move(v));
+            check(holds(moved, { 1, 2, 3, 4 }) && v.empty() && tracked::live() == 5,
+                  "moving copy-only elements copies and destroys them");
+        }
+        check(tracked::live() == 0 && allocator::allocations == 0, "copy-only relocation leaks nothing");
+    }
+
+    void
+    test_copy_only_shifts()
+    {
+        for (long budget{}; budget < 6; ++budget)
+        {
+            small<copy_only> v{ 1, 2, 3 };
+            tracked::fail_copies_after(budget);
+            try
+            {
+                v.emplace(v.begin() + 1, 9);
+                v.insert(v.begin(), copy_only(8));
+                check(holds(v, { 8, 1, 9, 2, 3 }), "emplace and insert shift copy-only elements");
+            }
+            catch (const copy_failure &)
+            {
+                check(budget > 0 || holds(v, { 1, 2, 3 }), "a failed shift keeps the elements in place");
+            }
+            tracked::fail_copies_after(-1);
+            check(std::all_of(v.begin(), v.end(), [](const copy_only &element) { return element.value.value() > 0; }) &&
+                      tracked::live() == static_cast<long>(v.size()),
+                  "a failed shift leaves only live elements");
+        }
+        check(tracked::live() == 0 && counting_allocator<copy_only>::allocations == 0, "failed shifts leak nothing");
+    }
+}
+
+int
+main()
+{
+    test_spill_and_shrink();
+    test_moves();
+    test_copy_only_relocation();
+    test_copy_only_shifts();
+    return cesa::test::exit_code();
+}
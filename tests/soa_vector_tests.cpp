@@ -0,0 +1,223 @@
+/**
+ * soa_vector_tests.cpp
+ *
+ * Runtime tests for cesa::soa_vector: insertion and erasure against a std::vector model, the
+ * relocating move and erase paths for a trivially relocatable field, and the state left by fields
+ * whose copies throw, which must destroy every field constructed so far and keep the columns the
+ * same length. A constant-evaluated round trip checks that the container works in constexpr code.
+ */
+
+#include "check.hpp"
+#include "lifetime.hpp"
+
+#include <cesa/soa_vector.hpp>
+
+#include <cstddef>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    using cesa::test::check;
+    using cesa::test::copy_failure;
+    using cesa::test::relocatable_tracked;
+    using cesa::test::tracked;
+
+    using records = cesa::soa_vector<16, relocatable_tracked, tracked, int>;
+
+    bool
+    same(const records &soa, const std::vector<int> &model)
+    {
+        if (soa.size() != model.size())
+        {
+            return false;
+        }
+        for (std::size_t i{}; i < model.size(); ++i)
+        {
+            const auto [first, second, third] = soa[i];
+            if (first.value() != model[i] || second.value() != -model[i] || third != 2 * model[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool
+    balanced(const long relocatable, const long other)
+    {
+        return relocatable_tracked::live() == relocatable && tracked::live() == other;
+    }
+
+    void
+    test_model()
+    {
+        std::mt19937     engine(7);
+        records          soa;
+        std::vector<int> model;
+        for (int step{}; step < 5000; ++step)
+        {
+            const int         value = static_cast<int>(engine() % 1000);
+            const std::size_t pos   = engine() % (model.size() + 1);
+            switch (engine() % 4)
+            {
+            case 0:
+                if (model.size() < soa.max_size())
+                {
+                    soa.emplace_back(value, -value, 2 * value);
+                    model.push_back(value);
+                }
+                break;
+            case 1:
+                if (model.size() < soa.max_size())
+                {
+                    soa.insert(soa.begin() + static_cast<std::ptrdiff_t>(pos),
+                               std::make_tuple(relocatable_tracked(value), tracked(-value), 2 * value));
+                    model.insert(model.begin() + static_cast<std::ptrdiff_t>(pos), value);
+                }
+                break;
+            case 2:
+                if (pos < model.size())
+                {
+                    const std::size_t last = pos + engine() % (model.size() - pos + 1);
+                    soa.erase(soa.begin() + static_cast<std::ptrdiff_t>(pos),
+                              soa.begin() + static_cast<std::ptrdiff_t>(last));
+                    model.erase(model.begin() + static_cast<std::ptrdiff_t>(pos),
+                                model.begin() + static_cast<std::ptrdiff_t>(last));
+                }
+                break;
+            default:
+                if (!model.empty())
+                {
+                    soa.pop_back();
+                    model.pop_back();
+                }
+                break;
+            }
+            if (!same(soa, model) || !balanced(static_cast<long>(model.size()), static_cast<long>(model.size())))
+            {
+                check(false, "insert and erase match std::vector");
+                return;
+            }
+        }
+    }
+
+    void
+    test_copy_and_move()
+    {
+        {
+            records soa;
+            for (int i{}; i < 5; ++i)
+            {
+                soa.emplace_back(i, -i, 2 * i);
+            }
+            records copy(soa);
+            check(same(copy, { 0, 1, 2, 3, 4 }) && balanced(10, 10), "copy construction");
+
+            records moved(std::move(copy));
+            check(same(moved, { 0, 1, 2, 3, 4 }) && copy.empty() && balanced(10, 10),
+                  "move construction relocates one column and moves the others");
+
+            copy = moved;
+            moved.pop_back();
+            moved = std::move(copy);
+            check(same(moved, { 0, 1, 2, 3, 4 }) && copy.empty() && balanced(10, 10), "copy and move assignment");
+        }
+        check(balanced(0, 0), "destruction destroys every field");
+        static_assert(std::is_nothrow_move_constructible_v<records>);
+    }
+
+    void
+    test_throwing_fields()
+    {
+        {
+            records soa;
+            for (int i{}; i < 4; ++i)
+            {
+                soa.emplace_back(i, -i, 2 * i);
+            }
+            const auto value = std::make_tuple(relocatable_tracked(9), tracked(-9), 18);
+
+            tracked::fail_copies_after(0);
+            try
+            {
+                soa.push_back(value);
+                check(false, "push_back rethrows a failed field copy");
+            }
+            catch (const copy_failure &)
+            {
+            }
+            check(same(soa, { 0, 1, 2, 3 }) && balanced(5, 5),
+                  "a failed push_back destroys the fields it constructed");
+
+            try
+            {
+                soa.insert(soa.begin() + 1, value);
+                check(false, "insert rethrows a failed field copy");
+            }
+            catch (const copy_failure &)
+            {
+            }
+            check(same(soa, { 0, 1, 2, 3 }) && balanced(5, 5), "a failed insert closes the gap it opened");
+
+            tracked::fail_copies_after(2);
+            try
+            {
+                records copy(soa);
+                check(false, "copy construction rethrows a failed field copy");
+            }
+            catch (const copy_failure &)
+            {
+            }
+            check(balanced(5, 5), "a failed copy construction destroys the columns it copied");
+
+            records target;
+            target.emplace_back(5, -5, 10);
+            try
+            {
+                target = soa;
+                check(false, "copy assignment rethrows a failed field copy");
+            }
+            catch (const copy_failure &)
+            {
+            }
+            tracked::fail_copies_after(-1);
+            check(target.empty() && balanced(5, 5), "a failed copy assignment leaves the target empty");
+        }
+        check(balanced(0, 0), "no fields leak after failed insertions");
+    }
+
+    constexpr bool
+    test_constexpr()
+    {
+        cesa::soa_vector<8, int, double> soa;
+        soa.emplace_back(1, 1.5);
+        soa.push_back(std::make_tuple(3, 3.5));
+        soa.insert(soa.begin() + 1, std::make_tuple(2, 2.5));
+        cesa::soa_vector<8, int, double> copy(soa);
+        copy.erase(copy.begin());
+        cesa::soa_vector<8, int, double> moved(std::move(copy));
+
+        int    ints{};
+        double doubles{};
+        for (const auto [i, d] : moved)
+        {
+            ints += i;
+            doubles += d;
+        }
+        return soa.size() == 3 && moved.size() == 2 && ints == 5 && doubles == 6.0 && moved.column<0>()[0] == 2;
+    }
+
+    static_assert(test_constexpr());
+}
+
+int
+main()
+{
+    test_model();
+    test_copy_and_move();
+    test_throwing_fields();
+    return cesa::test::exit_code();
+}
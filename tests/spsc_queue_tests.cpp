@@ -0,0 +1,186 @@
+/**
+ * spsc_queue_tests.cpp
+ *
+ * Runtime tests for cesa::spsc_queue with a non-trivial, counted element type: the full and empty
+ * edges and wrap-around on one thread, a producer and a consumer thread mixing the single and bulk
+ * operations, which must deliver every element exactly once and in order, and destruction of a
+ * queue that still holds elements.
+ */
+
+#include "check.hpp"
+
+#include <cesa/spsc_queue.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <thread>
+
+namespace
+{
+    using cesa::test::check;
+
+    /**
+     * A message whose payload is derived from its sequence number, so that a torn or stale
+     * element is detected, and whose live instances are counted.
+     */
+    struct message
+    {
+        inline static std::atomic<long> live{};
+
+        long        sequence;
+        std::string payload;
+
+        message(const long s = -1)
+            : sequence(s)
+            , payload(s < 0 ? std::string() : std::string(static_cast<std::size_t>(20 + s % 7), 'a' + s % 26))
+        {
+            live.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        message(const message &other)
+            : sequence(other.sequence)
+            , payload(other.payload)
+        {
+            live.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        message(message &&other) noexcept
+            : sequence(other.sequence)
+            , payload(std::move(other.payload))
+        {
+            live.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        message &operator=(const message &other) = default;
+
+        message &operator=(message &&other) noexcept = default;
+
+        ~message()
+        {
+            live.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] bool
+        intact() const
+        {
+            return payload == message(sequence).payload;
+        }
+    };
+
+    using queue = cesa::spsc_queue<message, 64>;
+
+    void
+    test_edges()
+    {
+        {
+            queue   q;
+            message out;
+            check(!q.try_pop(out) && q.empty_approx(), "popping an empty queue fails");
+            for (long round{}; round < 3; ++round)
+            {
+                long pushed{};
+                while (q.try_emplace(round * 100 + pushed))
+                {
+                    ++pushed;
+                }
+                check(pushed == static_cast<long>(queue::capacity()) && q.size_approx() == queue::capacity(),
+                      "a queue accepts exactly capacity() elements");
+                check(!q.try_push(message(0)), "pushing to a full queue fails");
+
+                // Pop part of the queue, so that the next round wraps around the end of the ring
+                bool in_order = true;
+                for (long i{}; i < 40; ++i)
+                {
+                    in_order = in_order && q.try_pop(out) && out.sequence == round * 100 + i && out.intact();
+                }
+                message rest[queue::capacity()];
+                in_order =
+                    in_order && q.pop_n(rest, queue::capacity()) == 24 && rest[23].sequence == round * 100 + 63;
+                check(in_order && q.empty_approx() && !q.try_pop(out), "popping drains the queue in order");
+            }
+            check(message::live.load() == 1, "popped elements are destroyed");
+
+            cesa::vector<message, 8> batch{ message(1), message(2), message(3) };
+            check(q.try_push_batch(batch) && q.push_n(batch.begin(), 2) == 2, "the bulk pushes");
+        }
+        check(message::live.load() == 0, "destroying a non-empty queue destroys its elements");
+    }
+
+    void
+    test_threads()
+    {
+        constexpr long    count = 20000;
+        static queue      q;
+        std::atomic<long> errors{};
+        std::thread       producer([&] {
+            long next{};
+            while (next < count)
+            {
+                if (next % 3 == 0)
+                {
+                    cesa::vector<message, 8> batch;
+                    for (long i = next; i < next + 8 && i < count; ++i)
+                    {
+                        batch.emplace_back(i);
+                    }
+                    if (q.try_push_batch(batch))
+                    {
+                        next += static_cast<long>(batch.size());
+                    }
+                }
+                else if (q.try_emplace(next))
+                {
+                    ++next;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        long expected{};
+        while (expected < count)
+        {
+            const auto accept = [&](const message &m) {
+                errors.fetch_add(m.sequence == expected && m.intact() ? 0 : 1, std::memory_order_relaxed);
+                ++expected;
+            };
+            std::size_t popped{};
+            if (expected % 2 == 0)
+            {
+                cesa::vector<message, 16> sink;
+                popped = q.pop_batch(sink);
+                for (const message &m : sink)
+                {
+                    accept(m);
+                }
+            }
+            else
+            {
+                message out;
+                if (q.try_pop(out))
+                {
+                    popped = 1;
+                    accept(out);
+                }
+            }
+            if (popped == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+        check(errors.load() == 0, "the consumer receives every element once and in order");
+        check(q.empty_approx() && message::live.load() == 0, "every transferred element is destroyed");
+    }
+}
+
+int
+main()
+{
+    test_edges();
+    test_threads();
+    return cesa::test::exit_code();
+}
@@ -0,0 +1,187 @@
+/**
+ * string_tests.cpp
+ *
+ * Runtime tests for cesa::basic_string: append, insert, erase, search and comparison against a
+ * std::string model, including views into the string itself, and the error cases, which must
+ * leave the string unchanged. A constant-evaluated case checks that the string works in constexpr
+ * code, and static constexpr strings that it can be a constexpr variable.
+ */
+
+#include "check.hpp"
+
+#include <cesa/string.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace
+{
+    using cesa::test::check;
+
+    using text = cesa::string<40>;
+
+    bool
+    same(const text &str, const std::string &model)
+    {
+        return str.view() == model && str.size() == model.size() && str.c_str()[str.size()] == '\0';
+    }
+
+    int
+    sign(const int value)
+    {
+        return (value > 0) - (value < 0);
+    }
+
+    void
+    test_model()
+    {
+        std::mt19937 engine(11);
+        text         str;
+        std::string  model;
+        const auto   random      = [&](const std::size_t bound) { return engine() % (bound + 1); };
+        const auto   random_text = [&](const std::size_t length) {
+            std::string result;
+            for (std::size_t i{}; i < length; ++i)
+            {
+                result.push_back(static_cast<char>('a' + engine() % 3));
+            }
+            return result;
+        };
+        for (int step{}; step < 20000; ++step)
+        {
+            const std::size_t room  = str.max_size() - str.size();
+            const std::size_t index = random(model.size());
+            switch (engine() % 6)
+            {
+            case 0:
+            {
+                const std::string value = random_text(random(std::min<std::size_t>(room, 5)));
+                str.append(value);
+                model.append(value);
+                break;
+            }
+            case 1:
+            {
+                const std::string value = random_text(random(std::min<std::size_t>(room, 5)));
+                str.insert(index, value);
+                model.insert(index, value);
+                break;
+            }
+            case 2:
+            {
+                // A view into the string itself
+                const std::size_t first = random(model.size());
+                const std::size_t count = std::min(random(model.size() - first), room);
+                str.insert(index, str.view().substr(first, count));
+                model.insert(index, model.substr(first, count));
+                break;
+            }
+            case 3:
+            {
+                const std::size_t count = random(std::min<std::size_t>(room, 4));
+                str.insert(index, count, 'z');
+                model.insert(index, count, 'z');
+                break;
+            }
+            default:
+            {
+                const std::size_t count = engine() % 8 == 0 ? text::npos : random(model.size() - index);
+                str.erase(index, count);
+                model.erase(index, count);
+                break;
+            }
+            }
+            const std::string needle = random_text(engine() % 3);
+            const std::size_t pos    = random(model.size() + 1);
+            const char        ch     = static_cast<char>('a' + engine() % 3);
+            if (!same(str, model) || str.find(needle, pos) != model.find(needle, pos) ||
+                str.rfind(needle, pos) != model.rfind(needle, pos) || str.find(ch, pos) != model.find(ch, pos) ||
+                str.rfind(ch, pos) != model.rfind(ch, pos) ||
+                sign(str.compare(needle)) != sign(model.compare(needle)))
+            {
+                check(false, "append, insert, erase, find and compare match std::string");
+                return;
+            }
+        }
+    }
+
+    void
+    test_comparison_and_hash()
+    {
+        const text            a("symbol");
+        const cesa::string<8> b("symbol");
+        const text            c("symbols");
+        check(a == b && a != c && a < c && c > b, "comparison runs on the live prefix");
+        check(a.compare("symbok") > 0 && a.compare("symbol") == 0 && a.compare("t") < 0, "compare");
+        check(std::hash<text>{}(a) == std::hash<std::string_view>{}("symbol"), "hash matches std::string_view");
+        check(a.starts_with("sym") && a.ends_with("bol") && a.contains('y') && !a.contains("x"),
+              "starts_with, ends_with and contains");
+    }
+
+    template <class F>
+    bool
+    reports_error(F &&f)
+    {
+        try
+        {
+            f();
+        }
+        catch (const std::out_of_range &)
+        {
+            return true;
+        }
+        return false;
+    }
+
+    void
+    test_errors()
+    {
+        cesa::string<8> str("12345678");
+        check(reports_error([&] { str.push_back('9'); }), "push_back reports a full string");
+        check(reports_error([&] { str.append("9"); }), "append reports a full string");
+        check(reports_error([&] { str.insert(0, "9"); }), "insert reports a full string");
+        check(reports_error([&] { str.insert(0, 1, '9'); }), "insert(count, ch) reports a full string");
+        check(reports_error([&] { str.resize(9); }), "resize reports a count above the capacity");
+        check(reports_error([&] { cesa::string<8> long_str("123456789"); }), "construction reports a long input");
+        str.erase(4);
+        check(reports_error([&] { str.insert(5, "a"); }), "insert reports an index past the end");
+        check(reports_error([&] { str.erase(5); }), "erase reports an index past the end");
+        check(reports_error([&] { static_cast<void>(str.at(4)); }), "at reports an index past the end");
+        check(str.view() == "1234" && str.c_str()[4] == '\0', "failed operations leave the string unchanged");
+    }
+
+    constexpr bool
+    test_constexpr()
+    {
+        cesa::string<16> str("world");
+        str.insert(0, "hello ");
+        str.append(1, '!');
+        str.erase(5, 1);
+        str.insert(5, str.view().substr(0, 1));
+        return str.view() == "hellohworld!" && str.find("world") == 6 && str.rfind('o') == 7;
+    }
+
+    static_assert(test_constexpr());
+
+    static constexpr cesa::string<8> tag = "abc";
+    static constexpr cesa::string<8> copied_tag(tag);
+    static constexpr cesa::string<4> empty_tag;
+    static constexpr cesa::string<4> filled_tag(3, 'x');
+
+    static_assert(tag.view() == "abc" && tag.size() == 3 && tag.c_str()[3] == '\0' && copied_tag == tag);
+    static_assert(empty_tag.empty() && filled_tag.view() == "xxx");
+}
+
+int
+main()
+{
+    test_model();
+    test_comparison_and_hash();
+    test_errors();
+    return cesa::test::exit_code();
+}
@@ -0,0 +1,482 @@
+/**
+ * vector_fuzzer.cpp
+ *
+ * Differential fuzzer: interprets the input as a sequence of operations, applies each of them to a
+ * cesa::vector and to a std::vector<int> model, and aborts as soon as the two disagree.
+ *
+ * Every sequence runs on int, which takes the memcpy/memmove fast paths, on test::tracked, which
+ * takes the element-wise paths, and on test::relocatable_tracked, which takes the relocation paths
+ * with an element type that detects every use outside its lifetime. It also runs on int with a
+ * capacity of 8, whose tiny storage takes the whole-storage copies and the unrolled shifts. For the tracked types, the
+ * number of live objects must match the sizes of the vectors after every operation, and copies can
+ * be made to fail to exercise the exception paths.
+ *
+ * Built with -fsanitize=fuzzer as cesa_fuzz (Clang only), or with fuzz_main.cpp as
+ * cesa_fuzz_smoke, which runs a fixed set of pseudo-random inputs or replays given input files.
+ */
+
+#include "lifetime.hpp"
+
+#include <cesa/vector.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    /**
+     * Reads the input one byte at a time, yielding zeros once it is exhausted.
+     */
+    class input
+    {
+    public:
+        input(const std::uint8_t *data, const std::size_t size) noexcept
+            : data_(data)
+            , size_(size)
+        {
+        }
+
+        [[nodiscard]] bool
+        empty() const noexcept
+        {
+            return position_ == size_;
+        }
+
+        [[nodiscard]] std::uint8_t
+        byte() noexcept
+        {
+            return empty() ? 0 : data_[position_++];
+        }
+
+        /**
+         * A value in [0, bound].
+         */
+        [[nodiscard]] std::size_t
+        up_to(const std::size_t bound) noexcept
+        {
+            return byte() % (bound + 1);
+        }
+
+    private:
+        const std::uint8_t *data_;
+        std::size_t         size_;
+        std::size_t         position_{};
+    };
+
+    constexpr int
+    value_of(const int value)
+    {
+        return value;
+    }
+
+    template <int tag>
+    int
+    value_of(const cesa::test::basic_tracked<tag> &value)
+    {
+        return value.value();
+    }
+
+    template <typename T>
+    inline constexpr bool is_tracked_v = !std::is_same_v<T, int>;
+
+    template <typename T, std::size_t capacity>
+    class differential
+    {
+    public:
+        explicit differential(input in) noexcept
+            : in_(in)
+        {
+        }
+
+        void
+        run()
+        {
+            while (!in_.empty())
+            {
+                operation_ = in_.byte();
+                step(operation_ % 25);
+                verify();
+            }
+        }
+
+    private:
+        using cesa_vector = cesa::vector<T, capacity>;
+
+        [[noreturn]] void
+        fail(const char *what) const
+        {
+            std::fprintf(stderr, "vector_fuzzer: %s after operation %u on %s\n", what, operation_,
+                         std::is_same_v<T, int> ? "int" : "a tracked type");
+            std::abort();
+        }
+
+        void
+        require(const bool condition, const char *what) const
+        {
+            if (!condition)
+            {
+                fail(what);
+            }
+        }
+
+        static bool
+        same(const cesa_vector &v, const std::vector<int> &model)
+        {
+            return v.size() == model.size() &&
+                   std::equal(v.begin(), v.end(), model.begin(),
+                              [](const T &element, const int value) { return value_of(element) == value; });
+        }
+
+        void
+        verify() const
+        {
+            require(same(v_, model_), "contents differ from the model");
+            require(same(other_, other_model_), "contents of the second vector differ from the model");
+            if constexpr (is_tracked_v<T>)
+            {
+                require(T::live() == static_cast<long>(v_.size() + other_.size()), "objects leaked or destroyed twice");
+            }
+        }
+
+        /**
+         * Runs f, which must report an overflow, and checks that it left the vector unchanged.
+         */
+        template <class F>
+        void
+        expect_overflow(F f)
+        {
+            try
+            {
+                f();
+            }
+            catch (const std::out_of_range &)
+            {
+                return;
+            }
+            fail("overflow not reported");
+        }
+
+        int
+        value() noexcept
+        {
+            return in_.byte() % 16;
+        }
+
+        std::size_t
+        position() noexcept
+        {
+            return in_.up_to(v_.size());
+        }
+
+        void
+        sort_both()
+        {
+            std::sort(v_.begin(), v_.end());
+            std::sort(model_.begin(), model_.end());
+        }
+
+        void
+        step(const unsigned operation)
+        {
+            const std::size_t room = capacity - v_.size();
+            switch (operation)
+            {
+            case 0:
+            case 1:
+            {
+                const int x = value();
+                if (room == 0)
+                {
+                    expect_overflow([&] { v_.push_back(T(x)); });
+                }
+                else if (operation == 0)
+                {
+                    v_.push_back(T(x));
+                    model_.push_back(x);
+                }
+                else
+                {
+                    v_.emplace_back(x);
+                    model_.push_back(x);
+                }
+                break;
+            }
+            case 2:
+                if (!v_.empty())
+                {
+                    v_.pop_back();
+                    model_.pop_back();
+                }
+                break;
+            case 3:
+            case 4:
+            {
+                const std::size_t pos = position();
+                const int         x   = value();
+                if (room == 0)
+                {
+                    expect_overflow([&] { v_.emplace(v_.begin() + pos, x); });
+                }
+                else if (operation == 3)
+                {
+                    v_.insert(v_.begin() + pos, T(x));
+                    model_.insert(model_.begin() + pos, x);
+                }
+                else
+                {
+                    v_.emplace(v_.begin() + pos, x);
+                    model_.insert(model_.begin() + pos, x);
+                }
+                break;
+            }
+            case 5:
+            {
+                const std::size_t pos   = position();
+                const std::size_t count = in_.up_to(8);
+                const int         x     = value();
+                if (count > room)
+                {
+                    expect_overflow([&] { v_.insert(v_.begin() + pos, count, T(x)); });
+                }
+                else
+                {
+                    v_.insert(v_.begin() + pos, count, T(x));
+                    model_.insert(model_.begin() + pos, count, x);
+                }
+                break;
+            }
+            case 6:
+            {
+                const std::size_t pos = position();
+                if (other_.size() > room)
+                {
+                    expect_overflow([&] { v_.insert(v_.begin() + pos, other_.begin(), other_.end()); });
+                }
+                else
+                {
+                    v_.insert(v_.begin() + pos, other_.begin(), other_.end());
+                    model_.insert(model_.begin() + pos, other_model_.begin(), other_model_.end());
+                }
+                break;
+            }
+            case 7:
+                if (!v_.empty())
+                {
+                    const std::size_t pos = in_.up_to(v_.size() - 1);
+                    v_.erase(v_.begin() + pos);
+                    model_.erase(model_.begin() + pos);
+                }
+                break;
+            case 8:
+            {
+                const std::size_t first = position();
+                const std::size_t last  = first + in_.up_to(v_.size() - first);
+                v_.erase(v_.begin() + first, v_.begin() + last);
+                model_.erase(model_.begin() + first, model_.begin() + last);
+                break;
+            }
+            case 9:
+                if (!v_.empty())
+                {
+                    const std::size_t pos = in_.up_to(v_.size() - 1);
+                    v_.erase_unordered(v_.begin() + pos);
+                    model_[pos] = model_.back();
+                    model_.pop_back();
+                }
+                break;
+            case 10:
+            {
+                const int  divisor = 2 + in_.byte() % 3;
+                const auto pred    = [divisor](const int x) { return x % divisor == 0; };
+                v_.erase_if([&](const T &element) { return pred(value_of(element)); });
+                std::erase_if(model_, pred);
+                break;
+            }
+            case 11:
+            case 12:
+            {
+                const std::size_t count = in_.up_to(capacity + 2);
+                const int         x     = value();
+                if (count > capacity)
+                {
+                    expect_overflow([&] { v_.resize(count); });
+                }
+                else if (operation == 11)
+                {
+                    v_.resize(count);
+                    model_.resize(count);
+                }
+                else
+                {
+                    v_.resize(count, T(x));
+                    model_.resize(count, x);
+                }
+                break;
+            }
+            case 13:
+            {
+                const std::size_t count = in_.up_to(capacity + 2);
+                const int         x     = value();
+                if (count > capacity)
+                {
+                    expect_overflow([&] { v_.assign(count, T(x)); });
+                }
+                else
+                {
+                    v_.assign(count, T(x));
+                    model_.assign(count, x);
+                }
+                break;
+            }
+            case 14:
+                v_.assign(other_.begin(), other_.end());
+                model_ = other_model_;
+                break;
+            case 15:
+                v_.clear();
+                model_.clear();
+                break;
+            case 16:
+                v_     = other_;
+                model_ = other_model_;
+                break;
+            case 17:
+                other_       = std::move(v_);
+                other_model_ = std::move(model_);
+                model_.clear();
+                break;
+            case 18:
+                v_.swap(other_);
+                model_.swap(other_model_);
+                break;
+            case 19:
+            {
+                const int x = value();
+                sort_both();
+                if (room == 0)
+                {
+                    expect_overflow([&] { v_.insert_sorted(T(x)); });
+                }
+                else
+                {
+                    v_.insert_sorted(T(x));
+                    model_.insert(std::upper_bound(model_.begin(), model_.end(), x), x);
+                }
+                break;
+            }
+            case 20:
+            {
+                sort_both();
+                std::vector<int> values(in_.up_to(8));
+                std::generate(values.begin(), values.end(), [this] { return value(); });
+                std::sort(values.begin(), values.end());
+                std::vector<T> elements(values.begin(), values.end());
+                if (values.size() > room)
+                {
+                    expect_overflow([&] { v_.merge_sorted(elements.begin(), elements.end()); });
+                }
+                else
+                {
+                    v_.merge_sorted(elements.begin(), elements.end());
+                    std::vector<int> merged;
+                    std::merge(model_.begin(), model_.end(), values.begin(), values.end(), std::back_inserter(merged));
+                    model_ = std::move(merged);
+                }
+                break;
+            }
+            case 21:
+                v_.unique_sorted();
+                model_.erase(std::unique(model_.begin(), model_.end()), model_.end());
+                break;
+            case 22:
+            {
+                const int x = value();
+                if (other_.size() < capacity)
+                {
+                    other_.push_back(T(x));
+                    other_model_.push_back(x);
+                }
+                break;
+            }
+            case 23:
+                if constexpr (is_tracked_v<T>)
+                {
+                    // Fail one of the copies made by an insertion, which must leave a vector of
+                    // valid elements behind; the model then follows whatever the vector kept
+                    const std::size_t pos   = position();
+                    const std::size_t count = std::min<std::size_t>(in_.up_to(6), room);
+                    T::fail_copies_after(in_.up_to(count));
+                    try
+                    {
+                        if (in_.byte() % 2 == 0)
+                        {
+                            v_.insert(v_.begin() + pos, count, T(value()));
+                        }
+                        else if (other_.size() <= room)
+                        {
+                            v_.insert(v_.begin() + pos, other_.begin(), other_.end());
+                        }
+                    }
+                    catch (const cesa::test::copy_failure &)
+                    {
+                    }
+                    T::fail_copies_after(-1);
+                    model_.clear();
+                    std::transform(v_.begin(), v_.end(), std::back_inserter(model_),
+                                   [](const T &element) { return value_of(element); });
+                }
+                break;
+            default:
+                if constexpr (std::is_trivial_v<T>)
+                {
+                    const std::size_t count = std::min<std::size_t>(in_.up_to(8), room);
+                    const int         x     = value();
+                    std::fill_n(v_.append_uninitialized(count).data(), count, x);
+                    model_.insert(model_.end(), count, x);
+                }
+                break;
+            }
+        }
+
+        input            in_;
+        unsigned         operation_{};
+        cesa_vector      v_;
+        cesa_vector      other_;
+        std::vector<int> model_;
+        std::vector<int> other_model_;
+    };
+
+    template <typename T, std::size_t capacity = 24>
+    void
+    run(const std::uint8_t *data, const std::size_t size)
+    {
+        {
+            differential<T, capacity>(input(data, size)).run();
+        }
+        if constexpr (is_tracked_v<T>)
+        {
+            if (T::live() != 0)
+            {
+                std::fputs("vector_fuzzer: objects leaked after the vectors were destroyed\n", stderr);
+                std::abort();
+            }
+        }
+    }
+}
+
+extern "C" int
+LLVMFuzzerTestOneInput(const std::uint8_t *data, const std::size_t size)
+{
+    run<int>(data, size);
+    run<int, 8>(data, size);
+    run<cesa::test::tracked>(data, size);
+    run<cesa::test::relocatable_tracked>(data, size);
+    return 0;
+}